@@ -0,0 +1,202 @@
+#include "batterysim.h"
+#include <string.h>
+
+static constexpr uint64_t DAY_MS = 24ULL * 60 * 60 * 1000;
+
+const UsageProfile BATTERY_SIM_PROFILES[] = {
+    {"party", 1, 4UL * 60 * 60 * 1000, 90UL * 1000}, // 4 h, a tap every 90 s
+    {"casual", 3, 10UL * 60 * 1000, 30UL * 1000},    // 3x 10 min, every 30 s
+    {"shelf", 0, 0, 0},                              // never touched
+};
+const size_t BATTERY_SIM_PROFILE_COUNT =
+    sizeof(BATTERY_SIM_PROFILES) / sizeof(BATTERY_SIM_PROFILES[0]);
+
+static BatterySimPlatform platformConfig = {};
+
+// ───────────────── Simulation ─────────────────
+
+enum class SimLed : uint8_t { Off, Green, Yellow };
+
+struct Sim {
+  const BatterySimPlatform *platform;
+  BatterySimResult result;
+  uint64_t now; // virtual ms
+  GovernorState governor;
+  PowerLevel lastLevel;
+};
+
+static uint64_t ledUa(const Sim &sim, SimLed led) {
+  // Same scaling as energySetLed(): per channel, linear in value and
+  // brightness.
+  uint32_t channels = 0;
+  switch (led) {
+  case SimLed::Off:
+    return 0;
+  case SimLed::Green:
+    channels = 255;
+    break;
+  case SimLed::Yellow:
+    channels = 255 + 255;
+    break;
+  }
+  return (static_cast<uint64_t>(sim.platform->energy.ledChannelUa) * channels *
+          sim.platform->ledBrightness) /
+         (255u * 255u);
+}
+
+/**
+ * @brief Advance virtual time by `ms` in one mode, charging it.
+ */
+static void spend(Sim &sim, uint64_t ms, EnergyMode mode, bool highClock,
+                  SimLed led) {
+  const EnergyModel &model = sim.platform->energy;
+  uint64_t ua = model.ledQuiescentUa + ledUa(sim, led);
+  switch (mode) {
+  case EnergyMode::Active:
+    ua += highClock ? model.activeHighUa : model.activeLowUa;
+    break;
+  case EnergyMode::LightSleep:
+    ua += model.lightSleepUa;
+    break;
+  case EnergyMode::DeepSleep:
+    ua += model.deepSleepUa;
+    break;
+  case EnergyMode::Count:
+    break;
+  }
+  sim.result.modeMs[static_cast<size_t>(mode)] += ms;
+  sim.result.chargeUaMs += ms * ua;
+  sim.now += ms;
+}
+
+static void flashWrite(Sim &sim) {
+  sim.result.flashWrites++;
+  sim.result.chargeUaMs += sim.platform->energy.flashWriteUaMs;
+}
+
+/**
+ * @brief A tap in Idle: Updating at full clock, then one panel refresh.
+ */
+static void runOperation(Sim &sim) {
+  sim.result.taps++;
+  spend(sim, sim.platform->workMs, EnergyMode::Active, true, SimLed::Yellow);
+  sim.result.refreshes++;
+  sim.result.chargeUaMs += sim.platform->energy.displayRefreshUaMs;
+  governorNoteActivity(sim.governor, static_cast<uint32_t>(sim.now));
+  sim.lastLevel = PowerLevel::Active;
+}
+
+/**
+ * @brief Sit in Idle until `until`, letting the governor sleep the device.
+ *
+ * @return true if the device is in deep sleep at `until`.
+ */
+static bool idleUntil(Sim &sim, uint64_t until) {
+  while (sim.now < until) {
+    const uint32_t now32 = static_cast<uint32_t>(sim.now);
+    const PowerLevel level =
+        governorStep(sim.platform->governor, sim.governor, now32, false);
+
+    if (level == PowerLevel::DeepSleep) {
+      // enterSleep(): insults state + "slept" flag, then sleep until woken.
+      flashWrite(sim);
+      flashWrite(sim);
+      sim.result.deepSleeps++;
+      spend(sim, until - sim.now, EnergyMode::DeepSleep, false, SimLed::Off);
+      sim.lastLevel = level;
+      return true;
+    }
+
+    if (level == PowerLevel::LightSleep && sim.lastLevel != level) {
+      sim.result.lightSleeps++;
+    }
+    sim.lastLevel = level;
+
+    const uint32_t wait =
+        governorMsUntilNextLevel(sim.platform->governor, sim.governor, now32);
+    const uint64_t left = until - sim.now;
+    const uint64_t span = (wait == UINT32_MAX || wait > left) ? left : wait;
+    if (level == PowerLevel::LightSleep) {
+      spend(sim, span, EnergyMode::LightSleep, false, SimLed::Off);
+    } else {
+      spend(sim, span, EnergyMode::Active, false, SimLed::Green);
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Deliver one tap at `at`: idle up to it, wake if needed, run it.
+ */
+static void tapAt(Sim &sim, uint64_t at) {
+  if (at < sim.now) {
+    at = sim.now; // previous operation still running; tap lands right after
+  }
+  if (idleUntil(sim, at)) {
+    // Wake-by-action: boot + Resumed at full clock, "slept" cleared, then the
+    // pressed button's action.
+    spend(sim, sim.platform->wakeMs, EnergyMode::Active, true, SimLed::Green);
+    flashWrite(sim);
+  }
+  runOperation(sim);
+}
+
+/**
+ * @brief Simulate `days` days of `profile`.
+ */
+BatterySimResult batterySimRun(const BatterySimPlatform &platform,
+                               const UsageProfile &profile, uint32_t days) {
+  Sim sim;
+  memset(&sim, 0, sizeof(sim));
+  sim.platform = &platform;
+  governorInit(sim.governor, 0);
+  sim.lastLevel = PowerLevel::Active;
+
+  const uint64_t end = static_cast<uint64_t>(days) * DAY_MS;
+  for (uint32_t day = 0; day < days; ++day) {
+    for (uint32_t s = 0; s < profile.sessionsPerDay; ++s) {
+      const uint64_t start =
+          day * DAY_MS + (DAY_MS / profile.sessionsPerDay) * s;
+      if (profile.tapEveryMs == 0) {
+        continue;
+      }
+      for (uint64_t t = start; t < start + profile.sessionMs;
+           t += profile.tapEveryMs) {
+        tapAt(sim, t);
+      }
+    }
+  }
+  idleUntil(sim, end);
+
+  sim.result.simulatedMs = sim.now;
+  return sim.result;
+}
+
+/**
+ * @brief Average current over the simulation, in µA.
+ */
+uint32_t batterySimAverageUa(const BatterySimResult &result) {
+  if (result.simulatedMs == 0) {
+    return 0;
+  }
+  return static_cast<uint32_t>(result.chargeUaMs / result.simulatedMs);
+}
+
+/**
+ * @brief Projected battery life in hours at `capacityMah`.
+ */
+uint32_t batterySimLifeHours(const BatterySimResult &result,
+                             uint32_t capacityMah) {
+  const uint32_t avgUa = batterySimAverageUa(result);
+  if (avgUa == 0) {
+    return UINT32_MAX;
+  }
+  return static_cast<uint32_t>((static_cast<uint64_t>(capacityMah) * 1000) /
+                               avgUa);
+}
+
+void batterySimSetPlatform(const BatterySimPlatform &platform) {
+  platformConfig = platform;
+}
+
+const BatterySimPlatform &batterySimPlatform() { return platformConfig; }
@@ -0,0 +1,86 @@
+#ifndef BATTERYSIM_H
+#define BATTERYSIM_H
+
+#include "energy.h"
+#include "governor.h"
+#include <stdint.h>
+
+// ─── Battery-life simulator ─────────────────────────────────────
+//
+// Replays a usage profile against the firmware's power behavior in virtual
+// time: taps run an operation (Updating + panel refresh), the inactivity
+// governor (the same governorStep() as on device) escalates to light and
+// deep sleep, and an action button wakes from deep sleep straight into its
+// action. Every span is charged with the EnergyModel, giving an average
+// current and a projected battery life. Pure computation: runs on device
+// ("bench battery") or on the host.
+//
+// It models what loop() does rather than running loop() itself: the
+// project only builds for the ESP32-S3 (no native PlatformIO env, no host
+// stubs for esp_* or the display), so there is no virtual-time loop() to
+// drive. The governor decisions and energy figures are the firmware's own,
+// but a change to loop()'s control flow has to be mirrored here by hand.
+// The module needs only batterysim.cpp and governor.cpp, so a host or CI
+// build can link it without the Arduino core.
+
+/**
+ * @brief Firmware constants the simulation depends on.
+ */
+struct BatterySimPlatform {
+  GovernorConfig governor;
+  EnergyModel energy;
+  uint8_t ledBrightness;  // LED_BRIGHTNESS
+  uint32_t workMs;        // MOCK_WORK_MS
+  uint32_t wakeMs;        // deep-sleep wake to Idle (ROM + boot + Resumed)
+  uint32_t capacityMah;   // battery
+};
+
+/**
+ * @brief When the device gets used. Sessions are spread evenly over a day.
+ */
+struct UsageProfile {
+  const char *name;
+  uint32_t sessionsPerDay;
+  uint32_t sessionMs;  // length of one session
+  uint32_t tapEveryMs; // tap period within a session (0 = no taps)
+};
+
+struct BatterySimResult {
+  uint64_t simulatedMs;
+  uint64_t chargeUaMs;
+  uint64_t modeMs[static_cast<size_t>(EnergyMode::Count)];
+  uint32_t taps;
+  uint32_t deepSleeps;
+  uint32_t lightSleeps;
+  uint32_t refreshes;
+  uint32_t flashWrites;
+};
+
+/**
+ * @brief Simulate `days` days of `profile`.
+ */
+BatterySimResult batterySimRun(const BatterySimPlatform &platform,
+                               const UsageProfile &profile, uint32_t days);
+
+/**
+ * @brief Average current over the simulation, in µA.
+ */
+uint32_t batterySimAverageUa(const BatterySimResult &result);
+
+/**
+ * @brief Projected battery life in hours at `capacityMah`.
+ */
+uint32_t batterySimLifeHours(const BatterySimResult &result,
+                             uint32_t capacityMah);
+
+/**
+ * @brief Platform used by "bench battery"; set once from setup().
+ */
+void batterySimSetPlatform(const BatterySimPlatform &platform);
+const BatterySimPlatform &batterySimPlatform();
+
+// Built-in profiles for "bench battery".
+extern const UsageProfile BATTERY_SIM_PROFILES[];
+extern const size_t BATTERY_SIM_PROFILE_COUNT;
+
+#endif // BATTERYSIM_H
@@ -0,0 +1,645 @@
+#include "bench.h"
+#include "batterysim.h"
+#include "clock.h"
+#include "content.h"
+#include "corpus.h"
+#include "display.h"
+#include "font.h"
+#include "grammar.h"
+#include "ngram.h"
+#include "recent.h"
+#include "render.h"
+#include "search.h"
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+
+// ───────────────── Font ─────────────────
+
+static constexpr uint32_t FONT_BENCH_GLYPHS = 5000;
+static constexpr uint32_t FONT_BENCH_SCREENS = 20;
+
+/**
+ * @brief Glyph throughput and full-screen text render time.
+ *
+ * - glyphs/s: cycles through every packed glyph at scale 1 across the panel.
+ * - full screen: clear + fill every scale-1 text row edge to edge.
+ */
+static void benchFont() {
+  const uint8_t rowPitch = FONT_HEIGHT + FONT_LINE_GAP;
+
+  displayClear();
+  uint16_t x = 0;
+  uint16_t y = 0;
+  const uint32_t glyphStart = micros();
+  for (uint32_t i = 0; i < FONT_BENCH_GLYPHS; ++i) {
+    const FontGlyph &glyph = fontGlyphs[i % FONT_GLYPH_COUNT];
+    if (glyph.width == 0) {
+      continue;
+    }
+    x += fontDrawGlyph(glyph, x, y, 1);
+    if (x + 8 >= PANEL_WIDTH) {
+      x = 0;
+      y += rowPitch;
+      if (y + FONT_HEIGHT > PANEL_HEIGHT) {
+        y = 0;
+      }
+    }
+  }
+  const uint32_t glyphUs = micros() - glyphStart;
+
+  static const char kFill[] = "The quick brown fox jumps over the lazy dog, "
+                              "then insults its mother.";
+  const uint32_t screenStart = micros();
+  uint32_t glyphsPerScreen = 0;
+  for (uint32_t s = 0; s < FONT_BENCH_SCREENS; ++s) {
+    displayClear();
+    glyphsPerScreen = 0;
+    for (uint16_t row = 0; row + FONT_HEIGHT <= PANEL_HEIGHT; row += rowPitch) {
+      uint16_t cx = 0;
+      size_t i = 0;
+      while (true) {
+        const FontGlyph *glyph =
+            fontGlyphFor(static_cast<uint8_t>(kFill[i % (sizeof(kFill) - 1)]));
+        if (glyph == nullptr ||
+            cx + (glyph->width + FONT_SPACING) > PANEL_WIDTH) {
+          break;
+        }
+        cx += fontDrawGlyph(*glyph, cx, row, 1);
+        glyphsPerScreen++;
+        i++;
+      }
+    }
+  }
+  const uint32_t screenUs = micros() - screenStart;
+
+  Serial.println(F("[Bench] font"));
+  Serial.printf("  glyphs:      %lu in %lu us (%lu glyphs/s)\n",
+                static_cast<unsigned long>(FONT_BENCH_GLYPHS),
+                static_cast<unsigned long>(glyphUs),
+                static_cast<unsigned long>(
+                    glyphUs ? (FONT_BENCH_GLYPHS * 1000000ULL) / glyphUs : 0));
+  Serial.printf("  full screen: %lu glyphs, %lu us/screen (avg of %lu)\n",
+                static_cast<unsigned long>(glyphsPerScreen),
+                static_cast<unsigned long>(screenUs / FONT_BENCH_SCREENS),
+                static_cast<unsigned long>(FONT_BENCH_SCREENS));
+}
+
+// ───────────────── Raster cache ─────────────────
+
+static constexpr uint32_t RASTER_BENCH_REPEATS = 50;
+
+/**
+ * @brief Cached (expand) vs live (layout + glyph blit) body render time.
+ *
+ * Times every insult in the raster cache both ways, plus the live path for
+ * the whole corpus for reference.
+ */
+static void benchRaster() {
+  Serial.println(F("[Bench] raster"));
+  Serial.printf("  cache: %lu bodies, %lu bytes flash\n",
+                static_cast<unsigned long>(RASTER_CACHE_COUNT),
+                static_cast<unsigned long>(RASTER_CACHE_BYTES));
+
+  uint32_t cachedUs = 0;
+  uint32_t liveUs = 0;
+  uint32_t cachedRenders = 0;
+  for (size_t slot = 0; slot < RASTER_CACHE_COUNT; ++slot) {
+    const uint16_t index = rasterCacheIndices[slot];
+
+    uint32_t start = micros();
+    for (uint32_t r = 0; r < RASTER_BENCH_REPEATS; ++r) {
+      displayClear();
+      renderBodyCached(index);
+    }
+    cachedUs += micros() - start;
+
+    start = micros();
+    for (uint32_t r = 0; r < RASTER_BENCH_REPEATS; ++r) {
+      displayClear();
+      renderBodyLive(index);
+    }
+    liveUs += micros() - start;
+    cachedRenders += RASTER_BENCH_REPEATS;
+  }
+
+  uint32_t allLiveUs = 0;
+  for (uint16_t index = 0; index < CORPUS_INSULT_COUNT; ++index) {
+    const uint32_t start = micros();
+    for (uint32_t r = 0; r < RASTER_BENCH_REPEATS; ++r) {
+      displayClear();
+      renderBodyLive(index);
+    }
+    allLiveUs += micros() - start;
+  }
+
+  const uint32_t allRenders = CORPUS_INSULT_COUNT * RASTER_BENCH_REPEATS;
+  if (cachedRenders > 0) {
+    Serial.printf("  cached lines: %lu us/render cached, %lu us/render live\n",
+                  static_cast<unsigned long>(cachedUs / cachedRenders),
+                  static_cast<unsigned long>(liveUs / cachedRenders));
+  }
+  Serial.printf("  all lines:    %lu us/render live (incl. clear)\n",
+                static_cast<unsigned long>(allLiveUs / allRenders));
+}
+
+// ───────────────── CPU clock ─────────────────
+
+static constexpr uint32_t CLOCK_BENCH_MHZ[] = {240, 160, 80};
+static constexpr uint32_t CLOCK_BENCH_REPEATS = 20;
+
+/**
+ * @brief Body render time (live and cached) at each CPU clock.
+ *
+ * Shows what the Idle low clock would cost if rendering weren't boosted.
+ */
+static void benchClock() {
+  Serial.println(F("[Bench] clock"));
+  for (uint32_t mhz : CLOCK_BENCH_MHZ) {
+    if (!clockBenchSetMhz(mhz)) {
+      continue;
+    }
+
+    uint32_t start = micros();
+    uint32_t liveRenders = 0;
+    for (uint32_t r = 0; r < CLOCK_BENCH_REPEATS; ++r) {
+      for (uint16_t index = 0; index < CORPUS_INSULT_COUNT; ++index) {
+        displayClear();
+        renderBodyLive(index);
+        liveRenders++;
+      }
+    }
+    const uint32_t liveUs = micros() - start;
+
+    start = micros();
+    uint32_t cachedRenders = 0;
+    for (uint32_t r = 0; r < CLOCK_BENCH_REPEATS; ++r) {
+      for (size_t slot = 0; slot < RASTER_CACHE_COUNT; ++slot) {
+        displayClear();
+        renderBodyCached(rasterCacheIndices[slot]);
+        cachedRenders++;
+      }
+    }
+    const uint32_t cachedUs = micros() - start;
+
+    Serial.printf("  %3lu MHz: %lu us/render live, %lu us/render cached\n",
+                  static_cast<unsigned long>(mhz),
+                  static_cast<unsigned long>(liveRenders ? liveUs / liveRenders
+                                                         : 0),
+                  static_cast<unsigned long>(
+                      cachedRenders ? cachedUs / cachedRenders : 0));
+  }
+  clockBenchRestore();
+}
+
+// ───────────────── Alias ─────────────────
+
+static constexpr uint32_t ALIAS_BENCH_DRAWS = 200000;
+
+static uint32_t benchRandomState = 0x2545F491;
+
+static uint32_t benchRandom() {
+  uint32_t x = benchRandomState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  benchRandomState = x;
+  return x;
+}
+
+/**
+ * @brief Weighted draws: throughput.
+ *
+ * The fit of the alias table and the per-epoch budgets are checked on the
+ * host (test/test_corpus_alias).
+ */
+static void benchAlias() {
+  Serial.printf("[Bench] alias (%lu insults, %lu draws/epoch)\n",
+                static_cast<unsigned long>(CORPUS_INSULT_COUNT),
+                static_cast<unsigned long>(CORPUS_EPOCH_DRAWS));
+
+  // Throughput: table only (xorshift), then with the hardware RNG.
+  uint32_t sink = 0;
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ALIAS_BENCH_DRAWS; ++i) {
+    sink += corpusAliasDraw(benchRandom());
+  }
+  const uint32_t tableUs = micros() - start;
+  start = micros();
+  for (uint32_t i = 0; i < ALIAS_BENCH_DRAWS; ++i) {
+    sink += corpusAliasDraw(esp_random());
+  }
+  const uint32_t hwUs = micros() - start;
+  CorpusEpoch epoch = CORPUS_EPOCH_INIT;
+  start = micros();
+  for (uint32_t i = 0; i < ALIAS_BENCH_DRAWS; ++i) {
+    sink += corpusEpochDraw(epoch, benchRandom);
+  }
+  const uint32_t epochUs = micros() - start;
+  Serial.printf("  draws/s: %lu alias, %lu alias+esp_random, %lu epoch "
+                "(sink %lu)\n",
+                static_cast<unsigned long>(
+                    tableUs ? ALIAS_BENCH_DRAWS * 1000000ULL / tableUs : 0),
+                static_cast<unsigned long>(
+                    hwUs ? ALIAS_BENCH_DRAWS * 1000000ULL / hwUs : 0),
+                static_cast<unsigned long>(
+                    epochUs ? ALIAS_BENCH_DRAWS * 1000000ULL / epochUs : 0),
+                static_cast<unsigned long>(sink));
+}
+
+// ───────────────── Grammar ─────────────────
+
+static constexpr uint32_t GRAMMAR_BENCH_SENTENCES = 2000;
+
+/**
+ * @brief Cost of a generated insult: draw, decode, runtime wrap, render.
+ */
+static void benchGrammar() {
+  GrammarDeck deck;
+  grammarDeckShuffle(deck, 0xBADC0FFE);
+  static uint32_t indices[GRAMMAR_BENCH_SENTENCES];
+
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < GRAMMAR_BENCH_SENTENCES; ++i) {
+    grammarDeckDraw(deck, indices[i]);
+  }
+  const uint32_t drawUs = micros() - start;
+
+  char text[GRAMMAR_TEXT_CAPACITY];
+  size_t totalLength = 0;
+  start = micros();
+  for (uint32_t i = 0; i < GRAMMAR_BENCH_SENTENCES; ++i) {
+    totalLength += grammarExpand(indices[i], text, sizeof(text));
+  }
+  const uint32_t expandUs = micros() - start;
+
+  CorpusLine lines[CONTENT_MAX_LINES];
+  CorpusTextLayout layout;
+  uint32_t layoutUs = 0;
+  uint32_t renderUs = 0;
+  uint32_t unfit = 0;
+  for (uint32_t i = 0; i < GRAMMAR_BENCH_SENTENCES; ++i) {
+    const size_t length = grammarExpand(indices[i], text, sizeof(text));
+    start = micros();
+    const bool fits =
+        contentLayoutText(text, length, lines, CONTENT_MAX_LINES, layout);
+    layoutUs += micros() - start;
+    if (!fits) {
+      unfit++;
+      continue;
+    }
+    displayClear();
+    start = micros();
+    renderBodyText(text, layout);
+    renderUs += micros() - start;
+  }
+
+  const uint32_t n = GRAMMAR_BENCH_SENTENCES;
+  Serial.printf("[Bench] grammar (%lu sentences, %lu in sample)\n",
+                static_cast<unsigned long>(grammarSentenceCount()),
+                static_cast<unsigned long>(n));
+  Serial.printf("  draw:   %lu ns/id\n",
+                static_cast<unsigned long>((drawUs * 1000ULL) / n));
+  Serial.printf("  expand: %lu ns/sentence (avg %lu chars)\n",
+                static_cast<unsigned long>((expandUs * 1000ULL) / n),
+                static_cast<unsigned long>(totalLength / n));
+  Serial.printf("  wrap:   %lu us/sentence\n",
+                static_cast<unsigned long>(layoutUs / n));
+  Serial.printf("  render: %lu us/body, %lu did not fit\n",
+                static_cast<unsigned long>(
+                    n > unfit ? renderUs / (n - unfit) : 0),
+                static_cast<unsigned long>(unfit));
+}
+
+// ───────────────── N-gram ─────────────────
+
+static constexpr uint32_t NGRAM_BENCH_SEEDS = 1000;
+
+/**
+ * @brief Per-insult generation latency (average and worst), rejections.
+ */
+static void benchNgram() {
+  char text[NGRAM_TEXT_CAPACITY];
+  uint32_t totalUs = 0;
+  uint32_t worstUs = 0;
+  uint32_t walks = 0;
+  uint32_t failed = 0;
+  size_t totalLength = 0;
+
+  for (uint32_t seed = 0; seed < NGRAM_BENCH_SEEDS; ++seed) {
+    uint8_t attempts = 0;
+    const uint32_t start = micros();
+    const size_t length = ngramGenerate(seed, text, sizeof(text), &attempts);
+    const uint32_t us = micros() - start;
+    totalUs += us;
+    worstUs = us > worstUs ? us : worstUs;
+    walks += attempts;
+    totalLength += length;
+    if (length == 0) {
+      failed++;
+    }
+  }
+
+  const uint32_t n = NGRAM_BENCH_SEEDS;
+  Serial.printf("[Bench] ngram (order %u, %lu words, %lu states, %lu bytes)\n",
+                NGRAM_ORDER, static_cast<unsigned long>(NGRAM_WORD_COUNT),
+                static_cast<unsigned long>(NGRAM_STATE_COUNT),
+                static_cast<unsigned long>(NGRAM_TABLE_BYTES));
+  Serial.printf("  generate: %lu us avg, %lu us worst (bound: %u walks x %u "
+                "words)\n",
+                static_cast<unsigned long>(totalUs / n),
+                static_cast<unsigned long>(worstUs), NGRAM_MAX_ATTEMPTS,
+                NGRAM_MAX_WORDS);
+  Serial.printf("  walks:    %lu.%02lu per seed, %lu/%lu seeds gave no novel "
+                "line\n",
+                static_cast<unsigned long>(walks / n),
+                static_cast<unsigned long>((walks % n) * 100 / n),
+                static_cast<unsigned long>(failed),
+                static_cast<unsigned long>(n));
+  Serial.printf("  length:   %lu chars avg\n",
+                static_cast<unsigned long>(
+                    n > failed ? totalLength / (n - failed) : 0));
+}
+
+// ───────────────── Recent-shows filter ─────────────────
+
+static constexpr uint32_t RECENT_BENCH_OPS = 20000;
+static constexpr uint32_t RECENT_BENCH_DRAWS = 2000;
+
+static RecentFilter recentBenchFilter;
+
+static bool recentBenchAvoid(uint16_t index) {
+  return recentContains(recentBenchFilter, contentCorpusId(index));
+}
+
+/**
+ * @brief Recent-shows filter: memory per K, op latency, false positives.
+ *
+ * - fp: after 3 windows of inserts, the last RECENT_WINDOW ids must all hit
+ *   (no false negatives) and fresh ids should hit about 2^-N of the time.
+ * - draw: weighted corpus draws that pass over recent insults, as
+ *   insults.cpp does; repeats are the draws that had to take one anyway.
+ */
+static void benchRecent() {
+  RecentFilter &filter = recentBenchFilter;
+  Serial.printf("[Bench] recent (K=%lu, fp target 1/%lu, %lu hashes, %lu "
+                "bytes)\n",
+                static_cast<unsigned long>(RECENT_WINDOW),
+                static_cast<unsigned long>(1UL << RECENT_FALSE_POSITIVE_LOG2),
+                static_cast<unsigned long>(RECENT_HASHES),
+                static_cast<unsigned long>(sizeof(RecentFilter)));
+  Serial.print(F("  bytes per K:"));
+  for (uint32_t k = 256; k <= 4096; k *= 2) {
+    Serial.printf(" %lu=%lu", static_cast<unsigned long>(k),
+                  static_cast<unsigned long>(recentFilterBytes(k)));
+  }
+  Serial.println();
+
+  // Op latency.
+  recentClear(filter);
+  uint32_t sink = 0;
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < RECENT_BENCH_OPS; ++i) {
+    recentInsert(filter, benchRandom());
+  }
+  const uint32_t insertUs = micros() - start;
+  start = micros();
+  for (uint32_t i = 0; i < RECENT_BENCH_OPS; ++i) {
+    sink += recentContains(filter, benchRandom()) ? 1 : 0;
+  }
+  const uint32_t containsUs = micros() - start;
+  Serial.printf("  insert:   %lu ns, contains: %lu ns (sink %lu)\n",
+                static_cast<unsigned long>(insertUs * 1000ULL /
+                                           RECENT_BENCH_OPS),
+                static_cast<unsigned long>(containsUs * 1000ULL /
+                                           RECENT_BENCH_OPS),
+                static_cast<unsigned long>(sink));
+
+  // False negatives must be zero; false positives near the target.
+  recentClear(filter);
+  for (uint32_t id = 0; id < 3 * RECENT_WINDOW; ++id) {
+    recentInsert(filter, id);
+  }
+  uint32_t missed = 0;
+  for (uint32_t id = 2 * RECENT_WINDOW; id < 3 * RECENT_WINDOW; ++id) {
+    missed += recentContains(filter, id) ? 0 : 1;
+  }
+  uint32_t falsePositives = 0;
+  for (uint32_t i = 0; i < RECENT_BENCH_OPS; ++i) {
+    falsePositives += recentContains(filter, 0x80000000u | i) ? 1 : 0;
+  }
+  // Both generations are full here, the worst case; allow 3 sigma of noise.
+  const uint32_t expected = RECENT_BENCH_OPS >> RECENT_FALSE_POSITIVE_LOG2;
+  const uint32_t limit =
+      expected + static_cast<uint32_t>(3 * sqrt(static_cast<double>(expected)));
+  Serial.printf("  fp:       %lu/%lu (limit %lu), %lu false negatives %s\n",
+                static_cast<unsigned long>(falsePositives),
+                static_cast<unsigned long>(RECENT_BENCH_OPS),
+                static_cast<unsigned long>(limit),
+                static_cast<unsigned long>(missed),
+                missed == 0 && falsePositives <= limit ? "ok" : "FAIL");
+
+  // Filtered draws.
+  recentClear(filter);
+  CorpusEpoch epoch = CORPUS_EPOCH_INIT;
+  uint32_t totalUs = 0;
+  uint32_t worstUs = 0;
+  uint32_t repeats = 0;
+  for (uint32_t i = 0; i < RECENT_BENCH_DRAWS; ++i) {
+    start = micros();
+    const uint16_t index = corpusEpochDraw(epoch, benchRandom, recentBenchAvoid);
+    repeats += recentBenchAvoid(index) ? 1 : 0;
+    recentInsert(filter, contentCorpusId(index));
+    const uint32_t us = micros() - start;
+    totalUs += us;
+    worstUs = us > worstUs ? us : worstUs;
+  }
+  Serial.printf("  draw:     %lu us avg, %lu us worst, %lu recent repeats in "
+                "%lu corpus draws (%lu insults)\n",
+                static_cast<unsigned long>(totalUs / RECENT_BENCH_DRAWS),
+                static_cast<unsigned long>(worstUs),
+                static_cast<unsigned long>(repeats),
+                static_cast<unsigned long>(RECENT_BENCH_DRAWS),
+                static_cast<unsigned long>(CORPUS_INSULT_COUNT));
+}
+
+// ───────────────── Find ─────────────────
+
+static constexpr uint32_t FIND_BENCH_QUERIES = 200;
+static constexpr size_t FIND_BENCH_MIN_CHARS = 4;
+static constexpr size_t FIND_BENCH_MAX_CHARS = 12;
+
+/**
+ * @brief Build a UTF-8 query from `count` characters of an insult.
+ *
+ * @return false if the window is all punctuation (it matches nothing).
+ */
+static bool findBenchQuery(uint32_t index, size_t count, char *out,
+                           size_t capacity) {
+  const char *text = corpusText(static_cast<uint16_t>(index));
+  const size_t length = strlen(text);
+  count = count < length ? count : length;
+  const size_t first = length > count ? benchRandom() % (length - count) : 0;
+  size_t used = 0;
+  bool searchable = false;
+  char utf8[3];
+  for (size_t i = first; i < first + count; ++i) {
+    searchable |= searchFold[static_cast<uint8_t>(text[i])] != 0;
+    const size_t n = fontCodeToUtf8(static_cast<uint8_t>(text[i]), utf8);
+    if (used + n >= capacity) {
+      break;
+    }
+    memcpy(out + used, utf8, n);
+    used += n;
+  }
+  out[used] = '\0';
+  return searchable;
+}
+
+/**
+ * @brief `find` latency over substrings of random insults, plus the
+ * short-query full scan.
+ */
+static void benchFind() {
+  const size_t indexBytes = sizeof(uint32_t) * (2 * SEARCH_TRIGRAM_COUNT + 1) +
+                            SEARCH_POSTING_BYTES + sizeof(searchFold);
+  Serial.printf("[Bench] find (%lu insults, %lu trigrams, %lu index bytes)\n",
+                static_cast<unsigned long>(CORPUS_INSULT_COUNT),
+                static_cast<unsigned long>(SEARCH_TRIGRAM_COUNT),
+                static_cast<unsigned long>(indexBytes));
+  if (CORPUS_INSULT_COUNT == 0) {
+    return;
+  }
+
+  char query[3 * FIND_BENCH_MAX_CHARS + 1];
+  uint32_t results[SEARCH_RESULTS_MAX];
+  SearchStats stats;
+  uint32_t totalUs = 0;
+  uint32_t worstUs = 0;
+  uint32_t verified = 0;
+  uint32_t missed = 0;
+  uint32_t queries = 0;
+  for (uint32_t q = 0; q < FIND_BENCH_QUERIES; ++q) {
+    const size_t chars =
+        FIND_BENCH_MIN_CHARS +
+        benchRandom() % (FIND_BENCH_MAX_CHARS - FIND_BENCH_MIN_CHARS + 1);
+    if (!findBenchQuery(benchRandom() % CORPUS_INSULT_COUNT, chars, query,
+                        sizeof(query))) {
+      continue;
+    }
+    queries++;
+    const uint32_t start = micros();
+    const size_t found = searchFind(query, results, SEARCH_RESULTS_MAX, stats);
+    const uint32_t us = micros() - start;
+    totalUs += us;
+    worstUs = us > worstUs ? us : worstUs;
+    verified += stats.candidates;
+    // The line the query was cut from always matches.
+    missed += found == 0 ? 1 : 0;
+  }
+  queries = queries ? queries : 1;
+  Serial.printf("  indexed:  %lu us avg, %lu us worst, %lu verified per "
+                "query, %lu missed %s\n",
+                static_cast<unsigned long>(totalUs / queries),
+                static_cast<unsigned long>(worstUs),
+                static_cast<unsigned long>(verified / queries),
+                static_cast<unsigned long>(missed), missed == 0 ? "ok" : "FAIL");
+
+  // A letter pair no insult contains: the scan reads the whole corpus.
+  const uint32_t start = micros();
+  searchFind("qz", results, SEARCH_RESULTS_MAX, stats);
+  Serial.printf("  scan:     %lu us for a 2-character query (%lu lines)\n",
+                static_cast<unsigned long>(micros() - start),
+                static_cast<unsigned long>(stats.candidates));
+}
+
+// ───────────────── Battery ─────────────────
+
+static constexpr uint32_t BATTERY_BENCH_DAYS = 7;
+
+/**
+ * @brief Simulated average current and battery life per usage profile.
+ *
+ * Uses the platform constants main.cpp hands to batterySimSetPlatform(), so
+ * changing a governor timeout or the energy model shows up here directly.
+ */
+static void benchBattery() {
+  const BatterySimPlatform &platform = batterySimPlatform();
+  Serial.printf("[Bench] battery (%lu days, %lu mAh)\n",
+                static_cast<unsigned long>(BATTERY_BENCH_DAYS),
+                static_cast<unsigned long>(platform.capacityMah));
+
+  for (size_t i = 0; i < BATTERY_SIM_PROFILE_COUNT; ++i) {
+    const UsageProfile &profile = BATTERY_SIM_PROFILES[i];
+    const uint32_t start = micros();
+    const BatterySimResult result =
+        batterySimRun(platform, profile, BATTERY_BENCH_DAYS);
+    const uint32_t simUs = micros() - start;
+
+    const uint64_t total = result.simulatedMs ? result.simulatedMs : 1;
+    Serial.printf("  %-7s avg %lu uA, life: %lu h\n", profile.name,
+                  static_cast<unsigned long>(batterySimAverageUa(result)),
+                  static_cast<unsigned long>(
+                      batterySimLifeHours(result, platform.capacityMah)));
+    Serial.printf("          active %lu%%, light %lu%%, deep %lu%%\n",
+                  static_cast<unsigned long>(
+                      result.modeMs[static_cast<size_t>(EnergyMode::Active)] *
+                      100 / total),
+                  static_cast<unsigned long>(
+                      result.modeMs[static_cast<size_t>(
+                          EnergyMode::LightSleep)] *
+                      100 / total),
+                  static_cast<unsigned long>(
+                      result.modeMs[static_cast<size_t>(
+                          EnergyMode::DeepSleep)] *
+                      100 / total));
+    Serial.printf("          %lu taps, %lu light / %lu deep sleeps, "
+                  "%lu refreshes, %lu flash writes (%lu us)\n",
+                  static_cast<unsigned long>(result.taps),
+                  static_cast<unsigned long>(result.lightSleeps),
+                  static_cast<unsigned long>(result.deepSleeps),
+                  static_cast<unsigned long>(result.refreshes),
+                  static_cast<unsigned long>(result.flashWrites),
+                  static_cast<unsigned long>(simUs));
+  }
+}
+
+// ───────────────── Dispatch ─────────────────
+
+struct BenchEntry {
+  const char *name;
+  void (*run)();
+};
+
+static const BenchEntry benches[] = {
+    {"font", benchFont},
+    {"raster", benchRaster},
+    {"clock", benchClock},
+    {"alias", benchAlias},
+    {"grammar", benchGrammar},
+    {"ngram", benchNgram},
+    {"recent", benchRecent},
+    {"find", benchFind},
+    {"battery", benchBattery},
+};
+
+/**
+ * @brief Console handler for "bench <name>".
+ */
+void benchCommand(const char *args) {
+  for (const BenchEntry &bench : benches) {
+    if (strcmp(args, bench.name) == 0) {
+      bench.run();
+      return;
+    }
+  }
+
+  Serial.print(F("Usage: bench <"));
+  for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); ++i) {
+    if (i > 0) {
+      Serial.print(F("|"));
+    }
+    Serial.print(benches[i].name);
+  }
+  Serial.println(F(">"));
+}
@@ -0,0 +1,21 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// ─── On-device benchmarks ───────────────────────────────────────
+//
+// Run from the serial console: "bench <name>", e.g. "bench font".
+// Benchmarks draw into the framebuffer but never flush it, so they don't
+// touch the panel; the next render repaints everything.
+//
+// They only run on the device: the project has no host build, and timings
+// are taken with the device's own clock and flash. Figures are printed to
+// the console and are not checked automatically.
+
+/**
+ * @brief Console handler for "bench <name>".
+ *
+ * @param args Benchmark name; empty lists the available benchmarks.
+ */
+void benchCommand(const char *args);
+
+#endif // BENCH_H
@@ -0,0 +1,142 @@
+#include "boot.h"
+#include <Arduino.h>
+#include <esp_private/esp_clk.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+
+// ───────────────── Timeline storage ─────────────────
+
+static constexpr size_t PHASE_COUNT = static_cast<size_t>(BootPhase::Count);
+static constexpr uint32_t UNKNOWN_US = UINT32_MAX;
+
+struct BootTimeline {
+  uint32_t count;      // timelines of this kind recorded since power-on
+  uint32_t beforeAppUs; // ROM + bootloader (+ asleep on wake), or UNKNOWN_US
+  uint32_t setupAtUs;  // esp_timer time at setup() entry
+  uint32_t phaseEndUs[PHASE_COUNT]; // esp_timer time; 0 = not reached
+  uint8_t resetReason; // esp_reset_reason_t
+};
+
+static RTC_DATA_ATTR BootTimeline lastCold;
+static RTC_DATA_ATTR BootTimeline lastWake;
+static RTC_DATA_ATTR uint64_t sleepStartedRtcUs = 0;
+
+static BootTimeline current = {};
+static uint64_t setupRtcUs = 0;
+static bool finished = false;
+
+static const char *const phaseNames[PHASE_COUNT] = {
+    "serial", "nvs read", "seed",    "led",
+    "display", "buttons", "insults", "to idle"};
+
+// ───────────────── API ─────────────────
+
+/**
+ * @brief Start the timeline. Call first thing in setup().
+ */
+void bootProfileStart() {
+  current = BootTimeline{};
+  current.setupAtUs = static_cast<uint32_t>(esp_timer_get_time());
+  current.resetReason = static_cast<uint8_t>(esp_reset_reason());
+  setupRtcUs = esp_clk_rtc_time();
+  finished = false;
+}
+
+/**
+ * @brief Mark the end of a phase.
+ */
+void bootProfileMark(BootPhase phase) {
+  const size_t i = static_cast<size_t>(phase);
+  if (finished || i >= PHASE_COUNT) {
+    return;
+  }
+  current.phaseEndUs[i] = static_cast<uint32_t>(esp_timer_get_time());
+}
+
+/**
+ * @brief Mark Interactive and store the timeline as cold or wake.
+ *
+ * beforeAppUs:
+ * - cold power-on: the RTC counter starts at the reset, so RTC time minus the
+ *   app's own uptime is ROM + bootloader;
+ * - wake: RTC time since bootProfileNoteSleep() minus app uptime is time
+ *   asleep + ROM + bootloader (the wake instant itself isn't recorded);
+ * - other resets: the RTC counter didn't restart, so unknown.
+ */
+void bootProfileFinish(bool wokeFromSleep) {
+  if (finished) {
+    return;
+  }
+  bootProfileMark(BootPhase::Interactive);
+  finished = true;
+
+  const uint64_t appUs = current.setupAtUs;
+  if (wokeFromSleep && sleepStartedRtcUs != 0 &&
+      setupRtcUs > sleepStartedRtcUs + appUs) {
+    current.beforeAppUs =
+        static_cast<uint32_t>(setupRtcUs - sleepStartedRtcUs - appUs);
+  } else if (!wokeFromSleep && current.resetReason == ESP_RST_POWERON &&
+             setupRtcUs > appUs) {
+    current.beforeAppUs = static_cast<uint32_t>(setupRtcUs - appUs);
+  } else {
+    current.beforeAppUs = UNKNOWN_US;
+  }
+
+  BootTimeline &slot = wokeFromSleep ? lastWake : lastCold;
+  const uint32_t count = slot.count + 1;
+  slot = current;
+  slot.count = count;
+  sleepStartedRtcUs = 0;
+
+  Serial.printf("[Boot] %s: interactive %lu ms after app start\n",
+                wokeFromSleep ? "wake" : "cold",
+                static_cast<unsigned long>(
+                    current.phaseEndUs[PHASE_COUNT - 1] / 1000));
+}
+
+/**
+ * @brief Capture the RTC time right before deep sleep.
+ */
+void bootProfileNoteSleep() { sleepStartedRtcUs = esp_clk_rtc_time(); }
+
+static void printTimeline(const char *label, const BootTimeline &t,
+                          bool wake) {
+  if (t.count == 0) {
+    Serial.printf("[Boot] %s: none recorded\n", label);
+    return;
+  }
+
+  Serial.printf("[Boot] %s (#%lu, reset reason %u)\n", label,
+                static_cast<unsigned long>(t.count), t.resetReason);
+  if (t.beforeAppUs == UNKNOWN_US) {
+    Serial.println(F("  before app        unknown"));
+  } else {
+    Serial.printf("  %-17s %8lu us\n",
+                  wake ? "asleep+rom+boot" : "rom+bootloader",
+                  static_cast<unsigned long>(t.beforeAppUs));
+  }
+  Serial.printf("  %-17s %8lu us  @%lu\n", "app startup",
+                static_cast<unsigned long>(t.setupAtUs),
+                static_cast<unsigned long>(t.setupAtUs));
+
+  uint32_t prev = t.setupAtUs;
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    if (t.phaseEndUs[i] == 0) {
+      continue;
+    }
+    Serial.printf("  %-17s %8lu us  @%lu\n", phaseNames[i],
+                  static_cast<unsigned long>(t.phaseEndUs[i] - prev),
+                  static_cast<unsigned long>(t.phaseEndUs[i]));
+    prev = t.phaseEndUs[i];
+  }
+}
+
+/**
+ * @brief Console handler for "boot".
+ *
+ * Per phase: duration, then "@" end time since app start (us).
+ */
+void bootProfileCommand(const char *) {
+  printTimeline("cold", lastCold, false);
+  printTimeline("wake", lastWake, true);
+}
@@ -0,0 +1,53 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+// ─── Boot / wake timeline ───────────────────────────────────────
+//
+// setup() marks the end of each phase with esp_timer_get_time(). The time
+// before the app started (ROM + bootloader, plus time asleep on wake) comes
+// from the RTC slow-clock counter, which keeps running through deep sleep.
+// Finished timelines are kept in RTC memory, one for the last cold boot and
+// one for the last wake, and printed by "boot" on the serial console.
+
+enum class BootPhase : uint8_t {
+  Serial = 0,  // Serial.begin + settle delay
+  NvsRead,     // "slept" flag
+  Seed,        // randomSeed(esp_random())
+  Led,         // ledInit
+  Display,     // displayInit
+  Buttons,     // rtc_gpio_deinit + buttonInit x4
+  Insults,     // insultsInit (restore/render)
+  Interactive, // splash (cold) / Resumed (wake) over: enterIdle
+  Count
+};
+
+/**
+ * @brief Start the timeline. Call first thing in setup().
+ */
+void bootProfileStart();
+
+/**
+ * @brief Mark the end of a phase.
+ */
+void bootProfileMark(BootPhase phase);
+
+/**
+ * @brief Mark Interactive and store the timeline as cold or wake.
+ *
+ * Only the first call after bootProfileStart() has an effect.
+ */
+void bootProfileFinish(bool wokeFromSleep);
+
+/**
+ * @brief Capture the RTC time right before deep sleep.
+ */
+void bootProfileNoteSleep();
+
+/**
+ * @brief Console handler for "boot".
+ */
+void bootProfileCommand(const char *args);
+
+#endif // BOOT_H
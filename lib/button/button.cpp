@@ -1,8 +1,22 @@
 #include "button.h"
+#include "trace.h"
 #include <Arduino.h>
 
-#define DEBOUNCE_TIME_MS 30
-#define HOLD_THRESHOLD_MS 800
+static_assert(static_cast<int>(ButtonEvent::Tap) == BUTTON_CORE_TAP &&
+                  static_cast<int>(ButtonEvent::HoldStart) ==
+                      BUTTON_CORE_HOLD_START &&
+                  static_cast<int>(ButtonEvent::HoldEnd) == BUTTON_CORE_HOLD_END,
+              "ButtonEvent must match ButtonCoreEvent");
+
+/**
+ * @brief Read the raw pin level as "pressed".
+ *
+ * Buttons are wired to GND: LOW → circuit closed (button physically
+ * pressed), HIGH → circuit open (button physically released).
+ */
+static bool readPressed(const Button &button) {
+  return digitalRead(button.pin) == LOW;
+}
 
 /**
  * @brief Prepare a Button object for use on the specified Arduino pin.
@@ -20,73 +34,49 @@ void buttonInit(Button &button, uint8_t pin) {
   pinMode(pin, INPUT_PULLUP);
 
   // Establish a known baseline so the first update is predictable.
-  button.lastReading = digitalRead(pin);
-  button.lastDebounceTime = millis();
+  buttonCoreInit(&button.core, readPressed(button), millis());
 
-  // Choose a consistent boot behavior:
-  // start "released" semantically, then let updateButton observe presses
-  // normally.
-  button.state = ButtonState::Idle;
+  button.edgeAtUs = 0;
+  button.eventAtUs = 0;
+}
 
-  button.pressedAt = 0;
-  button.holdFired = false;
+/**
+ * @brief Suppress events from the press currently in progress, if any.
+ *
+ * Used after a button press woke the device and its action has already been
+ * taken: without this, releasing the button would produce a second Tap (or a
+ * HoldStart/HoldEnd if held long). Has no effect if the pin reads released.
+ *
+ * @param button Button initialized with buttonInit().
+ */
+void buttonIgnoreUntilRelease(Button &button) {
+  buttonCoreIgnoreUntilRelease(&button.core, readPressed(button));
 }
 
 /**
  * @brief Advance the button state machine by reading the pin, applying debounce, and detecting taps and holds.
  *
- * Updates the provided Button instance (debounce timer, state, pressedAt, and holdFired) based on the current pin level
- * and the supplied timestamp, and produces a single ButtonEvent when a meaningful transition occurs.
+ * The rules live in buttonCoreUpdate() (button_core.c); this adds the pin read
+ * and the microsecond timestamps used for input-to-render latency.
  *
  * @param button Reference to the Button object to update; its fields will be mutated to reflect the new state.
  * @param now Current time in milliseconds (e.g., from millis()) used for debounce and hold timing.
  * @return ButtonEvent One of ButtonEvent::None, ::Tap, ::HoldStart, or ::HoldEnd describing the observed event.
  */
 ButtonEvent updateButton(Button &button, uint32_t now) {
-  ButtonEvent event = ButtonEvent::None;
+  TRACE_SCOPE(TraceId::UpdateButton);
 
-  // “Raw reading changed → reset debounce window”
-  int raw = digitalRead(
-      button
-          .pin); // returns HIGH or LOW. LOW → circuit closed (button physically
-                 // pressed) HIGH → circuit open (button physically released)
+  const bool edgeWasPending = button.core.edgePending;
+  const ButtonCoreEvent event =
+      buttonCoreUpdate(&button.core, readPressed(button), now);
 
-  if (raw != button.lastReading) {
-    // Reset the debounce timer if the state is unstable
-    button.lastDebounceTime = now;
-    button.lastReading = raw;
-    return ButtonEvent::None;
+  // Remember the first physical edge of a transition (bounces after it don't
+  // move it).
+  if (button.core.edgePending && !edgeWasPending) {
+    button.edgeAtUs = micros();
   }
-
-  if ((now - button.lastDebounceTime) < DEBOUNCE_TIME_MS) {
-    return ButtonEvent::None;
-  }
-
-  // From here on, raw is "trusted" (stable).
-  const bool pressedNow = (raw == LOW);
-
-  // Handle debounced transitions FIRST.
-
-  // Idle -> Pressed
-  if (pressedNow && button.state == ButtonState::Idle) {
-    button.state = ButtonState::Pressed;
-    button.pressedAt = now;
-    button.holdFired = false;
-    return ButtonEvent::None; // Tap vs Hold is decided later on release
+  if (event != BUTTON_CORE_NONE) {
+    button.eventAtUs = micros();
   }
-
-  // Pressed -> Idle (release)
-  if (!pressedNow && button.state == ButtonState::Pressed) {
-    button.state = ButtonState::Idle;
-    return button.holdFired ? ButtonEvent::HoldEnd : ButtonEvent::Tap;
-  }
-
-  // No transition happened this call. If still pressed, check hold threshold.
-  if (button.state == ButtonState::Pressed && !button.holdFired) {
-    if ((now - button.pressedAt) >= HOLD_THRESHOLD_MS) {
-      button.holdFired = true;
-      return ButtonEvent::HoldStart;
-    }
-  }
-  return event;
-}
\ No newline at end of file
+  return static_cast<ButtonEvent>(event);
+}
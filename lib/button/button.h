@@ -1,10 +1,13 @@
 #ifndef BUTTON_H
 #define BUTTON_H
 
+#include "button_core.h"
+#include <stddef.h>
 #include <stdint.h>
 
-// ─── Physical / Debounced States ────────────────────────────────
-enum class ButtonState { Idle, Pressed };
+// ─── Physical Buttons ───────────────────────────────────────────
+enum class ButtonId { Sleep, Random, Next, Prev };
+static constexpr size_t BUTTON_ID_COUNT = 4;
 
 // ─── Button Events (Intent) ─────────────────────────────────────
 enum class ButtonEvent { None = 0, Tap, HoldStart, HoldEnd };
@@ -13,22 +16,19 @@ enum class ButtonEvent { None = 0, Tap, HoldStart, HoldEnd };
 struct Button {
   uint8_t pin;
 
-  // raw input
-  int lastReading; // Raw pin comparison
+  // Debounce + tap/hold state machine (shared with the ULP, see
+  // button_core.h).
+  ButtonCore core;
 
-  // Debounce
-  ButtonState state;         // Stable debounced state
-  uint32_t lastDebounceTime; // Debounce window
-
-  // Timing
-  uint32_t pressedAt; // Measure press duration
-
-  // Intent
-  bool holdFired; // Prevent tap + hold
+  // Latency (micros): first raw edge of the transition that produced the
+  // last event, and when the debounce logic decided on that event.
+  uint32_t edgeAtUs;
+  uint32_t eventAtUs;
 };
 
 // ─── API ────────────────────────────────────────────────────────
 void buttonInit(Button &button, uint8_t pin);
 ButtonEvent updateButton(Button &button, uint32_t now);
+void buttonIgnoreUntilRelease(Button &button);
 
 #endif // BUTTON_H
@@ -0,0 +1,91 @@
+#include "button_core.h"
+
+/**
+ * @brief Reset to released, with `rawPressed` as the baseline reading.
+ *
+ * Starts "released" semantically even if the button is held, then lets
+ * updates observe the press normally.
+ */
+void buttonCoreInit(ButtonCore *core, bool rawPressed, uint32_t now) {
+  core->lastRawPressed = rawPressed;
+  core->pressed = 0;
+  core->lastDebounceTime = now;
+  core->pressedAt = 0;
+  core->holdFired = 0;
+  core->edgePending = 0;
+  core->ignoreUntilRelease = 0;
+}
+
+/**
+ * @brief Suppress the events of the press in progress, if `rawPressed`.
+ *
+ * Used when the press already did its job (e.g. it woke the device):
+ * without this, releasing it would produce a Tap (or HoldStart/HoldEnd).
+ */
+void buttonCoreIgnoreUntilRelease(ButtonCore *core, bool rawPressed) {
+  core->ignoreUntilRelease = rawPressed;
+}
+
+/**
+ * @brief Advance the state machine with one raw sample.
+ *
+ * - A raw change restarts the debounce window; nothing else happens until the
+ *   level has been stable for BUTTON_DEBOUNCE_TIME_MS.
+ * - Released → pressed: no event yet (tap vs hold is decided later).
+ * - Still pressed after BUTTON_HOLD_THRESHOLD_MS: HoldStart, once.
+ * - Pressed → released: HoldEnd if HoldStart fired, Tap otherwise.
+ */
+ButtonCoreEvent buttonCoreUpdate(ButtonCore *core, bool rawPressed,
+                                 uint32_t now) {
+  // “Raw reading changed → reset debounce window”
+  if (rawPressed != core->lastRawPressed) {
+    core->edgePending = 1;
+
+    // Reset the debounce timer if the state is unstable
+    core->lastDebounceTime = now;
+    core->lastRawPressed = rawPressed;
+    return BUTTON_CORE_NONE;
+  }
+
+  if ((now - core->lastDebounceTime) < BUTTON_DEBOUNCE_TIME_MS) {
+    return BUTTON_CORE_NONE;
+  }
+
+  // From here on, the raw level is "trusted" (stable), and either it is a
+  // transition or a bounce that settled back: no edge is pending any more.
+  core->edgePending = 0;
+
+  // Released before the latched press was ever debounced: nothing to swallow.
+  if (!rawPressed && !core->pressed) {
+    core->ignoreUntilRelease = 0;
+  }
+
+  // Handle debounced transitions FIRST.
+
+  // Idle -> Pressed
+  if (rawPressed && !core->pressed) {
+    core->pressed = 1;
+    core->pressedAt = now;
+    core->holdFired = 0;
+    return BUTTON_CORE_NONE; // Tap vs Hold is decided later on release
+  }
+
+  // Pressed -> Idle (release)
+  if (!rawPressed && core->pressed) {
+    core->pressed = 0;
+    if (core->ignoreUntilRelease) {
+      core->ignoreUntilRelease = 0;
+      return BUTTON_CORE_NONE;
+    }
+    return core->holdFired ? BUTTON_CORE_HOLD_END : BUTTON_CORE_TAP;
+  }
+
+  // No transition happened this call. If still pressed, check hold threshold.
+  if (core->pressed && !core->holdFired && !core->ignoreUntilRelease) {
+    if ((now - core->pressedAt) >= BUTTON_HOLD_THRESHOLD_MS) {
+      core->holdFired = 1;
+      return BUTTON_CORE_HOLD_START;
+    }
+  }
+  return BUTTON_CORE_NONE;
+}
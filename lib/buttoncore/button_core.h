@@ -0,0 +1,74 @@
+#ifndef BUTTON_CORE_H
+#define BUTTON_CORE_H
+
+// ─── Portable button state machine ──────────────────────────────
+//
+// Debounce + tap/hold rules, in plain C so the same source builds for the
+// main cores (button.cpp), the ULP-RISC-V wake program (ulp/) and the host.
+// No pin access and no clock: the caller passes the raw level and the time.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUTTON_DEBOUNCE_TIME_MS 30
+#define BUTTON_HOLD_THRESHOLD_MS 800
+
+// Same values as ButtonEvent in button.h.
+typedef enum {
+  BUTTON_CORE_NONE = 0,
+  BUTTON_CORE_TAP,
+  BUTTON_CORE_HOLD_START,
+  BUTTON_CORE_HOLD_END
+} ButtonCoreEvent;
+
+typedef struct {
+  // raw input
+  uint8_t lastRawPressed; // Raw level seen on the previous update
+
+  // Debounce
+  uint8_t pressed;           // Stable debounced state
+  uint32_t lastDebounceTime; // Debounce window
+
+  // Timing
+  uint32_t pressedAt; // Measure press duration
+
+  // Intent
+  uint8_t holdFired; // Prevent tap + hold
+
+  // Set on the first raw edge away from the debounced state; cleared when
+  // the level settles (either way). Lets callers timestamp the edge.
+  uint8_t edgePending;
+
+  // Swallow the press in progress (see buttonCoreIgnoreUntilRelease).
+  uint8_t ignoreUntilRelease;
+} ButtonCore;
+
+/**
+ * @brief Reset to released, with `rawPressed` as the baseline reading.
+ */
+void buttonCoreInit(ButtonCore *core, bool rawPressed, uint32_t now);
+
+/**
+ * @brief Advance the state machine with one raw sample.
+ *
+ * @param rawPressed Raw level, true = pressed (pin LOW).
+ * @param now Current time in milliseconds.
+ * @return The intent event for this sample, if any.
+ */
+ButtonCoreEvent buttonCoreUpdate(ButtonCore *core, bool rawPressed,
+                                 uint32_t now);
+
+/**
+ * @brief Suppress the events of the press in progress, if `rawPressed`.
+ */
+void buttonCoreIgnoreUntilRelease(ButtonCore *core, bool rawPressed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BUTTON_CORE_H
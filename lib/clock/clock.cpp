@@ -0,0 +1,228 @@
+#include "clock.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <string.h>
+
+#if CONFIG_PM_ENABLE
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+typedef esp_pm_config_t PmConfig;
+#else
+typedef esp_pm_config_esp32s3_t PmConfig;
+#endif
+#endif
+
+// ───────────────── Accounting ─────────────────
+
+// Frequencies we count time at; anything else lands in the last slot.
+static constexpr uint32_t FREQ_SLOTS_MHZ[] = {240, 160, 80, 40};
+static constexpr size_t FREQ_SLOT_COUNT =
+    sizeof(FREQ_SLOTS_MHZ) / sizeof(FREQ_SLOTS_MHZ[0]);
+
+static uint64_t usAt[CLOCK_MAX_STATES][FREQ_SLOT_COUNT];
+static uint64_t lastAccountedUs = 0;
+
+static const char *const *names = nullptr;
+static size_t stateCount = 0;
+static uint8_t currentState = 0;
+
+// ───────────────── Clock state ─────────────────
+
+static bool initialized = false;
+static ClockDemand stateDemand = ClockDemand::High;
+static uint32_t boostDepth = 0;
+static uint32_t benchMhz = 0; // 0 = no benchmark override
+static uint32_t appliedMhz = CLOCK_HIGH_MHZ;
+
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t maxFreqLock = nullptr;
+static bool maxFreqLockHeld = false;
+#endif
+
+#if CONFIG_PM_ENABLE
+/**
+ * @brief Let esp_pm scale between `minMhz` and `maxMhz`, no auto light sleep.
+ */
+static bool configurePm(uint32_t minMhz, uint32_t maxMhz) {
+  PmConfig config = {};
+  config.max_freq_mhz = static_cast<int>(maxMhz);
+  config.min_freq_mhz = static_cast<int>(minMhz);
+  config.light_sleep_enable = false;
+  return esp_pm_configure(&config) == ESP_OK;
+}
+#endif
+
+static size_t freqSlot(uint32_t mhz) {
+  for (size_t i = 0; i < FREQ_SLOT_COUNT; ++i) {
+    if (FREQ_SLOTS_MHZ[i] == mhz) {
+      return i;
+    }
+  }
+  return FREQ_SLOT_COUNT - 1;
+}
+
+/**
+ * @brief Charge the time since the last change to the current state/clock.
+ */
+static void account() {
+  const uint64_t now = static_cast<uint64_t>(esp_timer_get_time());
+  if (currentState < CLOCK_MAX_STATES) {
+    usAt[currentState][freqSlot(appliedMhz)] += now - lastAccountedUs;
+  }
+  lastAccountedUs = now;
+}
+
+/**
+ * @brief Apply the clock that the state, boosts and bench override ask for.
+ */
+static void apply() {
+  if (!initialized) {
+    return;
+  }
+  uint32_t target = (stateDemand == ClockDemand::High || boostDepth > 0)
+                        ? CLOCK_HIGH_MHZ
+                        : CLOCK_LOW_MHZ;
+  if (benchMhz != 0) {
+    target = benchMhz;
+  }
+  if (target == appliedMhz) {
+    return;
+  }
+
+  account();
+#if CONFIG_PM_ENABLE
+  // esp_pm only scales between its min and max: a bench override pins both.
+  if (benchMhz != 0) {
+    configurePm(target, target);
+  } else {
+    configurePm(CLOCK_LOW_MHZ, CLOCK_HIGH_MHZ);
+  }
+  const bool wantLock = (target == CLOCK_HIGH_MHZ);
+  if (wantLock != maxFreqLockHeld) {
+    if (wantLock) {
+      esp_pm_lock_acquire(maxFreqLock);
+    } else {
+      esp_pm_lock_release(maxFreqLock);
+    }
+    maxFreqLockHeld = wantLock;
+  }
+#else
+  setCpuFrequencyMhz(target);
+#endif
+  appliedMhz = target;
+}
+
+// ───────────────── API ─────────────────
+
+/**
+ * @brief Set up power management and start counting in state 0.
+ *
+ * Light sleep stays off here; the inactivity governor decides when to sleep.
+ */
+void clockInit(const char *const *stateNames, size_t count) {
+  names = stateNames;
+  stateCount = count < CLOCK_MAX_STATES ? count : CLOCK_MAX_STATES;
+  memset(usAt, 0, sizeof(usAt));
+  lastAccountedUs = static_cast<uint64_t>(esp_timer_get_time());
+
+#if CONFIG_PM_ENABLE
+  if (configurePm(CLOCK_LOW_MHZ, CLOCK_HIGH_MHZ) &&
+      esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "bard", &maxFreqLock) ==
+          ESP_OK) {
+    esp_pm_lock_acquire(maxFreqLock);
+    maxFreqLockHeld = true;
+  }
+#endif
+
+  appliedMhz = getCpuFrequencyMhz();
+  initialized = true;
+  apply();
+}
+
+/**
+ * @brief Switch to application state `state` and its clock demand.
+ */
+void clockSetState(uint8_t state, ClockDemand demand) {
+  if (initialized) {
+    account();
+  }
+  currentState = state;
+  stateDemand = demand;
+  apply();
+}
+
+/**
+ * @brief Raise the clock to High until the matching clockBoostEnd().
+ */
+void clockBoostBegin() {
+  boostDepth++;
+  apply();
+}
+
+void clockBoostEnd() {
+  if (boostDepth > 0) {
+    boostDepth--;
+  }
+  apply();
+}
+
+/**
+ * @brief Force a fixed CPU clock for benchmarks.
+ */
+bool clockBenchSetMhz(uint32_t mhz) {
+  if (mhz != 240 && mhz != 160 && mhz != 80) {
+    return false;
+  }
+  benchMhz = mhz;
+  apply();
+  return true;
+}
+
+void clockBenchRestore() {
+  benchMhz = 0;
+  apply();
+}
+
+uint32_t clockCurrentMhz() { return appliedMhz; }
+
+/**
+ * @brief Console handler for "clock [reset]".
+ *
+ * Prints, per state, the time spent at each frequency (ms) since boot or the
+ * last reset.
+ */
+void clockCommand(const char *args) {
+  if (!initialized) {
+    Serial.println(F("[Clock] not initialized"));
+    return;
+  }
+  account();
+
+  if (strcmp(args, "reset") == 0) {
+    memset(usAt, 0, sizeof(usAt));
+    Serial.println(F("[Clock] counters reset"));
+    return;
+  }
+
+  Serial.printf("[Clock] now %lu MHz (%s), ms at each clock:\n",
+                static_cast<unsigned long>(appliedMhz),
+#if CONFIG_PM_ENABLE
+                "esp_pm"
+#else
+                "setCpuFrequencyMhz"
+#endif
+  );
+  Serial.print(F("  state    "));
+  for (size_t f = 0; f < FREQ_SLOT_COUNT; ++f) {
+    Serial.printf(" %7luM", static_cast<unsigned long>(FREQ_SLOTS_MHZ[f]));
+  }
+  Serial.println();
+  for (size_t s = 0; s < stateCount; ++s) {
+    Serial.printf("  %-9s", names != nullptr ? names[s] : "?");
+    for (size_t f = 0; f < FREQ_SLOT_COUNT; ++f) {
+      Serial.printf(" %8lu", static_cast<unsigned long>(usAt[s][f] / 1000));
+    }
+    Serial.println();
+  }
+}
@@ -0,0 +1,72 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ─── CPU clock scaling ──────────────────────────────────────────
+//
+// Each application state asks for a Low (CLOCK_LOW_MHZ) or High
+// (CLOCK_HIGH_MHZ) CPU clock; ClockBoost scopes raise it to High around
+// short bursts of work (render, NVS) regardless of state. With CONFIG_PM_ENABLE
+// this drives an esp_pm ESP_PM_CPU_FREQ_MAX lock; otherwise it falls back to
+// setCpuFrequencyMhz(). Time spent at each frequency is counted per state
+// ("clock" on the serial console).
+
+static constexpr uint32_t CLOCK_HIGH_MHZ = 240;
+static constexpr uint32_t CLOCK_LOW_MHZ = 80; // lowest with an 80 MHz APB
+static constexpr size_t CLOCK_MAX_STATES = 8;
+
+enum class ClockDemand : uint8_t { Low, High };
+
+/**
+ * @brief Set up power management and start counting in state 0.
+ *
+ * @param stateNames Names for "clock" output, indexed by state.
+ * @param stateCount Number of states (at most CLOCK_MAX_STATES).
+ */
+void clockInit(const char *const *stateNames, size_t stateCount);
+
+/**
+ * @brief Switch to application state `state` and its clock demand.
+ */
+void clockSetState(uint8_t state, ClockDemand demand);
+
+/**
+ * @brief Raise the clock to High until the matching clockBoostEnd().
+ *
+ * Nests. Prefer the ClockBoost scope below.
+ */
+void clockBoostBegin();
+void clockBoostEnd();
+
+/**
+ * @brief Force a fixed CPU clock for benchmarks; clockBenchRestore() undoes it.
+ *
+ * @return false if `mhz` isn't supported.
+ */
+bool clockBenchSetMhz(uint32_t mhz);
+void clockBenchRestore();
+
+/**
+ * @brief Current CPU clock in MHz, as set by this module.
+ */
+uint32_t clockCurrentMhz();
+
+/**
+ * @brief Console handler for "clock [reset]".
+ */
+void clockCommand(const char *args);
+
+/**
+ * @brief Hold the High clock for the enclosing scope.
+ */
+class ClockBoost {
+public:
+  ClockBoost() { clockBoostBegin(); }
+  ~ClockBoost() { clockBoostEnd(); }
+  ClockBoost(const ClockBoost &) = delete;
+  ClockBoost &operator=(const ClockBoost &) = delete;
+};
+
+#endif // CLOCK_H
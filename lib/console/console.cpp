@@ -0,0 +1,111 @@
+#include "console.h"
+#include <Arduino.h>
+#include <string.h>
+
+static constexpr size_t CONSOLE_LINE_MAX = 96;
+
+static const ConsoleCommand *commandTable = nullptr;
+static size_t commandCount = 0;
+
+static char lineBuffer[CONSOLE_LINE_MAX];
+static size_t lineLength = 0;
+static bool lineOverflowed = false;
+
+/**
+ * @brief Print the registered commands and their help text.
+ */
+static void printHelp() {
+  Serial.println(F("Commands:"));
+  Serial.println(F("  help"));
+  for (size_t i = 0; i < commandCount; ++i) {
+    Serial.print(F("  "));
+    Serial.print(commandTable[i].name);
+    Serial.print(F(" - "));
+    Serial.println(commandTable[i].help);
+  }
+}
+
+/**
+ * @brief Split a completed line into "<name> <args>" and run the handler.
+ */
+static void dispatchLine(char *line) {
+  while (*line == ' ') {
+    line++;
+  }
+  if (*line == '\0') {
+    return;
+  }
+
+  char *args = line;
+  while (*args != '\0' && *args != ' ') {
+    args++;
+  }
+  if (*args == ' ') {
+    *args++ = '\0';
+    while (*args == ' ') {
+      args++;
+    }
+  }
+
+  if (strcmp(line, "help") == 0) {
+    printHelp();
+    return;
+  }
+
+  for (size_t i = 0; i < commandCount; ++i) {
+    if (strcmp(line, commandTable[i].name) == 0) {
+      commandTable[i].handler(args);
+      return;
+    }
+  }
+
+  Serial.print(F("[Console] Unknown command: "));
+  Serial.println(line);
+}
+
+/**
+ * @brief Register the command table (not copied; must outlive the console).
+ */
+void consoleInit(const ConsoleCommand *commands, size_t count) {
+  commandTable = commands;
+  commandCount = count;
+  lineLength = 0;
+  lineOverflowed = false;
+}
+
+/**
+ * @brief Drain pending serial input without blocking; run complete lines.
+ *
+ * Lines longer than the buffer are discarded whole rather than run truncated.
+ *
+ * @return true if any input arrived (counts as user activity).
+ */
+bool consolePoll() {
+  bool gotInput = false;
+  while (Serial.available() > 0) {
+    const int c = Serial.read();
+    if (c < 0) {
+      return gotInput;
+    }
+    gotInput = true;
+
+    if (c == '\r' || c == '\n') {
+      if (lineOverflowed) {
+        Serial.println(F("[Console] Line too long; ignored."));
+      } else if (lineLength > 0) {
+        lineBuffer[lineLength] = '\0';
+        dispatchLine(lineBuffer);
+      }
+      lineLength = 0;
+      lineOverflowed = false;
+      continue;
+    }
+
+    if (lineLength + 1 >= CONSOLE_LINE_MAX) {
+      lineOverflowed = true;
+      continue;
+    }
+    lineBuffer[lineLength++] = static_cast<char>(c);
+  }
+  return gotInput;
+}
@@ -0,0 +1,23 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stddef.h>
+
+// ─── Serial command console ─────────────────────────────────────
+//
+// Line-based: type "<name> [args]" + Enter in the serial monitor.
+// "help" lists the registered commands.
+
+typedef void (*ConsoleHandler)(const char *args);
+
+struct ConsoleCommand {
+  const char *name;
+  const char *help;
+  ConsoleHandler handler;
+};
+
+// ─── API ────────────────────────────────────────────────────────
+void consoleInit(const ConsoleCommand *commands, size_t count);
+bool consolePoll();
+
+#endif // CONSOLE_H
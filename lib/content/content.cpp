@@ -0,0 +1,222 @@
+#include "content.h"
+#include "grammar.h"
+#include "ngram.h"
+#include <string.h>
+
+static constexpr uint32_t NO_ID = 0xFFFFFFFFUL;
+
+// Last generated insult resolved (text + runtime layout).
+static uint32_t generatedId = NO_ID;
+static constexpr size_t GENERATED_TEXT_CAPACITY =
+    GRAMMAR_TEXT_CAPACITY > NGRAM_TEXT_CAPACITY ? GRAMMAR_TEXT_CAPACITY
+                                                : NGRAM_TEXT_CAPACITY;
+static char generatedText[GENERATED_TEXT_CAPACITY];
+static size_t generatedLength = 0;
+static CorpusLine generatedLines[CONTENT_MAX_LINES];
+static CorpusTextLayout generatedLayout = {};
+
+// ───────────────── Runtime layout ─────────────────
+
+/**
+ * @brief Rendered width of a run, like _run_width() in layout.py.
+ */
+static uint16_t runWidth(const char *text, size_t length, uint8_t scale) {
+  uint32_t advance = 0;
+  for (size_t i = 0; i < length; ++i) {
+    const FontGlyph *glyph = fontGlyphFor(static_cast<uint8_t>(text[i]));
+    if (glyph != nullptr) {
+      advance += glyph->width + FONT_SPACING;
+    }
+  }
+  if (advance <= FONT_SPACING) {
+    return 0;
+  }
+  const uint32_t width = (advance - FONT_SPACING) * scale;
+  return width > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(width);
+}
+
+/**
+ * @brief Greedy wrap at one scale, like wrap() in layout.py.
+ *
+ * @return Line count, or 0 if the text doesn't fit.
+ */
+static uint8_t wrapAtScale(const char *text, size_t n, uint8_t scale,
+                           CorpusLine *lines, size_t capacity) {
+  const size_t pitch = (FONT_HEIGHT + FONT_LINE_GAP) * scale;
+  size_t maxLines = (BODY_HEIGHT + FONT_LINE_GAP * scale) / pitch;
+  if (maxLines > capacity) {
+    maxLines = capacity;
+  }
+
+  size_t count = 0;
+  size_t cursor = 0;
+  while (cursor < n) {
+    // Skip the spaces we broke on.
+    while (cursor < n && text[cursor] == ' ') {
+      cursor++;
+    }
+    if (cursor >= n) {
+      break;
+    }
+
+    size_t end = cursor;
+    size_t best = 0; // end of the last word boundary that fits; 0 = none
+    while (end < n) {
+      size_t wordEnd = end;
+      while (wordEnd < n && text[wordEnd] != ' ') {
+        wordEnd++;
+      }
+      if (runWidth(text + cursor, wordEnd - cursor, scale) > BODY_WIDTH) {
+        break;
+      }
+      best = wordEnd;
+      end = wordEnd;
+      while (end < n && text[end] == ' ') {
+        end++;
+      }
+    }
+
+    if (best == 0) {
+      // A single word wider than the panel: hard-break it by characters.
+      best = cursor + 1;
+      while (best < n && text[best] != ' ' &&
+             runWidth(text + cursor, best + 1 - cursor, scale) <= BODY_WIDTH) {
+        best++;
+      }
+      if (runWidth(text + cursor, best - cursor, scale) > BODY_WIDTH) {
+        return 0;
+      }
+    }
+
+    const size_t length = best - cursor;
+    if (count >= maxLines || length > 0xFF || cursor > 0xFFFF) {
+      return 0;
+    }
+    lines[count].start = static_cast<uint16_t>(cursor);
+    lines[count].length = static_cast<uint8_t>(length);
+    lines[count].width =
+        static_cast<uint8_t>(runWidth(text + cursor, length, scale));
+    count++;
+    cursor = best;
+  }
+  return static_cast<uint8_t>(count);
+}
+
+/**
+ * @brief Word-wrap text into the body box at runtime.
+ */
+bool contentLayoutText(const char *text, size_t length, CorpusLine *lines,
+                       size_t capacity, CorpusTextLayout &out) {
+  for (size_t s = 0; s < CORPUS_FONT_SCALE_COUNT; ++s) {
+    const uint8_t count =
+        wrapAtScale(text, length, CORPUS_FONT_SCALES[s], lines, capacity);
+    if (count == 0) {
+      continue;
+    }
+    out.scale = CORPUS_FONT_SCALES[s];
+    out.lineCount = count;
+    out.lines = lines;
+    return true;
+  }
+  return false;
+}
+
+// ───────────────── API ─────────────────
+
+bool contentCorpusIndex(uint32_t id, uint16_t &outIndex) {
+  return contentKindOf(id) == ContentKind::Corpus &&
+         corpusFindId(contentIndexOf(id), outIndex);
+}
+
+bool contentIsValid(uint32_t id) {
+  const uint32_t index = contentIndexOf(id);
+  uint16_t corpusIndex = 0;
+  switch (contentKindOf(id)) {
+  case ContentKind::Corpus:
+    return corpusFindId(index, corpusIndex);
+  case ContentKind::Grammar:
+    return index < grammarSentenceCount();
+  case ContentKind::Ngram:
+    return true;
+  case ContentKind::Count:
+    break;
+  }
+  return false;
+}
+
+ContentFingerprint contentFingerprint() {
+  return {CORPUS_ID_FINGERPRINT, grammarTableHash(), NGRAM_MODEL_HASH};
+}
+
+bool contentIsCurrent(uint32_t id, const ContentFingerprint &savedWith) {
+  switch (contentKindOf(id)) {
+  case ContentKind::Corpus:
+    break;
+  case ContentKind::Grammar:
+    if (savedWith.grammar != grammarTableHash()) {
+      return false;
+    }
+    break;
+  case ContentKind::Ngram:
+    if (savedWith.ngram != NGRAM_MODEL_HASH) {
+      return false;
+    }
+    break;
+  case ContentKind::Count:
+    return false;
+  }
+  return contentIsValid(id);
+}
+
+/**
+ * @brief Text and layout for an id.
+ */
+bool contentResolve(uint32_t id, ContentText &out) {
+  if (contentKindOf(id) == ContentKind::Corpus) {
+    uint16_t corpusIndex = 0;
+    if (!corpusFindId(contentIndexOf(id), corpusIndex) ||
+        !corpusGetLayout(corpusIndex, out.layout)) {
+      return false;
+    }
+    out.text = corpusText(corpusIndex);
+    out.length = strlen(out.text);
+    return true;
+  }
+
+  if (!contentIsValid(id)) {
+    return false;
+  }
+
+  const uint32_t index = contentIndexOf(id);
+
+  if (id != generatedId) {
+    generatedId = NO_ID;
+    generatedLength =
+        contentKindOf(id) == ContentKind::Grammar
+            ? grammarExpand(index, generatedText, sizeof(generatedText))
+            : ngramGenerate(index, generatedText, sizeof(generatedText));
+    if (generatedLength == 0 ||
+        !contentLayoutText(generatedText, generatedLength, generatedLines,
+                           CONTENT_MAX_LINES, generatedLayout)) {
+      return false;
+    }
+    generatedId = id;
+  }
+
+  out.text = generatedText;
+  out.length = generatedLength;
+  out.layout = generatedLayout;
+  return true;
+}
+
+/**
+ * @brief Id that stands for what `id` says, for dedupe.
+ */
+uint32_t contentTextKey(uint32_t id) {
+  ContentText content;
+  if (contentKindOf(id) != ContentKind::Ngram || !contentResolve(id, content)) {
+    return id;
+  }
+  return contentMakeId(ContentKind::Ngram,
+                       ngramTextHash(content.text, content.length));
+}
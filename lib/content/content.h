@@ -0,0 +1,132 @@
+#ifndef CONTENT_H
+#define CONTENT_H
+
+#include "corpus.h"
+#include "font.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ─── Content ids ────────────────────────────────────────────────
+//
+// History, persistence and rendering name an insult by a 32-bit id: the top
+// nibble says which engine produced it, the low 28 bits are that engine's
+// own index. For the corpus that is the stable text hash (corpusIdOf()), so
+// saved ids survive corpus edits; generated ids stay valid as long as the
+// engine's source tables do. Save contentFingerprint() next to stored ids and
+// check them with contentIsCurrent() when loading.
+
+enum class ContentKind : uint8_t {
+  Corpus = 0, // assets/insults.txt, packed at build time; index = text hash
+  Grammar,    // lib/grammar template sentences
+  Ngram,      // lib/ngram Markov lines; the index is the seed
+  Count
+};
+
+static constexpr uint8_t CONTENT_INDEX_BITS = 28;
+static constexpr uint32_t CONTENT_INDEX_MASK = (1UL << CONTENT_INDEX_BITS) - 1;
+
+constexpr uint32_t contentMakeId(ContentKind kind, uint32_t index) {
+  return (static_cast<uint32_t>(kind) << CONTENT_INDEX_BITS) |
+         (index & CONTENT_INDEX_MASK);
+}
+
+constexpr ContentKind contentKindOf(uint32_t id) {
+  return static_cast<ContentKind>(id >> CONTENT_INDEX_BITS);
+}
+
+constexpr uint32_t contentIndexOf(uint32_t id) {
+  return id & CONTENT_INDEX_MASK;
+}
+
+/**
+ * @brief Content id of the corpus insult at `index`.
+ */
+inline uint32_t contentCorpusId(uint16_t index) {
+  return contentMakeId(ContentKind::Corpus, corpusIdOf(index));
+}
+
+// Most lines any layout can have (scale 1).
+static constexpr size_t CONTENT_MAX_LINES =
+    (BODY_HEIGHT + FONT_LINE_GAP) / (FONT_HEIGHT + FONT_LINE_GAP);
+
+// What saved ids mean, per engine. Corpus ids are text hashes, so the corpus
+// fingerprint only tells that lines may be gone; a changed grammar or n-gram
+// fingerprint means that engine's ids may name other text.
+struct ContentFingerprint {
+  uint32_t corpus;  // CORPUS_ID_FINGERPRINT
+  uint32_t grammar; // grammarTableHash()
+  uint32_t ngram;   // NGRAM_MODEL_HASH
+};
+
+// Text + layout, ready to print or blit.
+struct ContentText {
+  const char *text; // codepage bytes
+  size_t length;
+  CorpusTextLayout layout;
+};
+
+// ─── API ────────────────────────────────────────────────────────
+
+/**
+ * @brief Whether `id` names an insult this build can produce.
+ *
+ * Any n-gram seed is valid here; a seed that yields no novel line only fails
+ * in contentResolve().
+ */
+bool contentIsValid(uint32_t id);
+
+/**
+ * @brief Fingerprint of this build's engines.
+ */
+ContentFingerprint contentFingerprint();
+
+/**
+ * @brief Whether an id saved under `savedWith` still names the same insult.
+ *
+ * Corpus ids only need to exist; generated ids also need their engine's
+ * fingerprint unchanged.
+ */
+bool contentIsCurrent(uint32_t id, const ContentFingerprint &savedWith);
+
+/**
+ * @brief Current corpus index of a corpus content id.
+ *
+ * @return false for other kinds, or an insult this build doesn't have.
+ */
+bool contentCorpusIndex(uint32_t id, uint16_t &outIndex);
+
+/**
+ * @brief Id that stands for what `id` says, for dedupe.
+ *
+ * Different n-gram seeds can generate the same line, so an n-gram id maps to
+ * an id of the same kind holding a hash of its resolved text (or to itself if
+ * it doesn't resolve). Corpus and grammar ids already name distinct texts and
+ * map to themselves. Resolves n-gram ids, see contentResolve().
+ */
+uint32_t contentTextKey(uint32_t id);
+
+/**
+ * @brief Text and layout for an id.
+ *
+ * Corpus insults point into flash with their pack-time layout. Generated
+ * ones are expanded into a static buffer and wrapped at runtime; the result
+ * stays valid until an id of another generated insult is resolved (resolving
+ * the same id again is free).
+ *
+ * @return false if the id is invalid or its text fits at no font scale.
+ */
+bool contentResolve(uint32_t id, ContentText &out);
+
+/**
+ * @brief Word-wrap text into the body box at runtime.
+ *
+ * Same greedy wrap as the pack step (scripts/bardpack/layout.py), for text
+ * that only exists on device. Tries the layout scales largest first.
+ *
+ * @param lines Receives the lines; CONTENT_MAX_LINES entries always suffice.
+ * @return false if the text fits at no scale (or in `capacity` lines).
+ */
+bool contentLayoutText(const char *text, size_t length, CorpusLine *lines,
+                       size_t capacity, CorpusTextLayout &out);
+
+#endif // CONTENT_H
@@ -0,0 +1,112 @@
+#include "corpus.h"
+
+/**
+ * @brief Look up the precomputed layout for an insult.
+ *
+ * The pack step guarantees at least one scale fits (otherwise the build
+ * fails), so for any valid index this always produces a layout.
+ */
+bool corpusGetLayout(uint16_t index, CorpusTextLayout &out) {
+  if (index >= CORPUS_INSULT_COUNT) {
+    return false;
+  }
+
+  const CorpusLayout *perScale = &corpusLayouts[index * CORPUS_FONT_SCALE_COUNT];
+  for (size_t s = 0; s < CORPUS_FONT_SCALE_COUNT; ++s) {
+    if (perScale[s].lineCount == 0) {
+      continue;
+    }
+    out.scale = CORPUS_FONT_SCALES[s];
+    out.lineCount = static_cast<uint8_t>(perScale[s].lineCount);
+    out.lines = &corpusLines[perScale[s].firstLine];
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Current index of the insult with stable id `id`.
+ */
+bool corpusFindId(uint32_t id, uint16_t &outIndex) {
+  size_t lo = 0;
+  size_t hi = CORPUS_INSULT_COUNT;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    const uint32_t midId = corpusIds[corpusIdOrder[mid]];
+    if (midId == id) {
+      outIndex = corpusIdOrder[mid];
+      return true;
+    }
+    if (midId < id) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Whether an epoch draw may take `index` now.
+ *
+ * Needs budget left, and avoids repeating the previous draw while any other
+ * insult still has budget.
+ */
+static bool epochCanTake(const CorpusEpoch &epoch, uint16_t index) {
+  return epoch.budget[index] > 0 &&
+         (index != epoch.last || epoch.budget[index] == epoch.drawsLeft);
+}
+
+/**
+ * @brief Draw from the current epoch, starting a new one when it runs out.
+ *
+ * Within an epoch draws follow the weights of what's left: an alias draw
+ * that hits a spent (or avoided) insult is rejected, and after
+ * CORPUS_EPOCH_MAX_REJECTS of those a scan from a random start takes the next
+ * insult with budget, preferring one that isn't avoided.
+ */
+uint16_t corpusEpochDraw(CorpusEpoch &epoch, uint32_t (*random32)(),
+                         bool (*avoid)(uint16_t index)) {
+  if (CORPUS_INSULT_COUNT == 0) {
+    return 0;
+  }
+  if (epoch.drawsLeft == 0) {
+    for (size_t i = 0; i < CORPUS_INSULT_COUNT; ++i) {
+      epoch.budget[i] = corpusEpochBudgets[i];
+    }
+    epoch.drawsLeft = CORPUS_EPOCH_DRAWS;
+  }
+
+  uint16_t index = 0;
+  bool found = false;
+  for (uint8_t i = 0; i < CORPUS_EPOCH_MAX_REJECTS && !found; ++i) {
+    index = corpusAliasDraw(random32());
+    found = epochCanTake(epoch, index) && !(avoid && avoid(index));
+  }
+  if (!found) {
+    const uint16_t start =
+        static_cast<uint16_t>(random32() % CORPUS_INSULT_COUNT);
+    size_t fallback = CORPUS_INSULT_COUNT; // first takeable, avoided or not
+    index = start;
+    do {
+      if (epochCanTake(epoch, index)) {
+        if (!(avoid && avoid(index))) {
+          found = true;
+          break;
+        }
+        if (fallback == CORPUS_INSULT_COUNT) {
+          fallback = index;
+        }
+      }
+      index = static_cast<uint16_t>((index + 1) % CORPUS_INSULT_COUNT);
+    } while (index != start);
+    if (!found) {
+      index = static_cast<uint16_t>(fallback);
+    }
+  }
+
+  epoch.budget[index]--;
+  epoch.drawsLeft--;
+  epoch.last = index;
+  return index;
+}
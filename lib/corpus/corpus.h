@@ -0,0 +1,146 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Generated at build time by scripts/pack_corpus.py (sizes + geometry).
+#include "corpus_gen.h"
+
+// ─── Precomputed layout (side table) ────────────────────────────
+
+// One wrapped line of an insult at one font scale.
+struct CorpusLine {
+  uint16_t start; // offset into the insult text (codepage bytes)
+  uint8_t length; // characters on this line (break space excluded)
+  uint8_t width;  // rendered width in pixels
+};
+
+// Where an insult's lines live in corpusLines[] for one font scale.
+struct CorpusLayout {
+  uint32_t firstLine : 24;
+  uint32_t lineCount : 8; // 0 = does not fit at this scale
+};
+
+// Resolved layout the renderer can blit without measuring anything.
+struct CorpusTextLayout {
+  uint8_t scale;
+  uint8_t lineCount;
+  const CorpusLine *lines;
+};
+
+// ─── Weighted draws ─────────────────────────────────────────────
+//
+// Walker/Vose alias table built at pack time from the {w=N} weights: one
+// slot per insult, each keeping `threshold`/65536 of its mass for itself and
+// giving the rest to `alias` (scripts/bardpack/alias.py).
+struct CorpusAlias {
+  uint16_t threshold; // 0xFFFF with alias == slot: the slot is full
+  uint16_t alias;
+};
+
+// Alias draws that may land on a spent insult before an epoch draw scans for
+// one with budget left (only happens near the end of an epoch).
+static constexpr uint8_t CORPUS_EPOCH_MAX_REJECTS = 16;
+
+/**
+ * @brief Weighted draws with deck-style no-repeat budgets.
+ *
+ * An epoch hands each insult corpusEpochBudgets[i] draws (its weight reduced
+ * by the GCD), so over an epoch frequencies match the weights exactly; with
+ * equal weights it is a shuffled deck. Start from CORPUS_EPOCH_INIT.
+ */
+struct CorpusEpoch {
+  uint8_t budget[CORPUS_INSULT_COUNT];
+  uint32_t drawsLeft; // 0 = start a new epoch on the next draw
+  uint16_t last;      // previous draw, avoided while others have budget
+};
+
+static constexpr CorpusEpoch CORPUS_EPOCH_INIT = {{0}, 0, 0xFFFF};
+
+// ─── Generated tables (flash) ───────────────────────────────────
+extern const char corpusBlob[];
+extern const uint32_t corpusOffsets[];
+extern const CorpusLine corpusLines[];
+extern const CorpusLayout corpusLayouts[];
+extern const uint8_t corpusEpochBudgets[];
+extern const CorpusAlias corpusAlias[];
+extern const uint32_t corpusIds[];
+extern const uint16_t corpusIdOrder[];
+
+// ─── API ────────────────────────────────────────────────────────
+
+/**
+ * @brief NUL-terminated text of the insult at `index`.
+ *
+ * The text is in the font codepage (one byte per character, see font.h),
+ * not UTF-8.
+ *
+ * @param index Insult index (0..CORPUS_INSULT_COUNT-1); not range-checked.
+ */
+inline const char *corpusText(uint16_t index) {
+  return corpusBlob + corpusOffsets[index];
+}
+
+/**
+ * @brief Stable id of the insult at `index`.
+ *
+ * A 28-bit hash of the normalized text (scripts/bardpack/ids.py): it
+ * survives reordering and other lines being added or removed, so history and
+ * saved state store ids rather than indices.
+ *
+ * @param index Insult index; not range-checked.
+ */
+inline uint32_t corpusIdOf(uint16_t index) { return corpusIds[index]; }
+
+/**
+ * @brief Current index of the insult with stable id `id`.
+ *
+ * Binary search over the pack-time id order: O(log n), no RAM.
+ *
+ * @return false if no insult in this build has that id.
+ */
+bool corpusFindId(uint32_t id, uint16_t &outIndex);
+
+/**
+ * @brief Look up the precomputed layout for an insult.
+ *
+ * Picks the largest font scale the pack step found to fit the body box.
+ *
+ * @param index Insult index.
+ * @param out Receives scale, line count and the line table.
+ * @return false if the index is out of range.
+ */
+bool corpusGetLayout(uint16_t index, CorpusTextLayout &out);
+
+/**
+ * @brief Weighted draw: one random number, one table read, one compare.
+ *
+ * r * count is a fixed-point number whose integer part picks the slot and
+ * whose fraction (uniform within the slot) is compared with the threshold.
+ *
+ * @param r Uniform 32-bit random number (e.g. esp_random()).
+ * @return Insult index, with probability proportional to its weight.
+ */
+inline uint16_t corpusAliasDraw(uint32_t r) {
+  const uint64_t scaled = static_cast<uint64_t>(r) * CORPUS_INSULT_COUNT;
+  const uint16_t slot = static_cast<uint16_t>(scaled >> 32);
+  const uint16_t fraction = static_cast<uint16_t>(scaled >> 16);
+  const CorpusAlias &entry = corpusAlias[slot];
+  return fraction < entry.threshold ? slot : entry.alias;
+}
+
+/**
+ * @brief Draw from the current epoch, starting a new one when it runs out.
+ *
+ * @param epoch Budgets, initially CORPUS_EPOCH_INIT.
+ * @param random32 Uniform 32-bit random source.
+ * @param avoid Optional: insults to pass over while another one with budget
+ * is not avoided. A passed-over insult keeps its budget for later in the
+ * epoch, so per-epoch counts still match the weights.
+ * @return Insult index.
+ */
+uint16_t corpusEpochDraw(CorpusEpoch &epoch, uint32_t (*random32)(),
+                         bool (*avoid)(uint16_t index) = nullptr);
+
+#endif // CORPUS_H
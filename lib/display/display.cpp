@@ -0,0 +1,33 @@
+#include "display.h"
+#include "energy.h"
+#include "trace.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+uint32_t displayFramebuffer[PANEL_HEIGHT][DISPLAY_WORDS_PER_ROW];
+
+/**
+ * @brief Prepare the framebuffer (and, later, the panel) for drawing.
+ */
+void displayInit() { displayClear(); }
+
+/**
+ * @brief Clear the whole framebuffer to paper.
+ */
+void displayClear() { memset(displayFramebuffer, 0, sizeof(displayFramebuffer)); }
+
+/**
+ * @brief Push the framebuffer to the panel.
+ *
+ * The Waveshare 2.13" panel isn't wired yet, so this is the seam where the
+ * SPI transfer will go. The panel wants MSB-first bytes with 1 = white, so
+ * the transfer will be a byte swap + invert per word.
+ *
+ * Each flush counts as one panel refresh for energy accounting, charged at
+ * the model's per-refresh figure (the refresh itself runs on the panel).
+ */
+void displayFlush() {
+  TRACE_SCOPE(TraceId::DisplayFlush);
+  energyNoteDisplayRefresh();
+}
@@ -0,0 +1,26 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Panel geometry is generated from scripts/bardpack/layout.py.
+#include "corpus.h"
+
+// ─── Framebuffer ────────────────────────────────────────────────
+//
+// 1bpp, row-major, 32 pixels per word. Within a word the most significant
+// bit is the leftmost pixel, so a glyph row can be placed at any x with one
+// right shift (plus a left shift for the spill into the next word).
+// 1 = ink (black), 0 = paper.
+
+static constexpr size_t DISPLAY_WORDS_PER_ROW = (PANEL_WIDTH + 31) / 32;
+
+extern uint32_t displayFramebuffer[PANEL_HEIGHT][DISPLAY_WORDS_PER_ROW];
+
+// ─── API ────────────────────────────────────────────────────────
+void displayInit();
+void displayClear();
+void displayFlush();
+
+#endif // DISPLAY_H
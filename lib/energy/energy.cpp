@@ -0,0 +1,317 @@
+#include "energy.h"
+#include "clock.h"
+#include "persist_keys.h"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_private/esp_clk.h>
+#include <esp_timer.h>
+#include <string.h>
+
+// ───────────────── Counters ─────────────────
+
+static constexpr uint32_t ENERGY_MAGIC = 0x454E5231; // "ENR1"
+static constexpr uint64_t ENERGY_FOLD_INTERVAL_MS = 15ULL * 60 * 1000;
+static constexpr const char *ENERGY_NVS_KEY = "energy";
+
+static constexpr size_t MODE_COUNT = static_cast<size_t>(EnergyMode::Count);
+static constexpr size_t LED_COUNT = static_cast<size_t>(EnergyLed::Count);
+
+struct EnergyCounters {
+  uint32_t magic;
+  uint32_t displayRefreshes;
+  uint32_t flashWrites;
+  uint32_t reserved;
+  uint64_t stateUs[ENERGY_MAX_STATES];
+  uint64_t modeUs[MODE_COUNT];
+  uint64_t ledUs[LED_COUNT];
+  uint64_t chargeUaMs;
+};
+
+// Session counters: RTC memory, since the last fold into NVS.
+static RTC_DATA_ATTR EnergyCounters session;
+static RTC_DATA_ATTR uint64_t sleepStartedRtcUs = 0;
+
+// ───────────────── Live state ─────────────────
+
+static EnergyModel model = {};
+static const char *const *names = nullptr;
+static size_t stateCount = 0;
+static bool initialized = false;
+
+static uint64_t lastAccountedUs = 0;
+static uint8_t currentState = 0;
+static EnergyMode currentMode = EnergyMode::Active;
+static EnergyLed currentLed = EnergyLed::Off;
+static uint32_t ledUa = 0; // above quiescent
+
+static void resetCounters(EnergyCounters &c) {
+  memset(&c, 0, sizeof(c));
+  c.magic = ENERGY_MAGIC;
+}
+
+static uint64_t modeUa(EnergyMode mode) {
+  switch (mode) {
+  case EnergyMode::Active:
+    return clockCurrentMhz() >= CLOCK_HIGH_MHZ ? model.activeHighUa
+                                               : model.activeLowUa;
+  case EnergyMode::LightSleep:
+    return model.lightSleepUa;
+  case EnergyMode::DeepSleep:
+    return model.deepSleepUa;
+  case EnergyMode::Count:
+    break;
+  }
+  return 0;
+}
+
+/**
+ * @brief Charge `us` at the current state/mode/LED.
+ */
+static void charge(uint64_t us) {
+  // Application states only exist while the app runs.
+  if (currentMode != EnergyMode::DeepSleep &&
+      currentState < ENERGY_MAX_STATES) {
+    session.stateUs[currentState] += us;
+  }
+  session.modeUs[static_cast<size_t>(currentMode)] += us;
+  session.ledUs[static_cast<size_t>(currentLed)] += us;
+  const uint64_t ua = modeUa(currentMode) + model.ledQuiescentUa + ledUa;
+  session.chargeUaMs += (us * ua) / 1000;
+}
+
+static void account() {
+  if (!initialized) {
+    return;
+  }
+  const uint64_t now = static_cast<uint64_t>(esp_timer_get_time());
+  charge(now - lastAccountedUs);
+  lastAccountedUs = now;
+}
+
+static void addCounters(EnergyCounters &into, const EnergyCounters &from) {
+  into.displayRefreshes += from.displayRefreshes;
+  into.flashWrites += from.flashWrites;
+  for (size_t i = 0; i < ENERGY_MAX_STATES; ++i) {
+    into.stateUs[i] += from.stateUs[i];
+  }
+  for (size_t i = 0; i < MODE_COUNT; ++i) {
+    into.modeUs[i] += from.modeUs[i];
+  }
+  for (size_t i = 0; i < LED_COUNT; ++i) {
+    into.ledUs[i] += from.ledUs[i];
+  }
+  into.chargeUaMs += from.chargeUaMs;
+}
+
+static uint64_t totalUs(const EnergyCounters &c) {
+  uint64_t us = 0;
+  for (size_t i = 0; i < MODE_COUNT; ++i) {
+    us += c.modeUs[i];
+  }
+  return us;
+}
+
+// ───────────────── NVS ─────────────────
+
+static bool loadLifetime(EnergyCounters &out) {
+  Preferences prefs;
+  if (!prefs.begin(NVS_NS, true)) {
+    return false;
+  }
+  const bool ok =
+      prefs.getBytesLength(ENERGY_NVS_KEY) == sizeof(out) &&
+      prefs.getBytes(ENERGY_NVS_KEY, &out, sizeof(out)) == sizeof(out) &&
+      out.magic == ENERGY_MAGIC;
+  prefs.end();
+  return ok;
+}
+
+/**
+ * @brief Add the session counters to the NVS lifetime totals and zero them.
+ */
+static void foldIntoNvs() {
+  ClockBoost boost;
+  energyNoteFlashWrite(); // counted in the session being folded
+  account();
+
+  EnergyCounters lifetime;
+  if (!loadLifetime(lifetime)) {
+    resetCounters(lifetime);
+  }
+  addCounters(lifetime, session);
+
+  Preferences prefs;
+  if (!prefs.begin(NVS_NS, false)) {
+    return;
+  }
+  prefs.putBytes(ENERGY_NVS_KEY, &lifetime, sizeof(lifetime));
+  prefs.end();
+  resetCounters(session);
+}
+
+// ───────────────── API ─────────────────
+
+/**
+ * @brief Start accounting. Call early in setup().
+ */
+void energyInit(const EnergyModel &energyModel, const char *const *stateNames,
+                size_t count, bool wokeFromSleep) {
+  model = energyModel;
+  names = stateNames;
+  stateCount = count < ENERGY_MAX_STATES ? count : ENERGY_MAX_STATES;
+
+  if (!wokeFromSleep || session.magic != ENERGY_MAGIC) {
+    resetCounters(session);
+    sleepStartedRtcUs = 0;
+  }
+
+  initialized = true;
+  const uint64_t now = static_cast<uint64_t>(esp_timer_get_time());
+
+  // Deep sleep (plus ROM/bootloader) since energyNoteSleep().
+  if (sleepStartedRtcUs != 0) {
+    const uint64_t rtcNow = esp_clk_rtc_time();
+    if (rtcNow > sleepStartedRtcUs + now) {
+      currentMode = EnergyMode::DeepSleep;
+      charge(rtcNow - sleepStartedRtcUs - now);
+    }
+    sleepStartedRtcUs = 0;
+  }
+
+  // App startup so far, awake.
+  currentMode = EnergyMode::Active;
+  charge(now);
+  lastAccountedUs = now;
+}
+
+/**
+ * @brief Charge the time since the last call.
+ */
+void energyPoll() { account(); }
+
+void energySetState(uint8_t state) {
+  account();
+  currentState = state;
+}
+
+void energySetMode(EnergyMode mode) {
+  account();
+  currentMode = mode;
+}
+
+/**
+ * @brief Switch the LED color; its current follows the actual RGB and
+ * brightness (each channel scales linearly with both).
+ */
+void energySetLed(EnergyLed color, uint8_t r, uint8_t g, uint8_t b,
+                  uint8_t brightness) {
+  account();
+  currentLed = color;
+  ledUa = static_cast<uint32_t>(
+      (static_cast<uint64_t>(model.ledChannelUa) * (r + g + b) * brightness) /
+      (255u * 255u));
+}
+
+void energyNoteDisplayRefresh() {
+  session.displayRefreshes++;
+  session.chargeUaMs += model.displayRefreshUaMs;
+}
+
+void energyNoteFlashWrite() {
+  session.flashWrites++;
+  session.chargeUaMs += model.flashWriteUaMs;
+}
+
+/**
+ * @brief Account up to now, fold into NVS if due and remember the RTC time.
+ */
+void energyNoteSleep() {
+  account();
+  if (totalUs(session) / 1000 >= ENERGY_FOLD_INTERVAL_MS) {
+    foldIntoNvs();
+  }
+  currentMode = EnergyMode::DeepSleep;
+  sleepStartedRtcUs = esp_clk_rtc_time();
+}
+
+// ───────────────── Console ─────────────────
+
+static void printMs(const char *label, uint64_t us) {
+  Serial.printf("    %-10s %10lu ms\n", label,
+                static_cast<unsigned long>(us / 1000));
+}
+
+static void printCounters(const char *title, const EnergyCounters &c) {
+  static const char *const modeNames[MODE_COUNT] = {"active", "light",
+                                                    "deep"};
+  static const char *const ledNames[LED_COUNT] = {"off", "blue", "green",
+                                                  "yellow", "magenta"};
+
+  const uint64_t us = totalUs(c);
+  // µA·ms → µAh is /3.6e6; print mAh with 3 decimals.
+  const uint64_t uAh = c.chargeUaMs / 3600000ULL;
+  const uint64_t avgUa = us ? (c.chargeUaMs * 1000) / us : 0;
+  Serial.printf("[Energy] %s: %lu.%03lu mAh over %lu s (avg %lu uA)\n", title,
+                static_cast<unsigned long>(uAh / 1000),
+                static_cast<unsigned long>(uAh % 1000),
+                static_cast<unsigned long>(us / 1000000),
+                static_cast<unsigned long>(avgUa));
+
+  Serial.println(F("  state"));
+  for (size_t i = 0; i < stateCount; ++i) {
+    printMs(names != nullptr ? names[i] : "?", c.stateUs[i]);
+  }
+  Serial.println(F("  power mode"));
+  for (size_t i = 0; i < MODE_COUNT; ++i) {
+    printMs(modeNames[i], c.modeUs[i]);
+  }
+  Serial.println(F("  led"));
+  for (size_t i = 0; i < LED_COUNT; ++i) {
+    printMs(ledNames[i], c.ledUs[i]);
+  }
+  Serial.printf("  display    %lu refreshes\n",
+                static_cast<unsigned long>(c.displayRefreshes));
+  Serial.printf("  flash      %lu writes\n",
+                static_cast<unsigned long>(c.flashWrites));
+}
+
+/**
+ * @brief Console handler for "energy [save|reset]".
+ *
+ * - (none): session (RTC, since last fold) and lifetime (NVS + session)
+ * - save: fold the session into NVS now
+ * - reset: zero both
+ */
+void energyCommand(const char *args) {
+  if (!initialized) {
+    Serial.println(F("[Energy] not initialized"));
+    return;
+  }
+  account();
+
+  if (strcmp(args, "save") == 0) {
+    foldIntoNvs();
+    Serial.println(F("[Energy] folded into NVS"));
+    return;
+  }
+  if (strcmp(args, "reset") == 0) {
+    resetCounters(session);
+    ClockBoost boost;
+    Preferences prefs;
+    if (prefs.begin(NVS_NS, false)) {
+      prefs.remove(ENERGY_NVS_KEY);
+      prefs.end();
+    }
+    Serial.println(F("[Energy] reset"));
+    return;
+  }
+
+  printCounters("session", session);
+
+  EnergyCounters lifetime;
+  if (!loadLifetime(lifetime)) {
+    resetCounters(lifetime);
+  }
+  addCounters(lifetime, session);
+  printCounters("lifetime", lifetime);
+}
@@ -0,0 +1,76 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ─── Energy accounting ──────────────────────────────────────────
+//
+// Residency per application state, per power mode and per LED color, plus
+// display refresh and flash write counts, all multiplied by a current model
+// into a running charge estimate. Counters for the current session live in
+// RTC memory (they survive deep sleep) and are folded into NVS every
+// ENERGY_FOLD_INTERVAL_MS of accounted time, at deep-sleep entry. "energy" on
+// the serial console prints both.
+
+static constexpr size_t ENERGY_MAX_STATES = 8;
+
+enum class EnergyMode : uint8_t { Active = 0, LightSleep, DeepSleep, Count };
+
+enum class EnergyLed : uint8_t {
+  Off = 0,
+  Blue,    // Boot
+  Green,   // Idle / Resumed
+  Yellow,  // Updating
+  Magenta, // Sleep armed
+  Count
+};
+
+/**
+ * @brief Current model. Charges are in µA·ms (1 mAh = 3.6e9 µA·ms).
+ */
+struct EnergyModel {
+  uint32_t activeHighUa;       // CPU awake at CLOCK_HIGH_MHZ
+  uint32_t activeLowUa;        // CPU awake at a lower clock
+  uint32_t lightSleepUa;       // chip in light sleep
+  uint32_t deepSleepUa;        // chip in deep sleep (RTC domain, ULP)
+  uint32_t ledQuiescentUa;     // NeoPixel powered but dark (always, even asleep)
+  uint32_t ledChannelUa;       // one channel at value 255, brightness 255
+  uint32_t displayRefreshUaMs; // one panel refresh
+  uint32_t flashWriteUaMs;     // one NVS write session
+};
+
+/**
+ * @brief Start accounting. Call early in setup().
+ *
+ * On a wake, charges the time since energyNoteSleep() (RTC clock) to
+ * DeepSleep. On a cold boot, the RTC counters start from zero.
+ */
+void energyInit(const EnergyModel &model, const char *const *stateNames,
+                size_t stateCount, bool wokeFromSleep);
+
+/**
+ * @brief Charge the time since the last call. Call every loop().
+ */
+void energyPoll();
+
+void energySetState(uint8_t state);
+void energySetMode(EnergyMode mode);
+void energySetLed(EnergyLed color, uint8_t r, uint8_t g, uint8_t b,
+                  uint8_t brightness);
+void energyNoteDisplayRefresh();
+void energyNoteFlashWrite();
+
+/**
+ * @brief Account up to now, fold into NVS if due and remember the RTC time.
+ *
+ * Call right before esp_deep_sleep_start().
+ */
+void energyNoteSleep();
+
+/**
+ * @brief Console handler for "energy [save|reset]".
+ */
+void energyCommand(const char *args);
+
+#endif // ENERGY_H
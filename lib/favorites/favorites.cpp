@@ -0,0 +1,317 @@
+#include "favorites.h"
+#include "clock.h"
+#include "content.h"
+#include "energy.h"
+#include "font.h"
+#include "persist_keys.h"
+#include "trace.h"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <string.h>
+
+static constexpr uint32_t FAVORITES_MAGIC = 0x46415632; // "FAV2"
+// Same list behind a 12-byte header without generator fingerprints; its
+// corpus favorites are kept, generated ones dropped.
+static constexpr uint32_t FAVORITES_MAGIC_V1 = 0x46415631; // "FAV1"
+static constexpr size_t FAVORITES_V1_HEADER_BYTES = 12;
+static constexpr const char *FAVORITES_NVS_KEY = "fav";
+static constexpr size_t BITSET_WORDS = (CORPUS_INSULT_COUNT + 31) / 32;
+
+// ───────────────── State ─────────────────
+
+// NVS image, also the working copy: the list is short enough to rewrite whole.
+struct FavoritesSaved {
+  uint32_t magic;
+  uint16_t count;
+  uint16_t cursor; // favorites-only Next/Prev position in ids[]
+  uint8_t only;
+  uint8_t reserved[3];
+  uint32_t grammarFingerprint; // what generated ids meant when saved
+  uint32_t ngramFingerprint;
+  uint32_t ids[FAVORITES_MAX]; // marking order
+};
+
+static FavoritesSaved saved;
+
+// Corpus membership, by corpus index (not saved; rebuilt from the list).
+static uint32_t corpusBits[BITSET_WORDS];
+
+// contentTextKey() of each list entry, so n-gram seeds that generate the same
+// line are one favorite (not saved; rebuilt from the list).
+static uint32_t textKeys[FAVORITES_MAX];
+
+// ───────────────── Membership ─────────────────
+
+static bool bitTest(uint16_t index) {
+  return (corpusBits[index >> 5] >> (index & 31)) & 1;
+}
+
+static void bitAssign(uint16_t index, bool value) {
+  const uint32_t mask = 1UL << (index & 31);
+  if (value) {
+    corpusBits[index >> 5] |= mask;
+  } else {
+    corpusBits[index >> 5] &= ~mask;
+  }
+}
+
+/**
+ * @brief Position of the favorite that says what `id` says, or -1.
+ */
+static int listFind(uint32_t id) {
+  const uint32_t key = contentTextKey(id);
+  for (size_t i = 0; i < saved.count; ++i) {
+    if (textKeys[i] == key) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Append to the list (caller checks the cap and membership).
+ */
+static void listAppend(uint32_t id) {
+  textKeys[saved.count] = contentTextKey(id);
+  saved.ids[saved.count++] = id;
+}
+
+// ───────────────── NVS ─────────────────
+
+static void store() {
+  TRACE_SCOPE(TraceId::NvsWrite);
+  ClockBoost boost;
+  Preferences prefs;
+  if (!prefs.begin(NVS_NS, false)) {
+    return;
+  }
+  const size_t length = offsetof(FavoritesSaved, ids) +
+                        saved.count * sizeof(saved.ids[0]);
+  prefs.putBytes(FAVORITES_NVS_KEY, &saved, length);
+  prefs.end();
+  energyNoteFlashWrite();
+}
+
+static void resetState() {
+  memset(&saved, 0, sizeof(saved));
+  saved.magic = FAVORITES_MAGIC;
+  const ContentFingerprint fingerprint = contentFingerprint();
+  saved.grammarFingerprint = fingerprint.grammar;
+  saved.ngramFingerprint = fingerprint.ngram;
+}
+
+// ───────────────── API ─────────────────
+
+void favoritesInit() {
+  resetState();
+  memset(corpusBits, 0, sizeof(corpusBits));
+
+  FavoritesSaved loaded;
+  size_t length = 0;
+  {
+    TRACE_SCOPE(TraceId::NvsRead);
+    ClockBoost boost;
+    Preferences prefs;
+    if (!prefs.begin(NVS_NS, true)) {
+      return;
+    }
+    length = prefs.getBytesLength(FAVORITES_NVS_KEY);
+    if (length < FAVORITES_V1_HEADER_BYTES || length > sizeof(loaded) ||
+        prefs.getBytes(FAVORITES_NVS_KEY, &loaded, length) != length) {
+      length = 0;
+    }
+    prefs.end();
+  }
+  size_t header = offsetof(FavoritesSaved, ids);
+  if (length != 0 && loaded.magic == FAVORITES_MAGIC_V1) {
+    header = FAVORITES_V1_HEADER_BYTES;
+    memmove(loaded.ids, reinterpret_cast<const uint8_t *>(&loaded) + header,
+            length - header);
+    loaded.grammarFingerprint = 0;
+    loaded.ngramFingerprint = 0;
+  } else if (loaded.magic != FAVORITES_MAGIC) {
+    length = 0;
+  }
+  if (length == 0 || loaded.count > FAVORITES_MAX ||
+      length != header + loaded.count * sizeof(loaded.ids[0])) {
+    return;
+  }
+
+  // Keep only favorites this build can still show as the same text, once
+  // per line.
+  const ContentFingerprint savedWith = {CORPUS_ID_FINGERPRINT,
+                                        loaded.grammarFingerprint,
+                                        loaded.ngramFingerprint};
+  size_t stale = 0;
+  for (size_t i = 0; i < loaded.count; ++i) {
+    const uint32_t id = loaded.ids[i];
+    if (!contentIsCurrent(id, savedWith)) {
+      stale++;
+      continue;
+    }
+    if (listFind(id) >= 0) {
+      continue;
+    }
+    uint16_t index = 0;
+    if (contentCorpusIndex(id, index)) {
+      bitAssign(index, true);
+    }
+    listAppend(id);
+  }
+  saved.cursor = loaded.cursor < saved.count ? loaded.cursor : 0;
+  saved.only = saved.count > 0 && loaded.only;
+
+  if (stale > 0) {
+    Serial.printf("[Fav] dropped %u favorites this build can't show\n",
+                  static_cast<unsigned>(stale));
+  }
+  if (saved.count != loaded.count || loaded.magic != FAVORITES_MAGIC) {
+    store();
+  }
+}
+
+bool favoritesContains(uint32_t id) {
+  uint16_t index = 0;
+  if (contentKindOf(id) == ContentKind::Corpus) {
+    return contentCorpusIndex(id, index) && bitTest(index);
+  }
+  return listFind(id) >= 0;
+}
+
+FavoriteToggle favoritesToggle(uint32_t id) {
+  uint16_t index = 0;
+  const bool corpus = contentCorpusIndex(id, index);
+  const int position = (!corpus || bitTest(index)) ? listFind(id) : -1;
+
+  if (position < 0) {
+    if (saved.count == FAVORITES_MAX) {
+      return FavoriteToggle::Full;
+    }
+    listAppend(id);
+    if (corpus) {
+      bitAssign(index, true);
+    }
+    store();
+    return FavoriteToggle::Added;
+  }
+
+  // Keep marking order for Next/Prev; at most FAVORITES_MAX - 1 moves.
+  memmove(&saved.ids[position], &saved.ids[position + 1],
+          (saved.count - position - 1) * sizeof(saved.ids[0]));
+  memmove(&textKeys[position], &textKeys[position + 1],
+          (saved.count - position - 1) * sizeof(textKeys[0]));
+  saved.count--;
+  if (corpus) {
+    bitAssign(index, false);
+  }
+  if (saved.cursor > position || saved.cursor >= saved.count) {
+    saved.cursor = saved.cursor > 0 ? saved.cursor - 1 : 0;
+  }
+  if (saved.count == 0) {
+    saved.only = 0;
+  }
+  store();
+  return FavoriteToggle::Removed;
+}
+
+size_t favoritesCount() { return saved.count; }
+
+bool favoritesOnly() { return saved.only && saved.count > 0; }
+
+bool favoritesSetOnly(bool only) {
+  if (only && saved.count == 0) {
+    return false;
+  }
+  if (saved.only != only) {
+    saved.only = only;
+    store();
+  }
+  return true;
+}
+
+uint32_t favoritesRandom(uint32_t avoid) {
+  if (saved.count == 0) {
+    return avoid;
+  }
+  uint32_t pick = esp_random() % saved.count;
+  if (saved.count > 1 && saved.ids[pick] == avoid) {
+    // Any other favorite, still uniform over the rest.
+    pick = (pick + 1 + esp_random() % (saved.count - 1)) % saved.count;
+  }
+  saved.cursor = static_cast<uint16_t>(pick);
+  return saved.ids[pick];
+}
+
+uint32_t favoritesStep(int direction) {
+  if (saved.count == 0) {
+    return 0;
+  }
+  const size_t count = saved.count;
+  saved.cursor = static_cast<uint16_t>(
+      (saved.cursor + count + (direction < 0 ? count - 1 : 1)) % count);
+  return saved.ids[saved.cursor];
+}
+
+// ───────────────── Console ─────────────────
+
+static void printFavorite(size_t position) {
+  const uint32_t id = saved.ids[position];
+  Serial.printf("%c%3u %08lx  ", position == saved.cursor ? '>' : ' ',
+                static_cast<unsigned>(position + 1),
+                static_cast<unsigned long>(id));
+  ContentText content;
+  if (!contentResolve(id, content)) {
+    Serial.println(F("(unavailable)"));
+    return;
+  }
+  char utf8[3];
+  for (size_t i = 0; i < content.length; ++i) {
+    const size_t n =
+        fontCodeToUtf8(static_cast<uint8_t>(content.text[i]), utf8);
+    Serial.write(reinterpret_cast<const uint8_t *>(utf8), n);
+  }
+  Serial.println();
+}
+
+void favoritesCommand(const char *args) {
+  if (strcmp(args, "clear") == 0) {
+    resetState();
+    memset(corpusBits, 0, sizeof(corpusBits));
+    store();
+    Serial.println(F("[Fav] cleared"));
+    return;
+  }
+  if (strncmp(args, "only", 4) == 0) {
+    const char *arg = args + 4;
+    while (*arg == ' ') {
+      ++arg;
+    }
+    bool only = !favoritesOnly();
+    if (strcmp(arg, "on") == 0) {
+      only = true;
+    } else if (strcmp(arg, "off") == 0) {
+      only = false;
+    } else if (*arg != '\0') {
+      Serial.println(F("[Fav] usage: fav [only [on|off]|clear]"));
+      return;
+    }
+    if (!favoritesSetOnly(only)) {
+      Serial.println(F("[Fav] no favorites yet"));
+      return;
+    }
+    Serial.printf("[Fav] favorites-only %s\n", only ? "on" : "off");
+    return;
+  }
+  if (*args != '\0') {
+    Serial.println(F("[Fav] usage: fav [only [on|off]|clear]"));
+    return;
+  }
+
+  Serial.printf("[Fav] %u/%u favorites, favorites-only %s\n",
+                static_cast<unsigned>(saved.count),
+                static_cast<unsigned>(FAVORITES_MAX),
+                favoritesOnly() ? "on" : "off");
+  for (size_t i = 0; i < saved.count; ++i) {
+    printFavorite(i);
+  }
+}
@@ -0,0 +1,87 @@
+#ifndef FAVORITES_H
+#define FAVORITES_H
+
+#include "corpus.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ─── Favorites ──────────────────────────────────────────────────
+//
+// Insults marked at the table (Random long-press) and a favorites-only mode
+// (Prev long-press) in which Random picks a random favorite and Next/Prev
+// walk the favorites in the order they were marked.
+//
+// - list: up to FAVORITES_MAX content ids in marking order. Corpus ids are
+//   text hashes, so favorites survive corpus updates; ones whose insult is
+//   gone are dropped on load, and so are generated ones whose engine changed
+//   (content.h, ContentFingerprint).
+// - membership: a bitset over corpus indices in RAM (8 KB at the 65535-line
+//   maximum), rebuilt from the list at boot. Generated favorites are checked
+//   against the (short) list by contentTextKey(), so two n-gram seeds that
+//   generate the same line are the same favorite.
+//
+// Membership tests and marking are O(1) for corpus ids; generated ids scan
+// the list. Unmarking scans too and closes the gap, at most
+// FAVORITES_MAX - 1 moves, so that Next/Prev keep marking order. The cap is
+// what keeps that bounded.
+//
+// Only the list, the mode and the cursor are persisted: one small NVS blob
+// (20-byte header + 4 bytes per favorite, at most FAVORITES_MAX * 4 + 20)
+// whatever the corpus size, rewritten on each change.
+
+static constexpr size_t FAVORITES_MAX = 128;
+
+enum class FavoriteToggle : uint8_t { Added, Removed, Full };
+
+/**
+ * @brief Load the favorites from NVS and rebuild the membership bitset.
+ */
+void favoritesInit();
+
+/**
+ * @brief Whether `id` is a favorite. O(1) for corpus ids.
+ */
+bool favoritesContains(uint32_t id);
+
+/**
+ * @brief Add `id` to the favorites, or remove it if it already is one.
+ *
+ * Persists immediately. Leaving favorites-only mode happens automatically
+ * when the last favorite is removed. Removing is O(FAVORITES_MAX): the list
+ * stays in marking order.
+ */
+FavoriteToggle favoritesToggle(uint32_t id);
+
+size_t favoritesCount();
+
+/**
+ * @brief Whether Random/Next/Prev are restricted to the favorites.
+ *
+ * Always false while there are no favorites.
+ */
+bool favoritesOnly();
+
+/**
+ * @brief Switch favorites-only mode; ignored (returns false) without
+ * favorites.
+ */
+bool favoritesSetOnly(bool only);
+
+/**
+ * @brief A random favorite, other than `avoid` when there are two or more.
+ */
+uint32_t favoritesRandom(uint32_t avoid);
+
+/**
+ * @brief Step the favorites cursor (+1 = Next, -1 = Prev), wrapping around.
+ *
+ * @return The favorite under the cursor after the step.
+ */
+uint32_t favoritesStep(int direction);
+
+/**
+ * @brief Console handler for "fav [only [on|off]|clear]".
+ */
+void favoritesCommand(const char *args);
+
+#endif // FAVORITES_H
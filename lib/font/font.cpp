@@ -0,0 +1,183 @@
+#include "font.h"
+#include "display.h"
+
+#include <string.h>
+
+static_assert(FONT_HEIGHT <= 32, "glyph rows are decoded into a fixed buffer");
+
+// ───────────────── Bit helpers ─────────────────
+
+/**
+ * @brief Read `count` bits (1..24) from an MSB-first bit stream.
+ *
+ * Loads a 32-bit big-endian window so a whole glyph row comes out in one
+ * go. The result is left-aligned (first pixel in bit 31). The pack step pads
+ * the bitmap blob so the window never reads past the array.
+ */
+static inline uint32_t readBits(const uint8_t *stream, uint32_t bitPos,
+                                uint8_t count) {
+  const uint8_t *p = stream + (bitPos >> 3);
+  uint32_t window = (static_cast<uint32_t>(p[0]) << 24) |
+                    (static_cast<uint32_t>(p[1]) << 16) |
+                    (static_cast<uint32_t>(p[2]) << 8) |
+                    static_cast<uint32_t>(p[3]);
+  window <<= (bitPos & 7);
+  return window & ~(0xFFFFFFFFu >> count);
+}
+
+/**
+ * @brief Left-aligned mask with `count` (1..32) leading ones.
+ */
+static inline uint32_t leadingMask(uint8_t count) {
+  return count >= 32 ? 0xFFFFFFFFu : ~(0xFFFFFFFFu >> count);
+}
+
+/**
+ * @brief Unpack a glyph into left-aligned row masks (one word per row).
+ */
+static void decodeRows(const FontGlyph &glyph, uint32_t rows[FONT_HEIGHT]) {
+  const uint8_t *data = fontBitmaps + glyph.offset;
+  const uint8_t width = glyph.width;
+
+  if (width == 0) {
+    memset(rows, 0, sizeof(uint32_t) * FONT_HEIGHT);
+    return;
+  }
+
+  if (glyph.encoding == GlyphEncoding::Raw) {
+    for (uint8_t r = 0; r < FONT_HEIGHT; ++r) {
+      rows[r] = readBits(data, static_cast<uint32_t>(r) * width, width);
+    }
+    return;
+  }
+
+  // RLE: alternating paper/ink runs, one nibble each.
+  memset(rows, 0, sizeof(uint32_t) * FONT_HEIGHT);
+  const uint16_t total = static_cast<uint16_t>(width) * FONT_HEIGHT;
+  uint16_t pixel = 0;
+  uint16_t nibble = 0;
+  bool ink = false;
+
+  while (pixel < total) {
+    const uint8_t byte = data[nibble >> 1];
+    uint8_t run = (nibble & 1) ? (byte & 0x0F) : (byte >> 4);
+    nibble++;
+
+    if (ink) {
+      while (run > 0 && pixel < total) {
+        const uint8_t r = static_cast<uint8_t>(pixel / width);
+        const uint8_t c = static_cast<uint8_t>(pixel % width);
+        const uint8_t span = (run < width - c) ? run : (width - c);
+        rows[r] |= leadingMask(span) >> c;
+        pixel += span;
+        run -= span;
+      }
+    } else {
+      pixel += run;
+    }
+    ink = !ink;
+  }
+}
+
+/**
+ * @brief Stretch a left-aligned row mask horizontally by `scale`.
+ */
+static inline uint32_t scaleRow(uint32_t bits, uint8_t width, uint8_t scale) {
+  if (scale == 1 || bits == 0) {
+    return bits;
+  }
+  const uint32_t run = leadingMask(scale);
+  uint32_t out = 0;
+  for (uint8_t c = 0; c < width; ++c) {
+    if (bits & (0x80000000u >> c)) {
+      out |= run >> (c * scale);
+    }
+  }
+  return out;
+}
+
+// ───────────────── API ─────────────────
+
+/**
+ * @brief Encode a codepage byte as UTF-8 (for Serial output only).
+ */
+size_t fontCodeToUtf8(uint8_t code, char out[3]) {
+  if (code < FONT_FIRST_CODE || code > FONT_LAST_CODE) {
+    return 0;
+  }
+  const uint16_t cp = fontCodepage[code - FONT_FIRST_CODE];
+  if (cp == 0) {
+    return 0;
+  }
+  if (cp < 0x80) {
+    out[0] = static_cast<char>(cp);
+    return 1;
+  }
+  if (cp < 0x800) {
+    out[0] = static_cast<char>(0xC0 | (cp >> 6));
+    out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  out[0] = static_cast<char>(0xE0 | (cp >> 12));
+  out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+  out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+  return 3;
+}
+
+/**
+ * @brief Draw one glyph into the framebuffer.
+ *
+ * Each (scaled) glyph row is a single left-aligned word; it lands in the
+ * framebuffer as at most two OR operations (shift right into the first
+ * word, shift left into the next). Rows and words past the panel are
+ * clipped.
+ */
+uint16_t fontDrawGlyph(const FontGlyph &glyph, uint16_t x, uint16_t y,
+                       uint8_t scale) {
+  uint32_t rows[FONT_HEIGHT];
+  decodeRows(glyph, rows);
+
+  const size_t word = x >> 5;
+  const uint8_t shift = x & 31;
+
+  for (uint8_t r = 0; r < FONT_HEIGHT; ++r) {
+    const uint32_t bits = scaleRow(rows[r], glyph.width, scale);
+    if (bits == 0) {
+      continue;
+    }
+
+    for (uint8_t sy = 0; sy < scale; ++sy) {
+      const uint32_t py = y + static_cast<uint32_t>(r) * scale + sy;
+      if (py >= PANEL_HEIGHT) {
+        break;
+      }
+      uint32_t *row = displayFramebuffer[py];
+      if (word < DISPLAY_WORDS_PER_ROW) {
+        row[word] |= bits >> shift;
+      }
+      if (shift != 0 && word + 1 < DISPLAY_WORDS_PER_ROW) {
+        row[word + 1] |= bits << (32 - shift);
+      }
+    }
+  }
+
+  return static_cast<uint16_t>((glyph.width + FONT_SPACING) * scale);
+}
+
+/**
+ * @brief Draw a run of codepage text into the framebuffer.
+ */
+uint16_t fontDrawText(const char *text, size_t length, uint16_t x, uint16_t y,
+                      uint8_t scale) {
+  uint16_t advance = 0;
+
+  for (size_t i = 0; i < length; ++i) {
+    const FontGlyph *glyph = fontGlyphFor(static_cast<uint8_t>(text[i]));
+    if (glyph == nullptr || glyph->width == 0) {
+      continue;
+    }
+    advance += fontDrawGlyph(*glyph, static_cast<uint16_t>(x + advance), y,
+                             scale);
+  }
+  return advance;
+}
@@ -0,0 +1,84 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Generated at build time by scripts/pack_corpus.py (glyph count + metrics).
+#include "font_gen.h"
+
+// ─── Codepage ───────────────────────────────────────────────────
+//
+// Corpus text is stored as one byte per character: 0x20..0x7E are ASCII,
+// 0x80.. are the non-ASCII characters the corpus uses, assigned at pack
+// time. A byte indexes fontGlyphs[] directly; nothing decodes UTF-8 at
+// runtime. fontCodepage[] maps back to Unicode for Serial logging.
+
+// ─── Packed glyphs (flash) ──────────────────────────────────────
+//
+// Raw: the glyph's pixels as one MSB-first bit stream, row after row.
+// Rle: 4-bit run lengths alternating paper/ink, starting with paper.
+// See scripts/bardpack/fontpack.py for the exact encoding.
+enum class GlyphEncoding : uint8_t { Raw = 0, Rle };
+
+struct FontGlyph {
+  uint16_t offset; // into fontBitmaps[]
+  uint8_t width;   // pixels at scale 1 (advance = width + FONT_SPACING)
+  GlyphEncoding encoding;
+};
+
+extern const uint8_t fontBitmaps[];
+extern const uint16_t fontCodepage[];
+extern const FontGlyph fontGlyphs[];
+
+// ─── API ────────────────────────────────────────────────────────
+
+/**
+ * @brief Glyph for a codepage byte (direct table index).
+ *
+ * @return The glyph, or nullptr if the byte is outside the codepage.
+ */
+inline const FontGlyph *fontGlyphFor(uint8_t code) {
+  if (code < FONT_FIRST_CODE || code > FONT_LAST_CODE) {
+    return nullptr;
+  }
+  return &fontGlyphs[code - FONT_FIRST_CODE];
+}
+
+/**
+ * @brief Encode a codepage byte as UTF-8 (for Serial output only).
+ *
+ * @param code Codepage byte.
+ * @param out Receives 1..3 bytes.
+ * @return Number of bytes written; 0 if the byte is unused.
+ */
+size_t fontCodeToUtf8(uint8_t code, char out[3]);
+
+/**
+ * @brief Draw one glyph into the framebuffer, 32 pixels at a time.
+ *
+ * @param glyph Glyph from fontGlyphFor().
+ * @param x Left edge in pixels.
+ * @param y Top of the glyph cell in pixels.
+ * @param scale Integer scale (1 = native size).
+ * @return Horizontal advance in pixels (including spacing).
+ */
+uint16_t fontDrawGlyph(const FontGlyph &glyph, uint16_t x, uint16_t y,
+                       uint8_t scale);
+
+/**
+ * @brief Draw a run of codepage text into the framebuffer.
+ *
+ * Bytes outside the codepage are skipped.
+ *
+ * @param text Codepage text (not necessarily NUL-terminated).
+ * @param length Bytes to draw.
+ * @param x Left edge in pixels.
+ * @param y Top of the text row in pixels.
+ * @param scale Integer scale (1 = native size).
+ * @return Total advance in pixels.
+ */
+uint16_t fontDrawText(const char *text, size_t length, uint16_t x, uint16_t y,
+                      uint8_t scale);
+
+#endif // FONT_H
@@ -0,0 +1,98 @@
+#include "governor.h"
+
+/**
+ * @brief Idle time (ms) at which `level` starts; UINT32_MAX if disabled.
+ */
+static uint32_t levelStartsAfter(const GovernorConfig &config,
+                                 PowerLevel level) {
+  uint32_t after = 0;
+  switch (level) {
+  case PowerLevel::LightSleep:
+    after = config.lightSleepAfterMs;
+    break;
+  case PowerLevel::DeepSleep:
+    after = config.deepSleepAfterMs;
+    break;
+  default:
+    return 0;
+  }
+  return after == 0 ? UINT32_MAX : after;
+}
+
+/**
+ * @brief Start in Active with `now` as the last activity.
+ */
+void governorInit(GovernorState &state, uint32_t now) {
+  state.lastActivityAt = now;
+  state.level = PowerLevel::Active;
+}
+
+/**
+ * @brief Record user activity (button event, console input).
+ */
+void governorNoteActivity(GovernorState &state, uint32_t now) {
+  state.lastActivityAt = now;
+  state.level = PowerLevel::Active;
+}
+
+/**
+ * @brief Advance the governor.
+ *
+ * Levels only depend on idle time, so a step that lands past several
+ * thresholds (e.g. after a long light sleep) goes straight to the highest.
+ */
+PowerLevel governorStep(const GovernorConfig &config, GovernorState &state,
+                        uint32_t now, bool busy) {
+  if (busy) {
+    governorNoteActivity(state, now);
+    return state.level;
+  }
+
+  const uint32_t idleMs = now - state.lastActivityAt;
+  PowerLevel level = PowerLevel::Active;
+  if (idleMs >= levelStartsAfter(config, PowerLevel::DeepSleep)) {
+    level = PowerLevel::DeepSleep;
+  } else if (idleMs >= levelStartsAfter(config, PowerLevel::LightSleep)) {
+    level = PowerLevel::LightSleep;
+  }
+  state.level = level;
+  return level;
+}
+
+/**
+ * @brief Milliseconds from `now` until the next escalation.
+ */
+uint32_t governorMsUntilNextLevel(const GovernorConfig &config,
+                                  const GovernorState &state, uint32_t now) {
+  const uint32_t idleMs = now - state.lastActivityAt;
+  uint32_t next = UINT32_MAX;
+  const PowerLevel levels[] = {PowerLevel::LightSleep, PowerLevel::DeepSleep};
+  for (PowerLevel level : levels) {
+    const uint32_t after = levelStartsAfter(config, level);
+    if (after == UINT32_MAX || level <= state.level) {
+      continue;
+    }
+    const uint32_t wait = idleMs >= after ? 0 : after - idleMs;
+    if (wait < next) {
+      next = wait;
+    }
+  }
+  return next;
+}
+
+/**
+ * @brief Short name for logs ("active", "light", "deep").
+ */
+const char *governorLevelName(PowerLevel level) {
+  switch (level) {
+  case PowerLevel::Active:
+    return "active";
+  case PowerLevel::LightSleep:
+    return "light";
+  case PowerLevel::DeepSleep:
+    return "deep";
+  case PowerLevel::Count:
+    break;
+  }
+  return "?";
+}
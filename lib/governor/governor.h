@@ -0,0 +1,57 @@
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <stdint.h>
+
+// ─── Inactivity governor ────────────────────────────────────────
+//
+// Escalates Active → LightSleep → DeepSleep as input-free time passes. Pure
+// logic on a caller-supplied millisecond clock (no Arduino/ESP-IDF calls), so
+// the same step function drives the firmware and host-side simulations.
+
+enum class PowerLevel : uint8_t { Active = 0, LightSleep, DeepSleep, Count };
+
+struct GovernorConfig {
+  uint32_t lightSleepAfterMs; // idle time before light sleep (0 = never)
+  uint32_t deepSleepAfterMs;  // idle time before deep sleep (0 = never)
+};
+
+struct GovernorState {
+  uint32_t lastActivityAt; // ms
+  PowerLevel level;        // result of the last step
+};
+
+/**
+ * @brief Start in Active with `now` as the last activity.
+ */
+void governorInit(GovernorState &state, uint32_t now);
+
+/**
+ * @brief Record user activity (button event, console input).
+ */
+void governorNoteActivity(GovernorState &state, uint32_t now);
+
+/**
+ * @brief Advance the governor.
+ *
+ * @param busy True while the app can't sleep (boot splash, operation in
+ * progress, sleep gesture armed, button held); counts as activity.
+ * @return The level the device should be at now.
+ */
+PowerLevel governorStep(const GovernorConfig &config, GovernorState &state,
+                        uint32_t now, bool busy);
+
+/**
+ * @brief Milliseconds from `now` until the next escalation.
+ *
+ * @return 0 if it is due now, UINT32_MAX if there is none.
+ */
+uint32_t governorMsUntilNextLevel(const GovernorConfig &config,
+                                  const GovernorState &state, uint32_t now);
+
+/**
+ * @brief Short name for logs ("active", "light", "deep").
+ */
+const char *governorLevelName(PowerLevel level);
+
+#endif // GOVERNOR_H
@@ -0,0 +1,349 @@
+#include "grammar.h"
+
+// ───────────────── Word tables ─────────────────
+//
+// Add words freely; the sentence count, the longest sentence and the
+// character set are all checked below at compile time. Editing a table
+// changes which sentence an index means; grammarTableHash() changes with
+// it, so ids saved by an older build are dropped instead of showing other
+// lines.
+
+struct GrammarSlot {
+  const char *const *words;
+  uint16_t count;
+};
+
+struct GrammarTemplate {
+  const char *pattern; // "{}" marks a slot, filled in order
+  const GrammarSlot *slots;
+  uint8_t slotCount;
+};
+
+template <typename T, size_t N> constexpr uint16_t countOf(const T (&)[N]) {
+  return static_cast<uint16_t>(N);
+}
+
+static constexpr const char *const VERBS[] = {
+    "fight", "sing", "dance", "smell", "argue", "sail", "duel", "flirt",
+};
+
+static constexpr const char *const ADJECTIVES[] = {
+    "a scurvy",       "a mangy",        "a flea-bitten",   "a lily-livered",
+    "a bilge-soaked", "a weak-kneed",   "a pox-marked",    "a beef-witted",
+    "a clay-brained", "a dim-witted",   "a half-drowned",  "a moth-eaten",
+    "a rump-fed",     "a slack-jawed",  "a toad-spotted",  "a yeasty",
+    "a milk-livered", "a fat-kidneyed", "a reeling-ripe",  "a tottering",
+    "a gorbellied",   "a craven",       "a dankish",       "a wart-nosed",
+    "a puny",         "a soggy",        "an addle-pated",  "an onion-eyed",
+    "an unwashed",    "an ill-bred",    "an idle-headed",  "an earth-vexing",
+};
+
+static constexpr const char *const CREATURES[] = {
+    "dairy farmer", "troll",      "sewer rat",  "bilge rat",  "goat",
+    "turnip",       "barnacle",   "codfish",    "jellyfish",  "scullion",
+    "haggis",       "mushroom",   "wharf rat",  "lobster",    "pigeon",
+    "clotpole",     "hedge-pig",  "lout",       "scarecrow",  "sea slug",
+    "donkey",       "bog hermit", "mule",       "ratcatcher", "tavern mop",
+    "mackerel",     "cabbage",    "parrot",     "weasel",     "toad",
+    "warthog",      "landlubber",
+};
+
+static constexpr const char *const CIRCUMSTANCES[] = {
+    "from Tortuga",     "in a hurricane",   "after a long voyage",
+    "with a wooden leg", "on a Tuesday",    "at low tide",
+    "in a barrel",      "with a head cold", "in borrowed boots",
+    "at a funeral",     "after three pints", "in a rowboat",
+    "with no map",      "on a greased deck", "in the dark",
+    "with a hangover",  "from the bilges",  "in a fog",
+    "on fire",          "with one oar",     "at a wedding",
+    "in a sack",        "underwater",       "on stilts",
+    "in the rain",      "with a limp",      "in a tutu",
+    "at dawn",          "in a sulk",        "mid-sneeze",
+    "in the stocks",    "without a paddle",
+};
+
+static constexpr const char *const QUALITIES[] = {
+    "manners",  "wit",          "charm",         "grace",
+    "courage",  "breath",       "table manners", "sense of direction",
+    "swordplay", "singing voice", "hygiene",     "fashion sense",
+    "memory",   "cunning",      "poise",         "conversation",
+};
+
+static constexpr const char *const BELONGINGS[] = {
+    "sword arm", "singing", "breath",    "beard",
+    "cooking",   "poetry",  "dancing",   "ship",
+    "hat",       "swagger", "laugh",     "boots",
+    "footwork",  "pet parrot", "battle cry", "seamanship",
+};
+
+static constexpr GrammarSlot SLOTS_FIGHT_LIKE[] = {
+    {VERBS, countOf(VERBS)},
+    {ADJECTIVES, countOf(ADJECTIVES)},
+    {CREATURES, countOf(CREATURES)},
+    {CIRCUMSTANCES, countOf(CIRCUMSTANCES)},
+};
+static constexpr GrammarSlot SLOTS_HAVE_THE[] = {
+    {QUALITIES, countOf(QUALITIES)},
+    {ADJECTIVES, countOf(ADJECTIVES)},
+    {CREATURES, countOf(CREATURES)},
+};
+static constexpr GrammarSlot SLOTS_MET_BETTER[] = {
+    {ADJECTIVES, countOf(ADJECTIVES)},
+    {CREATURES, countOf(CREATURES)},
+    {QUALITIES, countOf(QUALITIES)},
+};
+static constexpr GrammarSlot SLOTS_WOULD_SHAME[] = {
+    {BELONGINGS, countOf(BELONGINGS)},
+    {ADJECTIVES, countOf(ADJECTIVES)},
+    {CREATURES, countOf(CREATURES)},
+};
+
+static constexpr GrammarTemplate TEMPLATES[] = {
+    {"You {} like {} {} {}.", SLOTS_FIGHT_LIKE, countOf(SLOTS_FIGHT_LIKE)},
+    {"You have the {} of {} {}.", SLOTS_HAVE_THE, countOf(SLOTS_HAVE_THE)},
+    {"I've met {} {} with more {} than you.", SLOTS_MET_BETTER,
+     countOf(SLOTS_MET_BETTER)},
+    {"Your {} would shame {} {}.", SLOTS_WOULD_SHAME,
+     countOf(SLOTS_WOULD_SHAME)},
+};
+static constexpr size_t TEMPLATE_COUNT = countOf(TEMPLATES);
+
+// ───────────────── Compile-time checks ─────────────────
+
+constexpr size_t textLength(const char *s) {
+  return *s == '\0' ? 0 : 1 + textLength(s + 1);
+}
+
+constexpr bool isPrintableAscii(const char *s) {
+  return *s == '\0' ||
+         (*s >= 0x20 && *s <= 0x7E && isPrintableAscii(s + 1));
+}
+
+constexpr size_t placeholderCount(const char *s) {
+  return *s == '\0' ? 0
+         : (s[0] == '{' && s[1] == '}') ? 1 + placeholderCount(s + 2)
+                                        : placeholderCount(s + 1);
+}
+
+constexpr size_t longer(size_t a, size_t b) { return a > b ? a : b; }
+
+constexpr size_t longestWord(const char *const *words, size_t n) {
+  return n == 0 ? 0
+                : longer(textLength(words[0]), longestWord(words + 1, n - 1));
+}
+
+constexpr bool wordsValid(const char *const *words, size_t n) {
+  return n == 0 || (isPrintableAscii(words[0]) && textLength(words[0]) > 0 &&
+                    wordsValid(words + 1, n - 1));
+}
+
+constexpr uint64_t slotProduct(const GrammarSlot *slots, size_t n) {
+  return n == 0 ? 1 : slots[0].count * slotProduct(slots + 1, n - 1);
+}
+
+constexpr size_t slotWordsLength(const GrammarSlot *slots, size_t n) {
+  return n == 0 ? 0
+                : longestWord(slots[0].words, slots[0].count) +
+                      slotWordsLength(slots + 1, n - 1);
+}
+
+constexpr bool slotsValid(const GrammarSlot *slots, size_t n) {
+  return n == 0 || (slots[0].count > 0 &&
+                    wordsValid(slots[0].words, slots[0].count) &&
+                    slotsValid(slots + 1, n - 1));
+}
+
+constexpr size_t templateMaxLength(const GrammarTemplate &t) {
+  return textLength(t.pattern) - 2 * t.slotCount +
+         slotWordsLength(t.slots, t.slotCount);
+}
+
+constexpr bool templatesValid(const GrammarTemplate *t, size_t n) {
+  return n == 0 ||
+         (isPrintableAscii(t[0].pattern) &&
+          placeholderCount(t[0].pattern) == t[0].slotCount &&
+          slotsValid(t[0].slots, t[0].slotCount) &&
+          templateMaxLength(t[0]) < GRAMMAR_TEXT_CAPACITY &&
+          templatesValid(t + 1, n - 1));
+}
+
+constexpr uint64_t totalSentences(const GrammarTemplate *t, size_t n) {
+  return n == 0 ? 0
+                : slotProduct(t[0].slots, t[0].slotCount) +
+                      totalSentences(t + 1, n - 1);
+}
+
+static_assert(templatesValid(TEMPLATES, TEMPLATE_COUNT),
+              "grammar: placeholder/slot mismatch, empty table, non-ASCII "
+              "text, or a sentence longer than GRAMMAR_TEXT_CAPACITY");
+
+static constexpr uint64_t SENTENCE_COUNT =
+    totalSentences(TEMPLATES, TEMPLATE_COUNT);
+static_assert(SENTENCE_COUNT > 0 && SENTENCE_COUNT < (1UL << 28),
+              "grammar: sentence indices must fit a 28-bit content id");
+
+// ───────────────── Table hash ─────────────────
+//
+// FNV-1a over every template pattern and its slots' words, NUL-terminated.
+
+constexpr uint32_t hashByte(uint32_t h, uint8_t b) {
+  return static_cast<uint32_t>((h ^ b) * 0x01000193UL);
+}
+
+constexpr uint32_t hashText(const char *s, uint32_t h) {
+  return *s == '\0' ? hashByte(h, 0)
+                    : hashText(s + 1, hashByte(h, static_cast<uint8_t>(*s)));
+}
+
+constexpr uint32_t hashWords(const char *const *words, size_t n, uint32_t h) {
+  return n == 0 ? h : hashWords(words + 1, n - 1, hashText(words[0], h));
+}
+
+constexpr uint32_t hashSlots(const GrammarSlot *slots, size_t n, uint32_t h) {
+  return n == 0 ? h
+                : hashSlots(slots + 1, n - 1,
+                            hashWords(slots[0].words, slots[0].count,
+                                      hashByte(h, 0)));
+}
+
+constexpr uint32_t hashTemplates(const GrammarTemplate *t, size_t n,
+                                 uint32_t h) {
+  return n == 0 ? h
+                : hashTemplates(t + 1, n - 1,
+                                hashSlots(t[0].slots, t[0].slotCount,
+                                          hashText(t[0].pattern, h)));
+}
+
+static constexpr uint32_t TABLE_HASH =
+    hashTemplates(TEMPLATES, TEMPLATE_COUNT, 0x811C9DC5UL);
+
+// ───────────────── Decoding ─────────────────
+
+uint32_t grammarSentenceCount() {
+  return static_cast<uint32_t>(SENTENCE_COUNT);
+}
+
+uint32_t grammarTableHash() { return TABLE_HASH; }
+
+/**
+ * @brief Write sentence `index` into `out` (NUL-terminated).
+ *
+ * The template is found by subtracting template sizes; the remainder's
+ * mixed-radix digits (last slot least significant) pick the words.
+ */
+size_t grammarExpand(uint32_t index, char *out, size_t capacity) {
+  if (capacity == 0) {
+    return 0;
+  }
+
+  const GrammarTemplate *t = TEMPLATES;
+  const GrammarTemplate *const end = TEMPLATES + TEMPLATE_COUNT;
+  for (; t != end; ++t) {
+    const uint32_t size =
+        static_cast<uint32_t>(slotProduct(t->slots, t->slotCount));
+    if (index < size) {
+      break;
+    }
+    index -= size;
+  }
+  if (t == end) {
+    return 0;
+  }
+
+  // Peel digits off from the last slot so the words come out in pattern
+  // order below.
+  uint16_t digits[8];
+  static_assert(sizeof(digits) / sizeof(digits[0]) >= 4,
+                "grammar: raise the digit buffer for longer templates");
+  if (t->slotCount > sizeof(digits) / sizeof(digits[0])) {
+    return 0;
+  }
+  for (size_t s = t->slotCount; s-- > 0;) {
+    digits[s] = static_cast<uint16_t>(index % t->slots[s].count);
+    index /= t->slots[s].count;
+  }
+
+  size_t length = 0;
+  size_t slot = 0;
+  for (const char *p = t->pattern; *p != '\0'; ++p) {
+    const char *piece = p;
+    size_t pieceLength = 1;
+    if (p[0] == '{' && p[1] == '}') {
+      piece = t->slots[slot].words[digits[slot]];
+      pieceLength = textLength(piece);
+      slot++;
+      p++;
+    }
+    if (length + pieceLength >= capacity) {
+      out[0] = '\0';
+      return 0;
+    }
+    for (size_t i = 0; i < pieceLength; ++i) {
+      out[length++] = piece[i];
+    }
+  }
+  out[length] = '\0';
+  return length;
+}
+
+// ───────────────── Permutation ─────────────────
+
+constexpr uint8_t bitsFor(uint64_t n) {
+  return n <= 1 ? 0 : 1 + bitsFor((n + 1) / 2);
+}
+
+// Feistel halves: the permuted domain is 2^(2*HALF_BITS), at most 4x the
+// sentence count, so cycle walking takes < 4 rounds on average.
+static constexpr uint8_t HALF_BITS = (bitsFor(SENTENCE_COUNT) + 1) / 2;
+static constexpr uint32_t HALF_MASK = (1UL << HALF_BITS) - 1;
+static constexpr uint8_t FEISTEL_ROUNDS = 4;
+
+static uint32_t mix32(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x85EBCA6BUL;
+  x ^= x >> 13;
+  x *= 0xC2B2AE35UL;
+  x ^= x >> 16;
+  return x;
+}
+
+/**
+ * @brief Keyed bijection on 0..2^(2*HALF_BITS)-1.
+ */
+static uint32_t feistel(uint32_t x, uint32_t key) {
+  uint32_t left = x >> HALF_BITS;
+  uint32_t right = x & HALF_MASK;
+  for (uint8_t round = 0; round < FEISTEL_ROUNDS; ++round) {
+    const uint32_t next =
+        left ^ (mix32(right ^ key ^ (round * 0x9E3779B9UL)) & HALF_MASK);
+    left = right;
+    right = next;
+  }
+  return (left << HALF_BITS) | right;
+}
+
+void grammarDeckShuffle(GrammarDeck &deck, uint32_t key) {
+  deck.key = key;
+  deck.position = 0;
+}
+
+/**
+ * @brief Draw the next sentence index; no index repeats within one order.
+ *
+ * Cycle walking: re-apply the permutation until the value lands inside
+ * 0..count-1. Restricted that way it is still a bijection on the sentences.
+ */
+bool grammarDeckDraw(GrammarDeck &deck, uint32_t &outIndex) {
+  const uint32_t count = grammarSentenceCount();
+  if (deck.position >= count) {
+    return false;
+  }
+
+  uint32_t x = deck.position++;
+  do {
+    x = feistel(x, deck.key);
+  } while (x >= count);
+
+  outIndex = x;
+  return true;
+}
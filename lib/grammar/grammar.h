@@ -0,0 +1,71 @@
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ─── Template grammar ───────────────────────────────────────────
+//
+// Sentences like "You fight like {} {} {}." filled from small word tables.
+// Every sentence has an index in 0..grammarSentenceCount()-1: the template is
+// picked by cumulative size, then the rest of the index is read as a
+// mixed-radix number whose digits pick one word per slot. The tables are
+// constexpr (flash), decoding is O(slots) and allocates nothing.
+//
+// Text is printable ASCII, which the font codepage maps 1:1.
+
+// Enough for the longest sentence plus NUL (checked at compile time).
+static constexpr size_t GRAMMAR_TEXT_CAPACITY = 128;
+
+/**
+ * @brief No-repeat draw order over all sentences, without a deck array.
+ *
+ * A keyed permutation of 0..count-1 (Feistel network + cycle walking):
+ * `position` counts draws, `key` picks the order. 8 bytes, so it fits in RTC
+ * memory however many sentences there are.
+ */
+struct GrammarDeck {
+  uint32_t key;
+  uint32_t position;
+};
+
+/**
+ * @brief Number of distinct sentences the grammar can produce.
+ */
+uint32_t grammarSentenceCount();
+
+/**
+ * @brief Hash of the templates and word tables (FNV-1a, compile time).
+ *
+ * Changes whenever a table does; sentence indices saved under another hash
+ * may name other sentences and should be dropped.
+ */
+uint32_t grammarTableHash();
+
+/**
+ * @brief Write sentence `index` into `out` (NUL-terminated).
+ *
+ * @param index Sentence index (0..grammarSentenceCount()-1).
+ * @param out Receives the text.
+ * @param capacity Size of `out`; GRAMMAR_TEXT_CAPACITY always suffices.
+ * @return Length without the NUL, or 0 if the index is out of range or the
+ * text doesn't fit.
+ */
+size_t grammarExpand(uint32_t index, char *out, size_t capacity);
+
+/**
+ * @brief Start a new draw order.
+ *
+ * @param deck Deck to reset.
+ * @param key Random key; each key gives a different order.
+ */
+void grammarDeckShuffle(GrammarDeck &deck, uint32_t key);
+
+/**
+ * @brief Draw the next sentence index; no index repeats within one order.
+ *
+ * @return false once every sentence has been drawn (shuffle again).
+ */
+bool grammarDeckDraw(GrammarDeck &deck, uint32_t &outIndex);
+
+#endif // GRAMMAR_H
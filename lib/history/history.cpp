@@ -0,0 +1,290 @@
+#include "history.h"
+#include "clock.h"
+#include "energy.h"
+#include "persist_keys.h"
+#include "trace.h"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <string.h>
+
+// Block layout: absolute block number, then the ids; all u32 LE.
+static constexpr size_t BLOCK_HEADER_BYTES = 4;
+static constexpr size_t BLOCK_BYTES =
+    BLOCK_HEADER_BYTES + HISTORY_BLOCK_ENTRIES * 4;
+
+static_assert(HISTORY_SPILL_BLOCKS <= 100, "block keys are h00..h99");
+
+static constexpr const char *HISTORY_NVS_KEY = "hist";
+static constexpr uint32_t HISTORY_SAVE_VERSION = 2;
+
+// ───────────────── State ─────────────────
+
+// RTC_DATA_ATTR values survive deep sleep resets, but NOT power cycles.
+static RTC_DATA_ATTR uint32_t window[HISTORY_WINDOW] = {0};
+static RTC_DATA_ATTR size_t windowHead = 0; // next write
+static RTC_DATA_ATTR size_t windowSize = 0;
+
+// Spilled blocks: absolute numbers spillFirst .. spillFirst+spillCount-1,
+// block n stored under key h<n % HISTORY_SPILL_BLOCKS>.
+static RTC_DATA_ATTR uint32_t spillFirst = 0;
+static RTC_DATA_ATTR size_t spillCount = 0;
+
+// Last block read back (RAM).
+static uint8_t cachedBlock[BLOCK_BYTES];
+static uint32_t cachedBlockNumber = 0;
+static bool cacheValid = false;
+
+// What historySave() writes: bookkeeping + window, oldest first.
+struct HistorySaved {
+  uint32_t version;
+  uint32_t spillFirst;
+  uint16_t spillCount;
+  uint16_t windowSize;
+  uint32_t window[HISTORY_WINDOW];
+};
+
+// ───────────────── Layout ─────────────────
+
+static void blockKey(uint32_t blockNumber, char *key) {
+  const uint32_t slot = blockNumber % HISTORY_SPILL_BLOCKS;
+  key[0] = 'h';
+  key[1] = static_cast<char>('0' + slot / 10);
+  key[2] = static_cast<char>('0' + slot % 10);
+  key[3] = '\0';
+}
+
+static uint32_t windowAt(size_t logical) {
+  return window[(windowHead + HISTORY_WINDOW - windowSize + logical) %
+                HISTORY_WINDOW];
+}
+
+static void putU32(uint8_t *out, uint32_t value) {
+  for (size_t i = 0; i < 4; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+static uint32_t getU32(const uint8_t *in) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    value |= static_cast<uint32_t>(in[i]) << (8 * i);
+  }
+  return value;
+}
+
+/**
+ * @brief Lay out the window's oldest HISTORY_BLOCK_ENTRIES ids as a block.
+ */
+static void encodeBlock(uint32_t blockNumber, uint8_t *out) {
+  putU32(out, blockNumber);
+  for (size_t i = 0; i < HISTORY_BLOCK_ENTRIES; ++i) {
+    putU32(out + BLOCK_HEADER_BYTES + 4 * i, windowAt(i));
+  }
+}
+
+// ───────────────── Flash tier ─────────────────
+
+static bool loadBlock(uint32_t blockNumber) {
+  if (cacheValid && cachedBlockNumber == blockNumber) {
+    return true;
+  }
+  cacheValid = false;
+
+  TRACE_SCOPE(TraceId::NvsRead);
+  ClockBoost boost;
+  Preferences prefs;
+  if (!prefs.begin(NVS_NS, true)) {
+    return false;
+  }
+  char key[4];
+  blockKey(blockNumber, key);
+  const bool ok = prefs.getBytesLength(key) == BLOCK_BYTES &&
+                  prefs.getBytes(key, cachedBlock, BLOCK_BYTES) == BLOCK_BYTES;
+  prefs.end();
+
+  if (!ok || getU32(cachedBlock) != blockNumber) {
+    return false;
+  }
+  cachedBlockNumber = blockNumber;
+  cacheValid = true;
+  return true;
+}
+
+/**
+ * @brief Move the window's oldest block to NVS.
+ *
+ * If the write fails, everything older than the window is dropped instead,
+ * so logical positions stay contiguous.
+ */
+static void spillOldestBlock() {
+  const uint32_t blockNumber = spillFirst + static_cast<uint32_t>(spillCount);
+  uint8_t block[BLOCK_BYTES];
+  encodeBlock(blockNumber, block);
+
+  bool written = false;
+  {
+    TRACE_SCOPE(TraceId::NvsWrite);
+    ClockBoost boost;
+    Preferences prefs;
+    if (prefs.begin(NVS_NS, false)) {
+      char key[4];
+      blockKey(blockNumber, key);
+      written = prefs.putBytes(key, block, BLOCK_BYTES) == BLOCK_BYTES;
+      prefs.end();
+      energyNoteFlashWrite();
+    }
+  }
+
+  if (!written) {
+    Serial.println(F("[History] spill failed; older entries dropped"));
+    spillFirst = blockNumber + 1;
+    spillCount = 0;
+  } else if (spillCount == HISTORY_SPILL_BLOCKS) {
+    spillFirst++; // overwrote the oldest block's key
+  } else {
+    spillCount++;
+  }
+  windowSize -= HISTORY_BLOCK_ENTRIES;
+}
+
+// ───────────────── API ─────────────────
+
+void historyReset() {
+  windowHead = 0;
+  windowSize = 0;
+  spillFirst = 0;
+  spillCount = 0;
+  cacheValid = false;
+}
+
+size_t historyCount() {
+  return spillCount * HISTORY_BLOCK_ENTRIES + windowSize;
+}
+
+bool historyGetAtLogical(size_t logicalPos, uint32_t &outId) {
+  const size_t spilled = spillCount * HISTORY_BLOCK_ENTRIES;
+  if (logicalPos >= spilled + windowSize) {
+    return false;
+  }
+  if (logicalPos >= spilled) {
+    outId = windowAt(logicalPos - spilled);
+    return true;
+  }
+
+  const uint32_t blockNumber =
+      spillFirst + static_cast<uint32_t>(logicalPos / HISTORY_BLOCK_ENTRIES);
+  if (!loadBlock(blockNumber)) {
+    return false;
+  }
+  outId = getU32(cachedBlock + BLOCK_HEADER_BYTES +
+                 4 * (logicalPos % HISTORY_BLOCK_ENTRIES));
+  return true;
+}
+
+void historyAppend(uint32_t id) {
+  if (windowSize == HISTORY_WINDOW) {
+    spillOldestBlock();
+  }
+  window[windowHead] = id;
+  windowHead = (windowHead + 1) % HISTORY_WINDOW;
+  windowSize++;
+}
+
+size_t historyRetain(bool (*keep)(uint32_t id), size_t &position) {
+  uint32_t oldWindow[HISTORY_WINDOW];
+  const size_t oldWindowSize = windowSize;
+  for (size_t i = 0; i < oldWindowSize; ++i) {
+    oldWindow[i] = windowAt(i);
+  }
+  const uint32_t oldFirst = spillFirst;
+  const size_t oldSpillCount = spillCount;
+  const size_t oldCount = historyCount();
+
+  // Re-append the survivors under fresh block numbers (after the old ones),
+  // so no old block is ever rewritten under its own number. New block j is
+  // spilled once the window overflows, i.e. after old blocks 0..j+1 were
+  // read, and its key is a free one or old block j's at most, so the loop
+  // never reads a key it already overwrote. Until the caller saves the new
+  // record a reset leaves the old one; any of its blocks overwritten by then
+  // fail the block-number check and are dropped by the retry, not misread.
+  spillFirst = oldFirst + static_cast<uint32_t>(oldSpillCount);
+  spillCount = 0;
+  windowHead = 0;
+  windowSize = 0;
+  cacheValid = false;
+
+  size_t newPosition = 0;
+  size_t logical = 0;
+  uint8_t block[BLOCK_BYTES];
+  for (size_t b = 0; b < oldSpillCount; ++b) {
+    const uint32_t blockNumber = oldFirst + static_cast<uint32_t>(b);
+    const bool read = loadBlock(blockNumber);
+    if (read) {
+      memcpy(block, cachedBlock, BLOCK_BYTES);
+    }
+    cacheValid = false;
+    if (!read) {
+      logical += HISTORY_BLOCK_ENTRIES;
+      continue;
+    }
+    for (size_t i = 0; i < HISTORY_BLOCK_ENTRIES; ++i, ++logical) {
+      const uint32_t id = getU32(block + BLOCK_HEADER_BYTES + 4 * i);
+      if (!keep(id)) {
+        continue;
+      }
+      historyAppend(id);
+      if (logical <= position) {
+        newPosition = historyCount() - 1;
+      }
+    }
+  }
+  for (size_t i = 0; i < oldWindowSize; ++i, ++logical) {
+    if (!keep(oldWindow[i])) {
+      continue;
+    }
+    historyAppend(oldWindow[i]);
+    if (logical <= position) {
+      newPosition = historyCount() - 1;
+    }
+  }
+
+  // A failed spill above drops older entries; keep the cursor in range.
+  const size_t count = historyCount();
+  position = newPosition < count ? newPosition : (count == 0 ? 0 : count - 1);
+  return oldCount - count;
+}
+
+void historySave(Preferences &prefs) {
+  HistorySaved saved;
+  saved.version = HISTORY_SAVE_VERSION;
+  saved.spillFirst = spillFirst;
+  saved.spillCount = static_cast<uint16_t>(spillCount);
+  saved.windowSize = static_cast<uint16_t>(windowSize);
+  memset(saved.window, 0, sizeof(saved.window));
+  for (size_t i = 0; i < windowSize; ++i) {
+    saved.window[i] = windowAt(i);
+  }
+  prefs.putBytes(HISTORY_NVS_KEY, &saved, sizeof(saved));
+}
+
+bool historyLoad(Preferences &prefs) {
+  HistorySaved saved;
+  if (prefs.getBytesLength(HISTORY_NVS_KEY) != sizeof(saved) ||
+      prefs.getBytes(HISTORY_NVS_KEY, &saved, sizeof(saved)) !=
+          sizeof(saved)) {
+    return false;
+  }
+  if (saved.version != HISTORY_SAVE_VERSION ||
+      saved.spillCount > HISTORY_SPILL_BLOCKS ||
+      saved.windowSize > HISTORY_WINDOW) {
+    return false;
+  }
+
+  spillFirst = saved.spillFirst;
+  spillCount = saved.spillCount;
+  windowSize = saved.windowSize;
+  windowHead = windowSize % HISTORY_WINDOW;
+  memcpy(window, saved.window, sizeof(window));
+  cacheValid = false;
+  return true;
+}
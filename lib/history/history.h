@@ -0,0 +1,100 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class Preferences;
+
+// ─── Insult history ─────────────────────────────────────────────
+//
+// Content ids in show order, logical position 0 = oldest. Two tiers:
+//
+// - window: the newest HISTORY_WINDOW ids, raw, in RTC memory.
+// - spill: when the window is full, its oldest HISTORY_BLOCK_ENTRIES ids are
+//   written to NVS as one block of raw 4-byte ids behind its block number
+//   (4.125 bytes per entry). Blocks form a ring of HISTORY_SPILL_BLOCKS keys;
+//   the oldest block is overwritten once the ring is full.
+//
+// Ids don't compress usefully: corpus ids are text hashes and n-gram ids
+// random seeds, so deltas between neighbours are as wide as the ids.
+//
+// Every block holds exactly HISTORY_BLOCK_ENTRIES ids, so a logical position
+// maps to its block by division and to its entry by offset. The last block
+// read stays cached in RAM, so walking back with Prev costs one NVS read per
+// block.
+//
+// History is capped at HISTORY_MAX (1088) entries; past that the oldest
+// block is dropped. RTC footprint is fixed (~270 bytes); flash writes happen
+// once per HISTORY_BLOCK_ENTRIES new insults.
+
+static constexpr size_t HISTORY_WINDOW = 64;
+static constexpr size_t HISTORY_BLOCK_ENTRIES = 32;
+static constexpr size_t HISTORY_SPILL_BLOCKS = 32;
+
+// Longest history: spilled blocks + what's left in the window.
+static constexpr size_t HISTORY_MAX =
+    HISTORY_SPILL_BLOCKS * HISTORY_BLOCK_ENTRIES + HISTORY_WINDOW;
+
+static_assert(HISTORY_BLOCK_ENTRIES <= HISTORY_WINDOW,
+              "a block is spilled from the window");
+static_assert(HISTORY_MAX <= 0xFFFF, "history positions are 16-bit");
+
+/**
+ * @brief Forget all entries (spilled blocks are simply overwritten later).
+ */
+void historyReset();
+
+/**
+ * @brief Number of entries (0..HISTORY_MAX).
+ */
+size_t historyCount();
+
+/**
+ * @brief Read an entry by logical position (0=oldest, count-1=newest).
+ *
+ * @param logicalPos Logical position.
+ * @param outId Receives the stored content id.
+ * @return false if out of range or the block can't be read back.
+ */
+bool historyGetAtLogical(size_t logicalPos, uint32_t &outId);
+
+/**
+ * @brief Append an id; spills a block to NVS when the window is full.
+ *
+ * If the history is at HISTORY_MAX, the oldest block is dropped, shifting
+ * every logical position down by HISTORY_BLOCK_ENTRIES.
+ */
+void historyAppend(uint32_t id);
+
+/**
+ * @brief Drop the entries `keep` rejects; meant for the rare load after a
+ * corpus change.
+ *
+ * Spilled blocks are read back, filtered and written again under new block
+ * numbers, so the old "hist" record never reads a rewritten block as its
+ * own; save the new record afterwards. Blocks that can't be read are
+ * dropped.
+ *
+ * @param keep Predicate on content ids.
+ * @param position In: a logical position; out: the position of the last
+ * kept entry at or before it (0 if none).
+ * @return Number of entries dropped.
+ */
+size_t historyRetain(bool (*keep)(uint32_t id), size_t &position);
+
+/**
+ * @brief Save the window and block bookkeeping (key "hist").
+ *
+ * @param prefs Open, writable NVS namespace.
+ */
+void historySave(Preferences &prefs);
+
+/**
+ * @brief Restore what historySave() wrote.
+ *
+ * @return false if missing or inconsistent; the history is then unchanged.
+ */
+bool historyLoad(Preferences &prefs);
+
+#endif // HISTORY_H
@@ -1,5 +1,19 @@
 #include "insults.h"
+#include "clock.h"
+#include "content.h"
+#include "corpus.h"
+#include "energy.h"
+#include "favorites.h"
+#include "font.h"
+#include "grammar.h"
+#include "history.h"
+#include "latency.h"
 #include "persist_keys.h"
+#include "recent.h"
+#include "render.h"
+#include "tags.h"
+#include "trace.h"
+#include "usage.h"
 #include <Arduino.h>
 #include <Preferences.h>
 
@@ -9,7 +23,9 @@ enum class RenderReason {
   OperationStart,
   OperationComplete,
   UserTap,
-  Wake
+  Wake,
+  Console,
+  Plain // no header: a redraw, not an event
 };
 enum class OperationPhase { Idle, Waiting };
 
@@ -17,20 +33,23 @@ enum class OperationPhase { Idle, Waiting };
 
 // Non-volatile storage (NVS) namespace + magic marker for saved-state
 // validation.
-static constexpr uint32_t NVS_MAGIC = 0xBADC0FFE;
+static constexpr uint32_t NVS_MAGIC = 0xBADC0FF1;
 
-// Simulated “work” duration for operations (Random/Next/Prev).
-static constexpr uint32_t MOCK_WORK_MS = 800;
+// Source data lives in assets/insults.txt and is packed into lib/corpus/ at
+// build time (text + precomputed line breaks).
+static constexpr size_t insultCount = CORPUS_INSULT_COUNT;
 
-// Source data (future: load from flash/SD/API)
-static const char *const insults[] = {
-    "You fight like a dairy farmer.",
-    "You have the manners of a troll.",
-    "I’ve spoken with sewer rats more polite than you.",
-    "Oh look, both your weapons are tiny!",
-};
+// Corpus draws: true = weighted by {w=N} (alias table + per-epoch budgets),
+// false = uniform shuffled deck.
+static constexpr bool CORPUS_WEIGHTED_DRAWS = true;
+
+// Seeds to try before an n-gram draw falls back to the corpus (a seed can
+// fail to produce a novel line that fits the panel).
+static constexpr uint8_t NGRAM_DRAW_TRIES = 4;
 
-static constexpr size_t insultCount = sizeof(insults) / sizeof(insults[0]);
+// Recent cards the unweighted deck swaps away before dealing one anyway (a
+// false positive, or a corpus too small for the window).
+static constexpr uint8_t RECENT_DRAW_TRIES = 4;
 
 // ───────────────── Persistent State (RTC) ─────────────────
 //
@@ -41,17 +60,25 @@ static constexpr size_t insultCount = sizeof(insults) / sizeof(insults[0]);
 static uint16_t deck[insultCount] = {0};
 static size_t deckPosition = 0;
 
-static constexpr size_t HISTORY_CAP = insultCount;
-static RTC_DATA_ATTR uint16_t history[HISTORY_CAP] = {0};
+// Weighted draws: per-epoch budgets (corpus.h).
+static CorpusEpoch weightedEpoch = CORPUS_EPOCH_INIT;
 
-static RTC_DATA_ATTR size_t historyHead =
-    0; // physical write index (next append)
-static RTC_DATA_ATTR size_t historySize =
-    0; // number of valid entries (0..HISTORY_CAP)
+// History itself (content ids, RTC window + NVS blocks) lives in history.h.
 static RTC_DATA_ATTR size_t historyPosition =
-    0; // logical cursor (0=oldest .. size-1=newest)
+    0; // logical cursor (0=oldest .. count-1=newest)
+
+// Entries the "history" console command lists (the newest ones).
+static constexpr size_t HISTORY_LIST_MAX = 10;
+
+static RTC_DATA_ATTR uint32_t currentInsultId = 0;
+
+// Grammar draw order; 8 bytes however many sentences there are. Kept across
+// deep sleep so the no-repeat guarantee spans sessions.
+static RTC_DATA_ATTR GrammarDeck grammarDeck = {0, 0};
 
-static RTC_DATA_ATTR uint16_t currentInsultIndex = 0;
+// Ids drawn within the last RECENT_WINDOW draws, across decks and generators
+// (recent.h). Cleared on cold boot.
+static RTC_DATA_ATTR RecentFilter recentShows;
 
 // ───────────────── Operation State (RAM) ─────────────────
 
@@ -63,7 +90,11 @@ static OperationPhase operationPhase = OperationPhase::Idle;
 static bool operationIsNewInsult = false;
 
 static uint32_t operationStartedAt = 0;
-static uint16_t pendingInsultIndex = 0;
+static uint32_t pendingInsultId = 0;
+
+// What the panel shows (e-ink keeps it until the next flush).
+static bool panelShowsInsult = false;
+static uint32_t panelInsultId = 0;
 
 // ───────────────── Utilities ─────────────────
 
@@ -92,7 +123,9 @@ static void initDeck() {
 /**
  * @brief Draw the next insult index from the shuffled deck.
  *
- * If the deck is exhausted, it is reshuffled automatically.
+ * If the deck is exhausted, it is reshuffled automatically. A card shown
+ * recently (typically the tail of the previous deck) is swapped with a random
+ * later card rather than dropped, so the deck still covers every insult.
  */
 static uint16_t drawFromDeck() {
   if (insultCount == 0) {
@@ -103,74 +136,128 @@ static uint16_t drawFromDeck() {
     initDeck();
   }
 
+  for (uint8_t i = 0;
+       i < RECENT_DRAW_TRIES && deckPosition + 1 < insultCount &&
+       recentContains(recentShows, contentCorpusId(deck[deckPosition]));
+       ++i) {
+    const long r = random(static_cast<long>(deckPosition + 1),
+                          static_cast<long>(insultCount));
+    const uint16_t tmp = deck[deckPosition];
+    deck[deckPosition] = deck[r];
+    deck[r] = tmp;
+  }
+
   const uint16_t idx = deck[deckPosition];
   deckPosition++;
   return idx;
 }
 
-static size_t wrapIndex(size_t index, size_t mod) {
-  if (mod == 0) {
-    return 0;
-  }
-  return index % mod;
+/**
+ * @brief Whether a corpus insult was among the last RECENT_WINDOW draws.
+ */
+static bool corpusIndexIsRecent(uint16_t index) {
+  return recentContains(recentShows, contentCorpusId(index));
 }
 
 /**
- * @brief Physical index of the “oldest” entry in the ring buffer.
+ * @brief Draw the next corpus insult in the configured mode.
  *
- * historyHead points to the next write position, so the oldest is:
- *   head - size (with wrap).
+ * Recent insults are passed over inside the draw, before any budget is
+ * spent on them.
  */
-static size_t historyOldestPhysicalIndex() {
-  if (HISTORY_CAP == 0) {
-    return 0;
-  }
-  return wrapIndex(historyHead + HISTORY_CAP - historySize, HISTORY_CAP);
+static uint16_t drawFromCorpus() {
+  return CORPUS_WEIGHTED_DRAWS
+             ? corpusEpochDraw(weightedEpoch, esp_random, corpusIndexIsRecent)
+             : drawFromDeck();
 }
 
 /**
- * @brief Read a history entry by logical position (0..historySize-1).
+ * @brief Draw the next sentence from the grammar's no-repeat order.
  *
- * @param logicalPos Logical cursor position (0=oldest, size-1=newest).
- * @param outIndex Receives the stored insult index.
- * @return true if found; false if history empty/out of range.
+ * Starts a new order (fresh key) once every sentence has been shown. Not
+ * checked against the recent-shows filter: the order already never repeats
+ * within grammarSentenceCount() draws, far more than the window, and
+ * skipping a slot would drop that sentence from the order.
  */
-static bool historyGetAtLogical(size_t logicalPos, uint16_t &outIndex) {
-  if (HISTORY_CAP == 0 || historySize == 0) {
-    return false;
-  }
-  if (logicalPos >= historySize) {
-    return false;
+static uint32_t drawFromGrammar() {
+  uint32_t index = 0;
+  if (!grammarDeckDraw(grammarDeck, index)) {
+    grammarDeckShuffle(grammarDeck, static_cast<uint32_t>(random(0x7FFFFFFF)));
+    grammarDeckDraw(grammarDeck, index);
   }
-
-  const size_t oldest = historyOldestPhysicalIndex();
-  const size_t physical = wrapIndex(oldest + logicalPos, HISTORY_CAP);
-  outIndex = history[physical];
-  return true;
+  return index;
 }
 
 /**
- * @brief Append an insult index to the displayed-history ring buffer.
+ * @brief Pick a random n-gram seed that yields a showable, non-recent line.
  *
- * Ring-buffer behavior:
- * - If history is not full, historySize grows.
- * - If history is full, the oldest entry is overwritten.
+ * History stores only the seed; the line is regenerated from it on demand.
+ * Many seeds generate the same line, so recency is checked on the text
+ * (contentTextKey()), not the seed.
  *
- * After appending, historyPosition is set to the newest entry.
+ * @return false if none of NGRAM_DRAW_TRIES seeds worked.
  */
-static void appendToHistory(uint16_t index) {
-  if (HISTORY_CAP == 0) {
-    return;
+static bool drawFromNgram(uint32_t &outId) {
+  ContentText content;
+  for (uint8_t i = 0; i < NGRAM_DRAW_TRIES; ++i) {
+    const uint32_t seed =
+        static_cast<uint32_t>(random(0x7FFFFFFF)) & CONTENT_INDEX_MASK;
+    const uint32_t id = contentMakeId(ContentKind::Ngram, seed);
+    if (contentResolve(id, content) &&
+        !recentContains(recentShows, contentTextKey(id))) {
+      outId = id;
+      return true;
+    }
   }
+  return false;
+}
 
-  history[historyHead] = index;
-  historyHead = wrapIndex(historyHead + 1, HISTORY_CAP);
-
-  if (historySize < HISTORY_CAP) {
-    historySize++;
+/**
+ * @brief Pick a new insult (grammar, n-gram or corpus deck) as a content id.
+ *
+ * GRAMMAR_DRAW_PERCENT / NGRAM_DRAW_PERCENT (platformio.ini, via the pack
+ * step) split the draws; the corpus gets the rest and its {w=N} weights only
+ * share out that rest. A tag filter restricts draws to the tagged corpus
+ * insults; generated lines carry no tags. With an empty corpus everything
+ * comes from the grammar.
+ */
+static uint32_t drawCandidateId() {
+  if (tagsFilterActive()) {
+    return contentCorpusId(tagsDraw(esp_random, corpusIndexIsRecent));
+  }
+  if (insultCount == 0) {
+    return contentMakeId(ContentKind::Grammar, drawFromGrammar());
   }
+  const long roll = random(0, 100);
+  if (roll < GRAMMAR_DRAW_PERCENT) {
+    return contentMakeId(ContentKind::Grammar, drawFromGrammar());
+  }
+  uint32_t id = 0;
+  if (roll < GRAMMAR_DRAW_PERCENT + NGRAM_DRAW_PERCENT && drawFromNgram(id)) {
+    return id;
+  }
+  return contentCorpusId(drawFromCorpus());
+}
+
+/**
+ * @brief Draw a new insult and note it in the recent-shows filter.
+ *
+ * Each source avoids recent ids itself, so a rejected candidate never costs
+ * a weighted budget, a tag round slot or a grammar order slot, and the
+ * grammar/n-gram/corpus mix is rolled once per draw.
+ */
+static uint32_t drawInsultId() {
+  const uint32_t id = drawCandidateId();
+  recentInsert(recentShows, contentTextKey(id));
+  return id;
+}
 
-  historyPosition = historySize - 1;
+/**
+ * @brief Append a content id to the history and move the cursor onto it.
+ */
+static void appendToHistory(uint32_t id) {
+  historyAppend(id);
+  historyPosition = historyCount() - 1;
 }
 
 // ───────────────── Rendering ─────────────────
@@ -210,72 +297,147 @@ static void renderTitleScreen() {
 }
 
 /**
- * @brief Render a single insult with a small “reason/action” header.
- *
- * This module prints to Serial today; later you can swap these prints
- * for display drawing calls without changing the higher-level flow.
+ * @brief Print corpus (codepage) text to Serial as UTF-8.
  */
-static void renderInsultAtIndex(uint16_t index, PendingAction action,
-                                RenderReason reason) {
-  if (insultCount == 0) {
-    Serial.println(F("[WARN] No insults available."));
-    return;
+static void printCodepageText(const char *text, size_t length) {
+  char utf8[3];
+  for (size_t i = 0; i < length; ++i) {
+    const size_t n = fontCodeToUtf8(static_cast<uint8_t>(text[i]), utf8);
+    Serial.write(reinterpret_cast<const uint8_t *>(utf8), n);
   }
+}
 
-  if (index >= insultCount) {
-    Serial.print(F("[WARN] Invalid insult index: "));
-    Serial.println(index);
-    return;
-  }
-
-  const char *line = insults[index];
-
-  Serial.println(F("────────────────────────────"));
+static const char *reasonLabel(RenderReason reason) {
   switch (reason) {
   case RenderReason::Boot:
-    Serial.println(F("[Boot]"));
-    break;
+    return "[Boot]";
   case RenderReason::Wake:
-    Serial.println(F("[Wake]"));
-    break;
+    return "[Wake]";
   case RenderReason::OperationStart:
-    Serial.println(F("[Starting]"));
-    break;
+    return "[Starting]";
   case RenderReason::OperationComplete:
-    Serial.println(F("[Done]"));
-    break;
+    return "[Done]";
   case RenderReason::UserTap:
-    Serial.println(F("[Tap]"));
+    return "[Tap]";
+  case RenderReason::Console:
+    return "[Console]";
+  case RenderReason::Plain:
     break;
   }
+  return "";
+}
 
+static const char *actionLabel(PendingAction action) {
   switch (action) {
   case PendingAction::Random:
-    Serial.println(F("(Random)"));
-    break;
+    return "(Random)";
   case PendingAction::Next:
-    Serial.println(F("(Next)"));
-    break;
+    return "(Next)";
   case PendingAction::Prev:
-    Serial.println(F("(Previous)"));
-    break;
+    return "(Previous)";
   case PendingAction::None:
     break;
   }
+  return nullptr;
+}
+
+/**
+ * @brief Render a single insult with a small “reason/action” header.
+ *
+ * Logs to Serial and draws the same content on the panel (render module).
+ *
+ * Line breaks come from the pack-time layout table (corpus) or the runtime
+ * wrap (generated text), so each line is a (start, length) slice of the text.
+ */
+static void renderInsult(uint32_t id, PendingAction action,
+                         RenderReason reason) {
+  TRACE_SCOPE(TraceId::RenderInsult);
+
+  ContentText content;
+  if (!contentResolve(id, content)) {
+    Serial.printf("[WARN] Invalid insult id: 0x%08lx\n",
+                  static_cast<unsigned long>(id));
+    return;
+  }
+
+  const char *reasonText = reasonLabel(reason);
+  const char *actionText = actionLabel(action);
 
-  Serial.println(line);
   Serial.println(F("────────────────────────────"));
+  if (*reasonText != '\0') {
+    Serial.println(reasonText);
+  }
+  if (actionText != nullptr) {
+    Serial.println(actionText);
+  }
+  for (uint8_t i = 0; i < content.layout.lineCount; ++i) {
+    const CorpusLine &line = content.layout.lines[i];
+    printCodepageText(content.text + line.start, line.length);
+    Serial.println();
+  }
+  Serial.println(F("────────────────────────────"));
+
+  renderInsultScreen(id, reasonText, actionText);
+  panelShowsInsult = true;
+  panelInsultId = id;
 }
 
 // ───────────────── Persistence (NVS) ─────────────────
 
+/**
+ * @brief Write current insult, history and cursor to NVS.
+ *
+ * @return false if NVS couldn't be opened.
+ */
+static bool saveInsultsStateToNvs() {
+  TRACE_SCOPE(TraceId::NvsWrite);
+  ClockBoost boost;
+  Preferences prefs;
+  if (!prefs.begin(NVS_NS, false)) {
+    return false;
+  }
+
+  prefs.putUInt("m", NVS_MAGIC);
+  prefs.putUInt("cur", currentInsultId);
+  prefs.putUShort("hP", static_cast<uint16_t>(historyPosition));
+  historySave(prefs);
+  // Last: a reset before these leaves an old fingerprint, so the next load
+  // just remaps again (remapping is idempotent).
+  const ContentFingerprint fingerprint = contentFingerprint();
+  prefs.putUInt("gfp", fingerprint.grammar);
+  prefs.putUInt("nfp", fingerprint.ngram);
+  prefs.putUInt("cfp", fingerprint.corpus);
+  prefs.end();
+  energyNoteFlashWrite();
+  return true;
+}
+
+// Fingerprint the state being loaded was saved under (savedIdIsCurrent()).
+static ContentFingerprint savedFingerprint = {0, 0, 0};
+
+/**
+ * @brief historyRetain() predicate: ids that still mean what they did when
+ * saved.
+ */
+static bool savedIdIsCurrent(uint32_t id) {
+  return contentIsCurrent(id, savedFingerprint);
+}
+
 /**
  * @brief Load last-seen insult + history cursor from NVS.
  *
  * This is used on wake-from-sleep to restore exactly what the user last saw.
  * A magic marker + size checks are used to avoid applying incompatible data.
+ *
+ * History stores stable ids, so a corpus update (new fingerprint) only drops
+ * the entries whose insult is gone, plus the generated ones whose engine
+ * changed (the n-gram model is retrained from the corpus on every pack); the
+ * cursor moves to the nearest older survivor and the current insult falls
+ * back to it if needed.
  */
-static bool loadInsultsStateFromNvs(uint16_t &outIndex) {
+static bool loadInsultsStateFromNvs(uint32_t &outId) {
+  TRACE_SCOPE(TraceId::NvsRead);
+  ClockBoost boost;
   Preferences prefs;
   if (!prefs.begin(NVS_NS, true)) {
     return false;
@@ -287,46 +449,46 @@ static bool loadInsultsStateFromNvs(uint16_t &outIndex) {
     return false;
   }
 
-  const uint16_t savedCur = prefs.getUShort("cur", 0);
-
-  const uint16_t savedHead = prefs.getUShort("hH", 0);
-  const uint16_t savedSize = prefs.getUShort("hS", 0);
-  const uint16_t savedPos = prefs.getUShort("hP", 0);
+  uint32_t savedCur = prefs.getUInt("cur", 0);
+  size_t savedPos = prefs.getUShort("hP", 0);
+  // Missing keys (older builds) read as 0 and drop generated ids.
+  savedFingerprint.corpus = prefs.getUInt("cfp", 0);
+  savedFingerprint.grammar = prefs.getUInt("gfp", 0);
+  savedFingerprint.ngram = prefs.getUInt("nfp", 0);
 
-  const size_t expectedBytes = sizeof(history);
-  const size_t gotBytes = prefs.getBytesLength("hist");
-  if (gotBytes != expectedBytes) {
-    prefs.end();
+  // Spilled history blocks stay in NVS and are read back on demand.
+  const bool historyValid = historyLoad(prefs);
+  prefs.end();
+  if (!historyValid) {
     return false;
   }
 
-  const size_t readBytes = prefs.getBytes("hist", history, expectedBytes);
-  prefs.end();
-
-  if (readBytes != expectedBytes) {
-    return false;
+  const ContentFingerprint current = contentFingerprint();
+  const bool remap = savedFingerprint.corpus != current.corpus ||
+                     savedFingerprint.grammar != current.grammar ||
+                     savedFingerprint.ngram != current.ngram;
+  if (remap) {
+    const size_t dropped = historyRetain(savedIdIsCurrent, savedPos);
+    Serial.printf("[Wake] content changed; %u history entries dropped\n",
+                  static_cast<unsigned>(dropped));
   }
 
-  // Validate saved metadata against current compiled-in sizes.
-  if (insultCount == 0) {
+  const size_t count = historyCount();
+  const bool posValid = savedPos <= (count == 0 ? 0 : count - 1);
+  if (!posValid) {
     return false;
   }
-
-  const bool curValid = (savedCur < insultCount);
-  const bool sizeValid = (savedSize <= HISTORY_CAP);
-  const bool headValid = (savedHead < HISTORY_CAP);
-  const bool posValid = (savedPos <= (savedSize == 0 ? 0 : (savedSize - 1)));
-
-  if (!curValid || !sizeValid || !headValid || !posValid) {
+  if (!savedIdIsCurrent(savedCur) &&
+      !historyGetAtLogical(savedPos, savedCur)) {
     return false;
   }
 
-  historyHead = savedHead;
-  historySize = savedSize;
   historyPosition = savedPos;
-
-  currentInsultIndex = savedCur;
-  outIndex = savedCur;
+  currentInsultId = savedCur;
+  outId = savedCur;
+  if (remap) {
+    saveInsultsStateToNvs();
+  }
   return true;
 }
 
@@ -335,19 +497,65 @@ static bool loadInsultsStateFromNvs(uint16_t &outIndex) {
  *
  * Called from main right before esp_deep_sleep_start().
  */
-void insultsPersistForSleep() {
-  Preferences prefs;
-  if (!prefs.begin(NVS_NS, false)) {
+void insultsPersistForSleep() { saveInsultsStateToNvs(); }
+
+/**
+ * @brief Make sure the panel shows the current insult.
+ */
+void insultsEnsureOnDisplay() {
+  if (historyCount() == 0 ||
+      (panelShowsInsult && panelInsultId == currentInsultId)) {
     return;
   }
+  // It stays up for the whole sleep, so no event header.
+  renderInsult(currentInsultId, PendingAction::None, RenderReason::Plain);
+}
 
-  prefs.putUInt("m", NVS_MAGIC);
-  prefs.putUShort("cur", currentInsultIndex);
-  prefs.putUShort("hH", static_cast<uint16_t>(historyHead));
-  prefs.putUShort("hS", static_cast<uint16_t>(historySize));
-  prefs.putUShort("hP", static_cast<uint16_t>(historyPosition));
-  prefs.putBytes("hist", history, sizeof(history));
-  prefs.end();
+bool insultsCurrentId(uint32_t &outId) {
+  if (historyCount() == 0) {
+    return false;
+  }
+  outId = currentInsultId;
+  return true;
+}
+
+bool insultsShow(uint32_t id) {
+  if (operationPhase != OperationPhase::Idle || !contentIsValid(id)) {
+    return false;
+  }
+  currentInsultId = id;
+  appendToHistory(id);
+  renderInsult(id, PendingAction::None, RenderReason::Console);
+  usageNoteShow(id);
+  return true;
+}
+
+void historyCommand(const char *args) {
+  if (*args != '\0') {
+    Serial.println(F("[History] usage: history"));
+    return;
+  }
+  const size_t count = historyCount();
+  Serial.printf("[History] %u/%u entries (oldest dropped past the cap), "
+                "cursor at %u\n",
+                static_cast<unsigned>(count),
+                static_cast<unsigned>(HISTORY_MAX),
+                static_cast<unsigned>(count == 0 ? 0 : historyPosition + 1));
+
+  // The newest few; `>` marks the cursor.
+  const size_t shown = count < HISTORY_LIST_MAX ? count : HISTORY_LIST_MAX;
+  for (size_t pos = count - shown; pos < count; ++pos) {
+    Serial.printf("%c%5u  ", pos == historyPosition ? '>' : ' ',
+                  static_cast<unsigned>(pos + 1));
+    uint32_t id = 0;
+    ContentText content;
+    if (!historyGetAtLogical(pos, id) || !contentResolve(id, content)) {
+      Serial.println(F("(unavailable)"));
+      continue;
+    }
+    printCodepageText(content.text, content.length);
+    Serial.println();
+  }
 }
 
 // ───────────────── Work Orchestration ─────────────────
@@ -355,23 +563,36 @@ void insultsPersistForSleep() {
 /**
  * @brief Prepare internal state for a given user action.
  *
- * Chooses what index will be shown after the simulated work delay completes:
+ * Chooses what insult will be shown after the simulated work delay completes:
  * - Random always draws a new insult.
  * - Prev moves back within history if possible.
  * - Next moves forward within history, but draws a new insult if at the end.
+ * - In favorites-only mode all three pick from the favorites instead.
  */
 static bool beginWorkFor(PendingAction action) {
   operationIsNewInsult = false;
 
+  if (favoritesOnly() && action != PendingAction::None) {
+    // Favorites-only: Random picks any favorite, Next/Prev walk the list in
+    // marking order. Each show is appended to history like a fresh draw.
+    pendingInsultId = action == PendingAction::Random
+                          ? favoritesRandom(currentInsultId)
+                          : favoritesStep(action == PendingAction::Next ? 1
+                                                                        : -1);
+    operationIsNewInsult = true;
+    operationPhase = OperationPhase::Waiting;
+    return true;
+  }
+
   if (action == PendingAction::Random) {
-    pendingInsultIndex = drawFromDeck();
+    pendingInsultId = drawInsultId();
     operationIsNewInsult = true;
     operationPhase = OperationPhase::Waiting;
     return true;
   }
 
   if (action == PendingAction::Prev) {
-    if (historySize == 0) {
+    if (historyCount() == 0) {
       Serial.println(F("[Prev] No history yet."));
       return false;
     }
@@ -381,7 +602,7 @@ static bool beginWorkFor(PendingAction action) {
     }
 
     historyPosition--;
-    if (!historyGetAtLogical(historyPosition, pendingInsultIndex)) {
+    if (!historyGetAtLogical(historyPosition, pendingInsultId)) {
       Serial.println(F("[Prev] History read failed."));
       return false;
     }
@@ -391,18 +612,18 @@ static bool beginWorkFor(PendingAction action) {
   }
 
   if (action == PendingAction::Next) {
-    if (historySize == 0) {
+    if (historyCount() == 0) {
       // No history yet; treat Next like Random.
-      pendingInsultIndex = drawFromDeck();
+      pendingInsultId = drawInsultId();
       operationIsNewInsult = true;
       operationPhase = OperationPhase::Waiting;
       return true;
     }
 
-    if (historyPosition < historySize - 1) {
+    if (historyPosition < historyCount() - 1) {
       // Still within history; move forward.
       historyPosition++;
-      if (!historyGetAtLogical(historyPosition, pendingInsultIndex)) {
+      if (!historyGetAtLogical(historyPosition, pendingInsultId)) {
         Serial.println(F("[Next] History read failed."));
         return false;
       }
@@ -411,7 +632,7 @@ static bool beginWorkFor(PendingAction action) {
     }
 
     // At newest entry; Next generates a new insult.
-    pendingInsultIndex = drawFromDeck();
+    pendingInsultId = drawInsultId();
     operationIsNewInsult = true;
     operationPhase = OperationPhase::Waiting;
     return true;
@@ -424,8 +645,8 @@ static bool beginWorkFor(PendingAction action) {
  * @brief Initialize the insults module and render the startup UI.
  *
  * - Always rebuilds the randomized deck.
- * - On cold boot: resets history, renders title, and optionally prints an
- * insult.
+ * - On cold boot: resets history, the grammar order and the recent-shows
+ * filter, renders title, and optionally prints an insult.
  * - On wake-from-sleep: attempts to restore from NVS and render the last
  * insult.
  *
@@ -438,17 +659,17 @@ bool insultsInit(bool printInsultOnBoot, bool wokeFromSleep) {
 
   if (!wokeFromSleep) {
     // Cold boot: reset history and show the splash/title.
-    historyHead = 0;
-    historySize = 0;
+    historyReset();
     historyPosition = 0;
+    grammarDeckShuffle(grammarDeck, static_cast<uint32_t>(random(0x7FFFFFFF)));
+    recentClear(recentShows);
 
     renderTitleScreen();
 
-    if (printInsultOnBoot && insultCount > 0) {
-      currentInsultIndex = drawFromDeck();
-      appendToHistory(currentInsultIndex);
-      renderInsultAtIndex(currentInsultIndex, PendingAction::Random,
-                          RenderReason::Boot);
+    if (printInsultOnBoot) {
+      currentInsultId = drawInsultId();
+      appendToHistory(currentInsultId);
+      renderInsult(currentInsultId, PendingAction::Random, RenderReason::Boot);
       return true;
     }
 
@@ -456,25 +677,19 @@ bool insultsInit(bool printInsultOnBoot, bool wokeFromSleep) {
   }
 
   // Wake path: restore last displayed insult/history if possible.
-  uint16_t restoredIndex = 0;
-  if (loadInsultsStateFromNvs(restoredIndex)) {
-    renderInsultAtIndex(restoredIndex, PendingAction::None, RenderReason::Wake);
+  uint32_t restoredId = 0;
+  if (loadInsultsStateFromNvs(restoredId)) {
+    renderInsult(restoredId, PendingAction::None, RenderReason::Wake);
     return true;
   }
 
   // Fallback: no saved state; draw one and seed history so Next/Prev behave.
-  if (insultCount == 0) {
-    return false;
-  }
-
-  currentInsultIndex = drawFromDeck();
-  historyHead = 0;
-  historySize = 0;
+  currentInsultId = drawInsultId();
+  historyReset();
   historyPosition = 0;
-  appendToHistory(currentInsultIndex);
+  appendToHistory(currentInsultId);
 
-  renderInsultAtIndex(currentInsultIndex, PendingAction::None,
-                      RenderReason::Wake);
+  renderInsult(currentInsultId, PendingAction::None, RenderReason::Wake);
   return true;
 }
 
@@ -485,6 +700,7 @@ bool insultsInit(bool printInsultOnBoot, bool wokeFromSleep) {
  * The caller typically transitions the app into an Updating state only if true.
  */
 bool insultsStartOperation(PendingAction action, uint32_t now) {
+  TRACE_SCOPE(TraceId::InsultsStartOperation);
   pendingAction = action;
   operationPhase = OperationPhase::Idle;
   operationIsNewInsult = false;
@@ -507,6 +723,7 @@ bool insultsStartOperation(PendingAction action, uint32_t now) {
  * operation state back to Idle.
  */
 bool insultsPoll(uint32_t now) {
+  TRACE_SCOPE(TraceId::InsultsPoll);
   if (operationPhase != OperationPhase::Waiting) {
     return false;
   }
@@ -516,22 +733,21 @@ bool insultsPoll(uint32_t now) {
   }
 
   const PendingAction completedAction = pendingAction;
-  currentInsultIndex = pendingInsultIndex;
+  currentInsultId = pendingInsultId;
 
   // Maintain history semantics:
   // - Random always appends
   // - Next appends only if it generated a new insult
   // - Prev does not append (cursor moved within beginWorkFor)
-  if (completedAction == PendingAction::Random) {
-    appendToHistory(currentInsultIndex);
-  } else if (completedAction == PendingAction::Next) {
-    if (operationIsNewInsult) {
-      appendToHistory(currentInsultIndex);
-    }
+  // - favorites-only picks always append
+  if (operationIsNewInsult) {
+    appendToHistory(currentInsultId);
   }
 
-  renderInsultAtIndex(currentInsultIndex, completedAction,
-                      RenderReason::OperationComplete);
+  latencyMark(LatencyPoint::WorkDone);
+  renderInsult(currentInsultId, completedAction,
+               RenderReason::OperationComplete);
+  usageNoteShow(currentInsultId);
 
   pendingAction = PendingAction::None;
   operationPhase = OperationPhase::Idle;
@@ -5,6 +5,9 @@
 
 enum class PendingAction { None = 0, Random, Next, Prev };
 
+// Simulated “work” duration for operations (Random/Next/Prev).
+static constexpr uint32_t MOCK_WORK_MS = 800;
+
 /**
  * @brief Initialize the insults module and render the boot/wake UI.
  *
@@ -54,4 +57,35 @@ bool insultsPoll(uint32_t now);
  */
 void insultsPersistForSleep();
 
+/**
+ * @brief Make sure the panel shows the current insult.
+ *
+ * E-ink keeps its image with the MCU off, so call this before deep sleep;
+ * it only redraws if something else (or nothing) was drawn last.
+ */
+void insultsEnsureOnDisplay();
+
+/**
+ * @brief Content id of the current insult.
+ *
+ * @return false until the first insult has been shown.
+ */
+bool insultsCurrentId(uint32_t &outId);
+
+/**
+ * @brief Show a specific insult now and append it to history.
+ *
+ * For the console (`find #N`); renders immediately, without the mocked
+ * work delay.
+ *
+ * @return false while an operation is in progress or if `id` is invalid.
+ */
+bool insultsShow(uint32_t id);
+
+/**
+ * @brief Console command "history": entry count against the HISTORY_MAX
+ * cap, the cursor, and the newest entries.
+ */
+void historyCommand(const char *args);
+
 #endif // INSULTS_H
@@ -0,0 +1,262 @@
+#include "latency.h"
+#include <Arduino.h>
+#include <string.h>
+
+// ───────────────── Histogram ─────────────────
+//
+// HDR-style buckets: values below HIST_SUB_COUNT get one bucket each; above
+// that every power of two is split into HIST_SUB_COUNT linear sub-buckets,
+// so relative error stays under 1/HIST_SUB_COUNT (12.5%) at any magnitude.
+// Values at or above 2^HIST_MAX_EXP us (~4.2 s) land in the last bucket;
+// max is tracked exactly.
+
+static constexpr uint8_t HIST_SUB_BITS = 3;
+static constexpr uint32_t HIST_SUB_COUNT = 1u << HIST_SUB_BITS;
+static constexpr uint8_t HIST_MAX_EXP = 22;
+static constexpr size_t HIST_BUCKETS =
+    HIST_SUB_COUNT + (HIST_MAX_EXP - HIST_SUB_BITS) * HIST_SUB_COUNT;
+
+struct Histogram {
+  uint16_t counts[HIST_BUCKETS]; // saturating
+  uint32_t total;
+  uint32_t max;
+};
+
+struct LatencySummary {
+  uint32_t count;
+  uint32_t p50;
+  uint32_t p95;
+  uint32_t p99;
+  uint32_t max;
+};
+
+static size_t bucketFor(uint32_t value) {
+  if (value < HIST_SUB_COUNT) {
+    return value;
+  }
+  const uint8_t exp = static_cast<uint8_t>(31 - __builtin_clz(value));
+  if (exp >= HIST_MAX_EXP) {
+    return HIST_BUCKETS - 1;
+  }
+  const uint8_t shift = exp - HIST_SUB_BITS;
+  return HIST_SUB_COUNT + static_cast<size_t>(shift) * HIST_SUB_COUNT +
+         ((value >> shift) & (HIST_SUB_COUNT - 1));
+}
+
+// Largest value that maps to `bucket`.
+static uint32_t bucketUpper(size_t bucket) {
+  if (bucket < HIST_SUB_COUNT) {
+    return static_cast<uint32_t>(bucket);
+  }
+  const size_t shift = (bucket - HIST_SUB_COUNT) / HIST_SUB_COUNT;
+  const uint32_t sub = (bucket - HIST_SUB_COUNT) % HIST_SUB_COUNT;
+  const uint32_t lower = (HIST_SUB_COUNT + sub) << shift;
+  return lower + (1u << shift) - 1;
+}
+
+static void histRecord(Histogram &h, uint32_t value) {
+  uint16_t &c = h.counts[bucketFor(value)];
+  if (c != UINT16_MAX) {
+    c++;
+  }
+  h.total++;
+  if (value > h.max) {
+    h.max = value;
+  }
+}
+
+static uint32_t histPercentile(const Histogram &h, uint32_t permille) {
+  uint32_t recorded = 0;
+  for (size_t b = 0; b < HIST_BUCKETS; ++b) {
+    recorded += h.counts[b];
+  }
+  if (recorded == 0) {
+    return 0;
+  }
+  const uint32_t rank = (recorded * permille + 999) / 1000; // 1-based
+  uint32_t seen = 0;
+  for (size_t b = 0; b < HIST_BUCKETS; ++b) {
+    seen += h.counts[b];
+    if (seen >= rank) {
+      const uint32_t upper = bucketUpper(b);
+      return upper < h.max ? upper : h.max;
+    }
+  }
+  return h.max;
+}
+
+static LatencySummary histSummary(const Histogram &h) {
+  LatencySummary s;
+  s.count = h.total;
+  s.p50 = histPercentile(h, 500);
+  s.p95 = histPercentile(h, 950);
+  s.p99 = histPercentile(h, 990);
+  s.max = h.max;
+  return s;
+}
+
+// ───────────────── State ─────────────────
+
+static constexpr size_t STAGE_COUNT = static_cast<size_t>(LatencyStage::Count);
+static constexpr size_t SUMMARY_COUNT =
+    BUTTON_ID_COUNT + LATENCY_ACTION_SLOTS +
+    LATENCY_ACTION_SLOTS * STAGE_COUNT;
+
+// RAM: ~7.7 KB of histograms.
+static Histogram totalByButton[BUTTON_ID_COUNT];
+static Histogram totalByAction[LATENCY_ACTION_SLOTS];
+static Histogram stageByAction[LATENCY_ACTION_SLOTS][STAGE_COUNT];
+
+// RTC: last session's summaries, same order as forEachHistogram().
+static RTC_DATA_ATTR LatencySummary lastSession[SUMMARY_COUNT];
+
+struct InFlight {
+  bool active;
+  uint8_t button;
+  uint8_t action;
+  uint32_t edgeAt;
+  uint32_t decidedAt;
+  uint32_t startedAt;
+  uint32_t workDoneAt;
+};
+static InFlight inFlight = {};
+
+static const char *const buttonNames[BUTTON_ID_COUNT] = {"Sleep", "Random",
+                                                         "Next", "Prev"};
+static const char *const actionNames[LATENCY_ACTION_SLOTS] = {"None", "Random",
+                                                              "Next", "Prev"};
+static const char *const stageNames[STAGE_COUNT] = {"debounce", "dispatch",
+                                                    "work", "render"};
+
+/**
+ * @brief Visit every histogram with a printable label, in a fixed order.
+ */
+template <typename Fn> static void forEachHistogram(Fn fn) {
+  char label[32];
+  size_t slot = 0;
+  for (size_t b = 0; b < BUTTON_ID_COUNT; ++b) {
+    snprintf(label, sizeof(label), "button %s total", buttonNames[b]);
+    fn(slot++, label, totalByButton[b]);
+  }
+  for (size_t a = 0; a < LATENCY_ACTION_SLOTS; ++a) {
+    snprintf(label, sizeof(label), "action %s total", actionNames[a]);
+    fn(slot++, label, totalByAction[a]);
+  }
+  for (size_t a = 0; a < LATENCY_ACTION_SLOTS; ++a) {
+    for (size_t st = 0; st < STAGE_COUNT; ++st) {
+      snprintf(label, sizeof(label), "action %s %s", actionNames[a],
+               stageNames[st]);
+      fn(slot++, label, stageByAction[a][st]);
+    }
+  }
+}
+
+// ───────────────── API ─────────────────
+
+/**
+ * @brief Open the in-flight intent right after an operation started.
+ */
+void latencyBegin(ButtonId button, PendingAction action, uint32_t edgeAtUs,
+                  uint32_t decidedAtUs) {
+  const size_t b = static_cast<size_t>(button);
+  const size_t a = static_cast<size_t>(action);
+  if (b >= BUTTON_ID_COUNT || a >= LATENCY_ACTION_SLOTS) {
+    inFlight.active = false;
+    return;
+  }
+
+  inFlight.active = true;
+  inFlight.button = static_cast<uint8_t>(b);
+  inFlight.action = static_cast<uint8_t>(a);
+  inFlight.edgeAt = edgeAtUs;
+  inFlight.decidedAt = decidedAtUs;
+  inFlight.startedAt = micros();
+  inFlight.workDoneAt = inFlight.startedAt;
+}
+
+/**
+ * @brief Timestamp a later point of the in-flight intent.
+ */
+void latencyMark(LatencyPoint point) {
+  if (!inFlight.active) {
+    return;
+  }
+
+  const uint32_t now = micros();
+  if (point == LatencyPoint::WorkDone) {
+    inFlight.workDoneAt = now;
+    return;
+  }
+
+  // Flushed: close the intent.
+  Histogram *stages = stageByAction[inFlight.action];
+  histRecord(stages[static_cast<size_t>(LatencyStage::Debounce)],
+             inFlight.decidedAt - inFlight.edgeAt);
+  histRecord(stages[static_cast<size_t>(LatencyStage::Dispatch)],
+             inFlight.startedAt - inFlight.decidedAt);
+  histRecord(stages[static_cast<size_t>(LatencyStage::Work)],
+             inFlight.workDoneAt - inFlight.startedAt);
+  histRecord(stages[static_cast<size_t>(LatencyStage::Render)],
+             now - inFlight.workDoneAt);
+
+  const uint32_t total = now - inFlight.edgeAt;
+  histRecord(totalByButton[inFlight.button], total);
+  histRecord(totalByAction[inFlight.action], total);
+
+  inFlight.active = false;
+}
+
+/**
+ * @brief Snapshot summaries into RTC memory before sleep.
+ */
+void latencyPersistForSleep() {
+  forEachHistogram([](size_t slot, const char *, const Histogram &h) {
+    lastSession[slot] = histSummary(h);
+  });
+}
+
+static void printSummary(const char *label, const LatencySummary &s) {
+  Serial.printf("  %-24s n=%-6lu p50=%-8lu p95=%-8lu p99=%-8lu max=%lu\n",
+                label, static_cast<unsigned long>(s.count),
+                static_cast<unsigned long>(s.p50),
+                static_cast<unsigned long>(s.p95),
+                static_cast<unsigned long>(s.p99),
+                static_cast<unsigned long>(s.max));
+}
+
+/**
+ * @brief Console handler for "lat [reset]".
+ *
+ * Prints non-empty histograms for this session (us), then last session's
+ * persisted summaries if there are any.
+ */
+void latencyCommand(const char *args) {
+  if (strcmp(args, "reset") == 0) {
+    memset(totalByButton, 0, sizeof(totalByButton));
+    memset(totalByAction, 0, sizeof(totalByAction));
+    memset(stageByAction, 0, sizeof(stageByAction));
+    memset(lastSession, 0, sizeof(lastSession));
+    inFlight.active = false;
+    Serial.println(F("[Latency] reset"));
+    return;
+  }
+
+  Serial.println(F("[Latency] this session (us)"));
+  forEachHistogram([](size_t, const char *label, const Histogram &h) {
+    if (h.total > 0) {
+      printSummary(label, histSummary(h));
+    }
+  });
+
+  bool header = false;
+  forEachHistogram([&header](size_t slot, const char *label, const Histogram &) {
+    if (lastSession[slot].count == 0) {
+      return;
+    }
+    if (!header) {
+      Serial.println(F("[Latency] last session (us)"));
+      header = true;
+    }
+    printSummary(label, lastSession[slot]);
+  });
+}
@@ -0,0 +1,56 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "button.h"
+#include "insults.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ─── Input-to-render latency ────────────────────────────────────
+//
+// Every intent that starts an insult operation is timed (micros) through:
+//
+//   first physical edge ──Debounce──▶ debounce decision (updateButton)
+//     ──Dispatch──▶ insultsStartOperation() ──Work──▶ insultsPoll() done
+//     ──Render──▶ display flush
+//
+// and recorded into fixed-size log-bucketed (HDR-style) histograms: the
+// end-to-end total per ButtonId and per PendingAction, plus each stage per
+// PendingAction. "lat" on the serial console prints p50/p95/p99/max.
+
+enum class LatencyStage : uint8_t { Debounce = 0, Dispatch, Work, Render, Count };
+enum class LatencyPoint : uint8_t { WorkDone, Flushed };
+
+static constexpr size_t LATENCY_ACTION_SLOTS = 4; // indexed by PendingAction
+
+/**
+ * @brief Open the in-flight intent right after an operation started.
+ *
+ * @param button Physical button that produced the intent.
+ * @param action Operation that was started.
+ * @param edgeAtUs First physical edge (Button::edgeAtUs).
+ * @param decidedAtUs Debounce decision (Button::eventAtUs).
+ */
+void latencyBegin(ButtonId button, PendingAction action, uint32_t edgeAtUs,
+                  uint32_t decidedAtUs);
+
+/**
+ * @brief Timestamp a later point of the in-flight intent (no-op if none).
+ *
+ * Flushed closes the intent and records all histograms.
+ */
+void latencyMark(LatencyPoint point);
+
+/**
+ * @brief Snapshot p50/p95/p99/max summaries into RTC memory before sleep.
+ *
+ * The snapshot is shown as "last session" by "lat" after wake.
+ */
+void latencyPersistForSleep();
+
+/**
+ * @brief Console handler for "lat [reset]".
+ */
+void latencyCommand(const char *args);
+
+#endif // LATENCY_H
@@ -1,4 +1,6 @@
 #include "led.h"
+#include "energy.h"
+#include "trace.h"
 
 #include <Adafruit_NeoPixel.h>
 
@@ -6,12 +8,16 @@
 #define LED_PIN 21
 #define LED_COUNT 1
 
-// 0–255, where 255 = full blast.
-// Try 10–32 for “nice and dim but visible”.
-static constexpr uint8_t LED_BRIGHTNESS = 8;
-
 static Adafruit_NeoPixel led(LED_COUNT, LED_PIN, NEO_RGB + NEO_KHZ800);
 
+/**
+ * @brief Push the pixel buffer to the LED (traced; it's a blocking bit-bang).
+ */
+static void showLed() {
+  TRACE_SCOPE(TraceId::LedShow);
+  led.show();
+}
+
 /**
  * @brief Set the single NeoPixel to the specified RGB color and apply the
  * change.
@@ -19,13 +25,15 @@ static Adafruit_NeoPixel led(LED_COUNT, LED_PIN, NEO_RGB + NEO_KHZ800);
  * Sets the LED color using the provided red, green, and blue components and
  * updates the strip so the new color is visible.
  *
+ * @param color Which indicator color this is (energy accounting).
  * @param r Red component (0–255).
  * @param g Green component (0–255).
  * @param b Blue component (0–255).
  */
-static void setColor(uint8_t r, uint8_t g, uint8_t b) {
+static void setColor(EnergyLed color, uint8_t r, uint8_t g, uint8_t b) {
   led.setPixelColor(0, led.Color(r, g, b));
-  led.show();
+  showLed();
+  energySetLed(color, r, g, b, LED_BRIGHTNESS);
 }
 
 /**
@@ -39,7 +47,8 @@ void ledInit() {
   led.begin();
   led.setBrightness(LED_BRIGHTNESS);
   led.clear();
-  led.show();
+  showLed();
+  energySetLed(EnergyLed::Off, 0, 0, 0, LED_BRIGHTNESS);
 }
 
 /**
@@ -48,7 +57,7 @@ void ledInit() {
  * Updates the LED color to RGB(0, 0, 255) and applies the change.
  */
 void ledShowBoot() {
-  setColor(0, 0, 255); // Blue
+  setColor(EnergyLed::Blue, 0, 0, 255); // Blue
 }
 
 /**
@@ -57,14 +66,14 @@ void ledShowBoot() {
  * Updates the LED color to RGB(180, 0, 255) and applies the change.
  */
 void ledShowSleep() {
-  setColor(180, 0, 255); // magenta
+  setColor(EnergyLed::Magenta, 180, 0, 255); // magenta
 }
 
 /**
  * @brief Set the status LED to green to indicate the system is idle.
  */
 void ledShowIdle() {
-  setColor(0, 255, 0); // Green
+  setColor(EnergyLed::Green, 0, 255, 0); // Green
 }
 
 /**
@@ -73,7 +82,7 @@ void ledShowIdle() {
  * Sets the single RGB LED to yellow to represent the "updating" state.
  */
 void ledShowUpdating() {
-  setColor(255, 255, 0); // Yellow
+  setColor(EnergyLed::Yellow, 255, 255, 0); // Yellow
 }
 
 /**
@@ -83,5 +92,6 @@ void ledShowUpdating() {
  */
 void ledOff() {
   led.clear();
-  led.show();
+  showLed();
+  energySetLed(EnergyLed::Off, 0, 0, 0, LED_BRIGHTNESS);
 }
\ No newline at end of file
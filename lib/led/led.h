@@ -3,6 +3,10 @@
 
 #include <stdint.h>
 
+// 0–255, where 255 = full blast.
+// Try 10–32 for “nice and dim but visible”.
+static constexpr uint8_t LED_BRIGHTNESS = 8;
+
 // Initialize LED hardware
 void ledInit();
 
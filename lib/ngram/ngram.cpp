@@ -0,0 +1,158 @@
+#include "ngram.h"
+#include <string.h>
+
+static constexpr uint16_t END_WORD = 0;
+
+// ───────────────── Utilities ─────────────────
+
+/**
+ * @brief 32-bit FNV-1a; must match fnv1a() in scripts/bardpack/ngram.py.
+ */
+uint32_t ngramTextHash(const char *text, size_t length) {
+  uint32_t h = 0x811C9DC5UL;
+  for (size_t i = 0; i < length; ++i) {
+    h ^= static_cast<uint8_t>(text[i]);
+    h *= 0x01000193UL;
+  }
+  return h != 0 ? h : 1;
+}
+
+/**
+ * @brief xorshift32: small, fast, and fully determined by its seed.
+ */
+static uint32_t nextRandom(uint32_t &state) {
+  uint32_t x = state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  state = x;
+  return x;
+}
+
+/**
+ * @brief Find a context key in the sorted state table.
+ *
+ * @return State index, or NGRAM_STATE_COUNT if the model never saw it.
+ */
+static size_t findState(uint32_t key) {
+  size_t lo = 0;
+  size_t hi = NGRAM_STATE_COUNT;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (ngramStateKeys[mid] < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo < NGRAM_STATE_COUNT && ngramStateKeys[lo] == key) {
+    return lo;
+  }
+  return NGRAM_STATE_COUNT;
+}
+
+/**
+ * @brief Sample a successor: first cumulative weight above r < total.
+ */
+static uint16_t sampleNext(size_t state, uint32_t &rng) {
+  size_t lo = ngramStateFirst[state];
+  size_t hi = ngramStateFirst[state + 1];
+  const uint16_t total = ngramTransitions[hi - 1].cumulative;
+  const uint32_t r = nextRandom(rng) % total;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (ngramTransitions[mid].cumulative <= r) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return ngramTransitions[lo].word;
+}
+
+/**
+ * @brief One random walk from the start state into `out`.
+ *
+ * @return Length, or 0 if the walk ran too long or overflowed `out`.
+ */
+static size_t walk(uint32_t &rng, char *out, size_t capacity) {
+  uint32_t context = 0; // all END: start of line
+  size_t length = 0;
+
+  for (uint8_t words = 0; words <= NGRAM_MAX_WORDS; ++words) {
+    const size_t state = findState(context);
+    if (state == NGRAM_STATE_COUNT) {
+      return 0;
+    }
+    const uint16_t word = sampleNext(state, rng);
+    if (word == END_WORD) {
+      out[length] = '\0';
+      return length;
+    }
+
+    const char *text = ngramWordBlob + ngramWordOffsets[word];
+    const size_t wordLength = ngramWordOffsets[word + 1] - ngramWordOffsets[word] - 1;
+    const size_t needed = (length > 0 ? 1 : 0) + wordLength;
+    if (length + needed >= capacity) {
+      return 0;
+    }
+    if (length > 0) {
+      out[length++] = ' ';
+    }
+    memcpy(out + length, text, wordLength);
+    length += wordLength;
+
+    // Shift the new word into the context (NGRAM_ORDER-1 words of 16 bits).
+    context = NGRAM_ORDER > 2 ? ((context << 16) | word) : word;
+  }
+  return 0;
+}
+
+// ───────────────── API ─────────────────
+
+bool ngramIsTrainingLine(const char *text, size_t length) {
+  const uint32_t h = ngramTextHash(text, length);
+  size_t i = h & (NGRAM_NOVELTY_SLOTS - 1);
+  while (ngramNoveltyHashes[i] != 0) {
+    if (ngramNoveltyHashes[i] == h) {
+      return true;
+    }
+    i = (i + 1) & (NGRAM_NOVELTY_SLOTS - 1);
+  }
+  return false;
+}
+
+/**
+ * @brief Generate the line for `seed` into `out` (NUL-terminated).
+ */
+size_t ngramGenerate(uint32_t seed, char *out, size_t capacity,
+                     uint8_t *outAttempts) {
+  // Scramble the seed so neighbouring seeds don't start with similar streams;
+  // xorshift must not start at 0.
+  uint32_t rng = seed ^ 0x9E3779B9UL;
+  rng ^= rng >> 16;
+  rng *= 0x85EBCA6BUL;
+  rng ^= rng >> 13;
+  rng *= 0xC2B2AE35UL;
+  rng ^= rng >> 16;
+  if (rng == 0) {
+    rng = 0x6D2B79F5UL;
+  }
+
+  for (uint8_t attempt = 1; attempt <= NGRAM_MAX_ATTEMPTS; ++attempt) {
+    const size_t length = walk(rng, out, capacity);
+    if (length > 0 && !ngramIsTrainingLine(out, length)) {
+      if (outAttempts != nullptr) {
+        *outAttempts = attempt;
+      }
+      return length;
+    }
+  }
+  if (outAttempts != nullptr) {
+    *outAttempts = NGRAM_MAX_ATTEMPTS;
+  }
+  if (capacity > 0) {
+    out[0] = '\0';
+  }
+  return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef NGRAM_H
+#define NGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Generated at build time by scripts/pack_corpus.py (model sizes).
+#include "ngram_gen.h"
+
+// ─── N-gram generator ───────────────────────────────────────────
+//
+// A word-level Markov model of the corpus, trained by the pack step
+// (scripts/bardpack/ngram.py): states are the previous NGRAM_ORDER-1 words,
+// each with its successors and quantized cumulative weights. Generation walks
+// the model from a 32-bit seed, so the same seed always gives the same line
+// and history only needs to keep the seed, for as long as the model stays
+// the same (NGRAM_MODEL_HASH).
+
+struct NgramTransition {
+  uint16_t word;       // successor word id (0 = end of line)
+  uint16_t cumulative; // running sum of quantized weights within the state
+};
+
+// ─── Generated tables (flash) ───────────────────────────────────
+extern const char ngramWordBlob[];
+extern const uint16_t ngramWordOffsets[];
+extern const uint32_t ngramStateKeys[];
+extern const uint16_t ngramStateFirst[];
+extern const NgramTransition ngramTransitions[];
+extern const uint32_t ngramNoveltyHashes[];
+
+// Output buffer size; longer walks are rejected.
+static constexpr size_t NGRAM_TEXT_CAPACITY = 128;
+
+// Latency bound: at most NGRAM_MAX_ATTEMPTS walks of NGRAM_MAX_WORDS steps
+// per seed, each step two binary searches.
+static constexpr uint8_t NGRAM_MAX_WORDS = 24;
+static constexpr uint8_t NGRAM_MAX_ATTEMPTS = 8;
+
+// ─── API ────────────────────────────────────────────────────────
+
+/**
+ * @brief Generate the line for `seed` into `out` (NUL-terminated).
+ *
+ * Walks that copy a training line verbatim, run past NGRAM_MAX_WORDS or
+ * overflow `out` are rejected and the walk restarts from the same random
+ * stream, so the result depends on the seed alone.
+ *
+ * @param seed Any value; equal seeds give equal lines.
+ * @param out Receives codepage text.
+ * @param capacity Size of `out`; NGRAM_TEXT_CAPACITY suffices.
+ * @param outAttempts Optional; receives the number of walks taken.
+ * @return Length without the NUL, or 0 if no novel line came out within
+ * NGRAM_MAX_ATTEMPTS walks.
+ */
+size_t ngramGenerate(uint32_t seed, char *out, size_t capacity,
+                     uint8_t *outAttempts = nullptr);
+
+/**
+ * @brief Whether `text` is (by hash) one of the training lines.
+ */
+bool ngramIsTrainingLine(const char *text, size_t length);
+
+/**
+ * @brief 32-bit FNV-1a of `text`, never 0 (the novelty table's hash).
+ */
+uint32_t ngramTextHash(const char *text, size_t length);
+
+#endif // NGRAM_H
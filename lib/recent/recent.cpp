@@ -0,0 +1,62 @@
+#include "recent.h"
+#include <string.h>
+
+/**
+ * @brief Murmur3 finalizer: every input bit affects every output bit.
+ */
+static uint32_t mix(uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x85EBCA6B;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35;
+  h ^= h >> 16;
+  return h;
+}
+
+/**
+ * @brief The RECENT_HASHES bit positions of `id` (double hashing:
+ * h1 + i * h2, Kirsch–Mitzenmacher).
+ */
+static void positions(uint32_t id, uint32_t *out) {
+  const uint32_t h1 = mix(id);
+  const uint32_t h2 = mix(id ^ 0x9E3779B9) | 1;
+  for (uint32_t i = 0; i < RECENT_HASHES; ++i) {
+    out[i] = (h1 + i * h2) % RECENT_GENERATION_BITS;
+  }
+}
+
+static bool generationHas(const uint32_t *bits, const uint32_t *pos) {
+  for (uint32_t i = 0; i < RECENT_HASHES; ++i) {
+    if ((bits[pos[i] / 32] & (1u << (pos[i] % 32))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void recentClear(RecentFilter &filter) {
+  memset(&filter, 0, sizeof(filter));
+}
+
+bool recentContains(const RecentFilter &filter, uint32_t id) {
+  uint32_t pos[RECENT_HASHES];
+  positions(id, pos);
+  return generationHas(filter.bits[filter.current], pos) ||
+         generationHas(filter.bits[filter.current ^ 1], pos);
+}
+
+void recentInsert(RecentFilter &filter, uint32_t id) {
+  if (filter.inserted >= RECENT_WINDOW) {
+    filter.current ^= 1;
+    memset(filter.bits[filter.current], 0, sizeof(filter.bits[0]));
+    filter.inserted = 0;
+  }
+
+  uint32_t pos[RECENT_HASHES];
+  positions(id, pos);
+  uint32_t *bits = filter.bits[filter.current];
+  for (uint32_t i = 0; i < RECENT_HASHES; ++i) {
+    bits[pos[i] / 32] |= 1u << (pos[i] % 32);
+  }
+  filter.inserted++;
+}
@@ -0,0 +1,83 @@
+#ifndef RECENT_H
+#define RECENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ─── Recent-shows filter ────────────────────────────────────────
+//
+// "Was this content id shown within the last RECENT_WINDOW draws?" in a fixed
+// few hundred bytes, whatever the corpus size: an aging Bloom filter with two
+// generations. New ids go into the current generation; once it holds
+// RECENT_WINDOW ids, the older generation is cleared and becomes current. A
+// query checks both, so every id from the last RECENT_WINDOW (up to
+// 2 * RECENT_WINDOW - 1) inserts answers yes; no false negatives.
+//
+// False positives (an id that was not shown reads as recent) only cost a
+// retry; their rate is at most 2^-RECENT_FALSE_POSITIVE_LOG2.
+
+// Anti-repeat window K, in draws.
+static constexpr uint32_t RECENT_WINDOW = 512;
+
+// Target false-positive rate 2^-N for the pair of generations.
+static constexpr uint32_t RECENT_FALSE_POSITIVE_LOG2 = 6;
+
+// Each generation gets half the rate (2^-(N+1)): k = N+1 hashes and
+// k / ln 2 bits per id.
+static constexpr uint32_t RECENT_HASHES = RECENT_FALSE_POSITIVE_LOG2 + 1;
+
+/**
+ * @brief Bits in one generation for a window of `k` ids, in whole words.
+ */
+constexpr uint32_t recentGenerationBits(uint32_t k) {
+  return (k * RECENT_HASHES * 1443 / 1000 + 31) / 32 * 32;
+}
+
+/**
+ * @brief sizeof(RecentFilter) for a window of `k` ids.
+ *
+ * Two generations plus the word holding `inserted` and `current`.
+ */
+constexpr size_t recentFilterBytes(uint32_t k) {
+  return 2 * (recentGenerationBits(k) / 8) + sizeof(uint32_t);
+}
+
+static constexpr uint32_t RECENT_GENERATION_BITS =
+    recentGenerationBits(RECENT_WINDOW);
+static constexpr size_t RECENT_GENERATION_WORDS = RECENT_GENERATION_BITS / 32;
+
+struct RecentFilter {
+  uint32_t bits[2][RECENT_GENERATION_WORDS];
+  uint16_t inserted; // ids in the current generation
+  uint8_t current;   // 0 or 1
+};
+
+static_assert(sizeof(RecentFilter) == recentFilterBytes(RECENT_WINDOW),
+              "recentFilterBytes() out of sync with RecentFilter");
+
+// RTC slow memory is 8 KB, shared with the ULP program and
+// the other RTC_DATA_ATTR state.
+static constexpr size_t RECENT_RTC_BUDGET = 2048;
+static_assert(recentFilterBytes(RECENT_WINDOW) <= RECENT_RTC_BUDGET,
+              "RECENT_WINDOW / RECENT_FALSE_POSITIVE_LOG2 exceed the RTC "
+              "budget");
+static_assert(RECENT_WINDOW <= 0xFFFF, "inserted is 16-bit");
+
+/**
+ * @brief Forget everything.
+ */
+void recentClear(RecentFilter &filter);
+
+/**
+ * @brief Whether `id` may have been inserted within the window.
+ *
+ * Always true for ids from the last RECENT_WINDOW inserts.
+ */
+bool recentContains(const RecentFilter &filter, uint32_t id);
+
+/**
+ * @brief Record a shown id, aging out the oldest generation when full.
+ */
+void recentInsert(RecentFilter &filter, uint32_t id);
+
+#endif // RECENT_H
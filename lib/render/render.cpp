@@ -0,0 +1,140 @@
+#include "render.h"
+#include "clock.h"
+#include "content.h"
+#include "corpus.h"
+#include "display.h"
+#include "font.h"
+#include "latency.h"
+#include "trace.h"
+
+#include <string.h>
+
+// ───────────────── Raster cache ─────────────────
+
+/**
+ * @brief Find an insult in the (sorted) raster cache.
+ *
+ * @return Cache slot, or RASTER_CACHE_COUNT if not cached.
+ */
+static size_t findCachedBody(uint16_t index) {
+  size_t lo = 0;
+  size_t hi = RASTER_CACHE_COUNT;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (rasterCacheIndices[mid] < index) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo < RASTER_CACHE_COUNT && rasterCacheIndices[lo] == index) {
+    return lo;
+  }
+  return RASTER_CACHE_COUNT;
+}
+
+/**
+ * @brief Expand one compressed body over the framebuffer body rows.
+ *
+ * Tokens are zero-word runs (memset) or literal-word runs (memcpy). Literal
+ * words are stored little-endian, which is the ESP32's native order.
+ */
+static void expandBody(const uint8_t *p, const uint8_t *end) {
+  uint32_t *out = displayFramebuffer[BODY_Y];
+  uint32_t *const outEnd = out + static_cast<size_t>(BODY_HEIGHT) *
+                                     DISPLAY_WORDS_PER_ROW;
+
+  while (p < end && out < outEnd) {
+    const uint8_t token = *p++;
+    const size_t words = (token & 0x7F) + 1u;
+    const size_t room = static_cast<size_t>(outEnd - out);
+    const size_t fit = words < room ? words : room;
+
+    if (token & 0x80) {
+      memcpy(out, p, fit * sizeof(uint32_t));
+      p += words * sizeof(uint32_t);
+    } else {
+      memset(out, 0, fit * sizeof(uint32_t));
+    }
+    out += fit;
+  }
+}
+
+// ───────────────── API ─────────────────
+
+/**
+ * @brief Expand a cached body over the body rows of the framebuffer.
+ */
+bool renderBodyCached(uint16_t index) {
+  TRACE_SCOPE(TraceId::RenderBodyCached);
+  const size_t slot = findCachedBody(index);
+  if (slot == RASTER_CACHE_COUNT) {
+    return false;
+  }
+  expandBody(rasterCacheData + rasterCacheOffsets[slot],
+             rasterCacheData + rasterCacheOffsets[slot + 1]);
+  return true;
+}
+
+/**
+ * @brief Draw laid-out text centered in the body box.
+ *
+ * Line breaks and widths come with the layout, so this only computes
+ * positions and blits glyphs.
+ */
+void renderBodyText(const char *text, const CorpusTextLayout &layout) {
+  const uint16_t pitch = (FONT_HEIGHT + FONT_LINE_GAP) * layout.scale;
+  const uint16_t blockHeight =
+      layout.lineCount * pitch - FONT_LINE_GAP * layout.scale;
+  uint16_t y = BODY_Y + (BODY_HEIGHT - blockHeight) / 2;
+
+  for (uint8_t i = 0; i < layout.lineCount; ++i) {
+    const CorpusLine &line = layout.lines[i];
+    const uint16_t x = BODY_X + (BODY_WIDTH - line.width) / 2;
+    fontDrawText(text + line.start, line.length, x, y, layout.scale);
+    y += pitch;
+  }
+}
+
+/**
+ * @brief Draw a corpus insult body from its pack-time layout.
+ */
+bool renderBodyLive(uint16_t index) {
+  TRACE_SCOPE(TraceId::RenderBodyLive);
+  CorpusTextLayout layout;
+  if (!corpusGetLayout(index, layout)) {
+    return false;
+  }
+  renderBodyText(corpusText(index), layout);
+  return true;
+}
+
+/**
+ * @brief Draw a full insult screen (header + body) and flush the panel.
+ */
+void renderInsultScreen(uint32_t id, const char *reason,
+                        const char *action) {
+  ClockBoost boost;
+  displayClear();
+
+  uint16_t headerX = PANEL_MARGIN;
+  headerX += fontDrawText(reason, strlen(reason), headerX, PANEL_MARGIN, 1);
+  if (action != nullptr) {
+    headerX += fontDrawText(" ", 1, headerX, PANEL_MARGIN, 1);
+    fontDrawText(action, strlen(action), headerX, PANEL_MARGIN, 1);
+  }
+
+  uint16_t corpusIndex = 0;
+  const bool cached =
+      contentCorpusIndex(id, corpusIndex) && renderBodyCached(corpusIndex);
+  if (!cached) {
+    TRACE_SCOPE(TraceId::RenderBodyLive);
+    ContentText content;
+    if (contentResolve(id, content)) {
+      renderBodyText(content.text, content.layout);
+    }
+  }
+
+  displayFlush();
+  latencyMark(LatencyPoint::Flushed);
+}
@@ -0,0 +1,54 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "corpus.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Generated at build time by scripts/pack_corpus.py (raster cache size).
+#include "raster_gen.h"
+
+// ─── Pre-rasterized bodies (flash) ──────────────────────────────
+//
+// The pack step renders the body box of the hottest insults ahead of time
+// and stores the framebuffer rows compressed. Which insults, and how much
+// flash that may take, is set by custom_raster_cache_lines /
+// custom_raster_cache_budget in platformio.ini and assets/hotlist.txt.
+extern const uint16_t rasterCacheIndices[];
+extern const uint32_t rasterCacheOffsets[];
+extern const uint8_t rasterCacheData[];
+
+// ─── API ────────────────────────────────────────────────────────
+
+/**
+ * @brief Draw a full insult screen (header + body) and flush the panel.
+ *
+ * The body comes from the raster cache when the insult is a cached corpus
+ * line, otherwise from its layout (pack-time or runtime) + glyph blits.
+ *
+ * @param id Content id (content.h).
+ * @param reason Header label, e.g. "[Done]".
+ * @param action Optional second header label, e.g. "(Random)"; may be null.
+ */
+void renderInsultScreen(uint32_t id, const char *reason, const char *action);
+
+/**
+ * @brief Draw a corpus insult body from its layout (no cache). Doesn't clear.
+ *
+ * @return false if the index has no layout.
+ */
+bool renderBodyLive(uint16_t index);
+
+/**
+ * @brief Draw laid-out text centered in the body box. Doesn't clear.
+ */
+void renderBodyText(const char *text, const CorpusTextLayout &layout);
+
+/**
+ * @brief Expand a cached body over the body rows of the framebuffer.
+ *
+ * @return false (framebuffer untouched) if the insult isn't cached.
+ */
+bool renderBodyCached(uint16_t index);
+
+#endif // RENDER_H
@@ -0,0 +1,323 @@
+#include "search.h"
+#include "content.h"
+#include "corpus.h"
+#include "font.h"
+#include "insults.h"
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Longest insult verified, in folded bytes; the panel fits far fewer
+// characters than this, so nothing is ever cut off.
+static constexpr size_t SEARCH_LINE_MAX = 512;
+// Distinct trigrams a SEARCH_QUERY_MAX-byte query can have.
+static constexpr size_t SEARCH_QUERY_TRIGRAMS = SEARCH_QUERY_MAX - 2;
+
+// Results of the last `find`, for `find #N`.
+static uint32_t lastResults[SEARCH_RESULTS_MAX];
+static size_t lastResultCount = 0;
+
+// ───────────────── Folding ─────────────────
+
+/**
+ * @brief Codepage byte for a code point; 0 if the corpus never uses it.
+ */
+static uint8_t codeForCodepoint(uint32_t cp) {
+  if (cp >= 0x20 && cp <= 0x7E) {
+    return static_cast<uint8_t>(cp);
+  }
+  for (uint32_t code = 0x80; code <= FONT_LAST_CODE; ++code) {
+    if (fontCodepage[code - FONT_FIRST_CODE] == cp) {
+      return static_cast<uint8_t>(code);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Append one codepage byte to folded text (see search.py).
+ */
+static void appendFolded(uint8_t code, uint8_t *out, size_t &length,
+                         size_t capacity) {
+  const uint8_t folded = searchFold[code];
+  if (folded != 0) {
+    if (length < capacity) {
+      out[length++] = folded;
+    }
+  } else if (length > 0 && out[length - 1] != ' ' && length < capacity) {
+    out[length++] = ' ';
+  }
+}
+
+static size_t trimFolded(const uint8_t *text, size_t length) {
+  return length > 0 && text[length - 1] == ' ' ? length - 1 : length;
+}
+
+/**
+ * @brief Fold a UTF-8 query. Characters outside the codepage act as
+ * separators: no insult contains them anyway.
+ */
+static size_t foldQuery(const char *query, uint8_t *out) {
+  size_t length = 0;
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(query);
+  while (*p != '\0') {
+    uint32_t cp = *p++;
+    size_t extra = cp >= 0xF0 ? 3 : cp >= 0xE0 ? 2 : cp >= 0xC0 ? 1 : 0;
+    cp &= extra == 3 ? 0x07 : extra == 2 ? 0x0F : extra == 1 ? 0x1F : 0x7F;
+    for (; extra > 0 && (*p & 0xC0) == 0x80; --extra) {
+      cp = (cp << 6) | (*p++ & 0x3F);
+    }
+    appendFolded(codeForCodepoint(cp), out, length, SEARCH_QUERY_MAX);
+  }
+  return trimFolded(out, length);
+}
+
+static size_t foldLine(uint32_t index, uint8_t *out) {
+  size_t length = 0;
+  for (const char *p = corpusText(index); *p != '\0'; ++p) {
+    appendFolded(static_cast<uint8_t>(*p), out, length, SEARCH_LINE_MAX);
+  }
+  return trimFolded(out, length);
+}
+
+static bool containsFolded(const uint8_t *text, size_t length,
+                           const uint8_t *query, size_t queryLength) {
+  for (size_t i = 0; i + queryLength <= length; ++i) {
+    if (text[i] == query[0] &&
+        memcmp(text + i, query, queryLength) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ───────────────── Posting lists ─────────────────
+
+struct PostingCursor {
+  const uint8_t *next;
+  uint32_t left;
+  uint32_t value;
+};
+
+static uint32_t readVarint(const uint8_t *&p) {
+  uint32_t value = 0;
+  for (uint8_t shift = 0;; shift += 7) {
+    const uint8_t b = *p++;
+    value |= static_cast<uint32_t>(b & 0x7F) << shift;
+    if (b < 0x80) {
+      return value;
+    }
+  }
+}
+
+static PostingCursor cursorAt(size_t list) {
+  PostingCursor cursor;
+  cursor.next = searchPostings + searchOffsets[list];
+  cursor.left = readVarint(cursor.next);
+  cursor.value = 0;
+  return cursor;
+}
+
+static bool cursorAdvance(PostingCursor &cursor) {
+  if (cursor.left == 0) {
+    return false;
+  }
+  cursor.value += readVarint(cursor.next);
+  cursor.left--;
+  return true;
+}
+
+/**
+ * @brief Index of `key` in searchKeys[], or -1.
+ */
+static int32_t findKey(uint32_t key) {
+  size_t lo = 0;
+  size_t hi = SEARCH_TRIGRAM_COUNT;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (searchKeys[mid] < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo < SEARCH_TRIGRAM_COUNT && searchKeys[lo] == key
+             ? static_cast<int32_t>(lo)
+             : -1;
+}
+
+// ───────────────── Query ─────────────────
+
+struct QueryState {
+  const uint8_t *folded;
+  size_t length;
+  uint32_t *out;
+  size_t capacity;
+  size_t written;
+};
+
+/**
+ * @brief Check one candidate line.
+ *
+ * @return false once the results are full (the candidate is not checked).
+ */
+static bool verify(QueryState &query, uint32_t index, SearchStats &stats) {
+  static uint8_t line[SEARCH_LINE_MAX];
+  if (query.written == query.capacity) {
+    stats.truncated = true;
+    return false;
+  }
+  stats.candidates++;
+  const size_t length = foldLine(index, line);
+  if (containsFolded(line, length, query.folded, query.length)) {
+    query.out[query.written++] = index;
+  }
+  return true;
+}
+
+size_t searchFind(const char *text, uint32_t *out, size_t capacity,
+                  SearchStats &stats) {
+  memset(&stats, 0, sizeof(stats));
+  uint8_t folded[SEARCH_QUERY_MAX];
+  QueryState query = {folded, foldQuery(text, folded), out, capacity, 0};
+  if (query.length == 0) {
+    return 0;
+  }
+
+  if (query.length < 3) {
+    for (uint32_t index = 0; index < CORPUS_INSULT_COUNT; ++index) {
+      if (!verify(query, index, stats)) {
+        break;
+      }
+    }
+    return query.written;
+  }
+
+  // Distinct trigrams with their list lengths, rarest first.
+  uint32_t lists[SEARCH_QUERY_TRIGRAMS];
+  uint32_t counts[SEARCH_QUERY_TRIGRAMS];
+  size_t listCount = 0;
+  for (size_t i = 0; i + 2 < query.length; ++i) {
+    const uint32_t key = static_cast<uint32_t>(folded[i]) << 16 |
+                         static_cast<uint32_t>(folded[i + 1]) << 8 |
+                         folded[i + 2];
+    const int32_t list = findKey(key);
+    if (list < 0) {
+      return 0; // some trigram occurs nowhere
+    }
+    bool seen = false;
+    for (size_t j = 0; j < listCount && !seen; ++j) {
+      seen = lists[j] == static_cast<uint32_t>(list);
+    }
+    if (seen) {
+      continue;
+    }
+    const uint32_t count = cursorAt(list).left;
+    size_t at = listCount++;
+    for (; at > 0 && counts[at - 1] > count; --at) {
+      lists[at] = lists[at - 1];
+      counts[at] = counts[at - 1];
+    }
+    lists[at] = list;
+    counts[at] = count;
+  }
+  stats.trigrams = static_cast<uint8_t>(listCount);
+
+  size_t used = 1;
+  while (used < listCount && used < SEARCH_INTERSECT_LISTS &&
+         counts[used] <= counts[0] * SEARCH_LIST_RATIO) {
+    used++;
+  }
+  stats.listsUsed = static_cast<uint8_t>(used);
+
+  PostingCursor cursors[SEARCH_INTERSECT_LISTS];
+  for (size_t j = 0; j < used; ++j) {
+    cursors[j] = cursorAt(lists[j]);
+    if (j > 0) {
+      cursorAdvance(cursors[j]); // lists are never empty
+    }
+  }
+
+  while (cursorAdvance(cursors[0])) {
+    const uint32_t index = cursors[0].value;
+    bool inAll = true;
+    for (size_t j = 1; j < used && inAll; ++j) {
+      while (cursors[j].value < index) {
+        if (!cursorAdvance(cursors[j])) {
+          return query.written; // list j is exhausted: no more matches
+        }
+      }
+      inAll = cursors[j].value == index;
+    }
+    if (inAll && !verify(query, index, stats)) {
+      break;
+    }
+  }
+  return query.written;
+}
+
+// ───────────────── Console ─────────────────
+
+static void printInsultText(uint32_t index) {
+  const char *text = corpusText(index);
+  char utf8[3];
+  for (size_t i = 0; text[i] != '\0'; ++i) {
+    const size_t n = fontCodeToUtf8(static_cast<uint8_t>(text[i]), utf8);
+    Serial.write(reinterpret_cast<const uint8_t *>(utf8), n);
+  }
+  Serial.println();
+}
+
+static void showResult(const char *arg) {
+  char *end = nullptr;
+  const unsigned long n = strtoul(arg, &end, 10);
+  if (end == arg || *end != '\0' || n == 0 || n > lastResultCount) {
+    Serial.printf("[Find] no result #%s (last search had %u)\n", arg,
+                  static_cast<unsigned>(lastResultCount));
+    return;
+  }
+  const uint32_t id =
+      contentCorpusId(static_cast<uint16_t>(lastResults[n - 1]));
+  if (!insultsShow(id)) {
+    Serial.println(F("[Find] busy; try again when the panel is idle"));
+  }
+}
+
+void searchCommand(const char *args) {
+  if (*args == '\0') {
+    Serial.println(F("[Find] usage: find <text> | find #N"));
+    return;
+  }
+  if (args[0] == '#') {
+    showResult(args + 1);
+    return;
+  }
+
+  SearchStats stats;
+  const uint32_t start = micros();
+  lastResultCount =
+      searchFind(args, lastResults, SEARCH_RESULTS_MAX, stats);
+  const uint32_t elapsedUs = micros() - start;
+
+  Serial.printf("[Find] %u%s matches in %lu us (",
+                static_cast<unsigned>(lastResultCount),
+                stats.truncated ? "+" : "",
+                static_cast<unsigned long>(elapsedUs));
+  if (stats.listsUsed == 0) {
+    Serial.printf("scan, %lu verified)\n",
+                  static_cast<unsigned long>(stats.candidates));
+  } else {
+    Serial.printf("%u of %u trigram lists, %lu verified)\n", stats.listsUsed,
+                  stats.trigrams, static_cast<unsigned long>(stats.candidates));
+  }
+  for (size_t i = 0; i < lastResultCount; ++i) {
+    Serial.printf("  #%u ", static_cast<unsigned>(i + 1));
+    printInsultText(lastResults[i]);
+  }
+  if (stats.truncated) {
+    Serial.println(F("  ... more may match; narrow the search"));
+  }
+  if (lastResultCount > 0) {
+    Serial.println(F("  find #N shows one on the panel"));
+  }
+}
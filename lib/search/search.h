@@ -0,0 +1,65 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Generated at build time by scripts/pack_corpus.py (index sizes).
+#include "search_gen.h"
+
+// ─── Full-text search ───────────────────────────────────────────
+//
+// `find <text>` lists the corpus insults containing <text>, ignoring case
+// and punctuation; `find #N` shows result N on the panel and appends it to
+// history.
+//
+// The pack step builds a trigram index (scripts/bardpack/search.py): one
+// delta + varint posting list per trigram of the folded text. A query looks
+// up its trigrams, intersects the rarest lists and verifies each candidate
+// against the text, since sharing all trigrams doesn't make a substring.
+// Queries shorter than a trigram scan the whole corpus.
+
+// Longest query kept, in folded bytes (the rest is ignored).
+static constexpr size_t SEARCH_QUERY_MAX = 64;
+// Results `find` prints and remembers for `find #N`.
+static constexpr size_t SEARCH_RESULTS_MAX = 10;
+// Lists intersected at most; the other trigrams are left to verification.
+static constexpr size_t SEARCH_INTERSECT_LISTS = 4;
+// A list joins the intersection only while it is at most this many times
+// longer than the rarest one; past that, walking it costs more than
+// verifying the candidates it would reject.
+static constexpr uint32_t SEARCH_LIST_RATIO = 16;
+
+// Index tables (flash), see search_gen.cpp.
+extern const uint8_t searchFold[256];
+extern const uint32_t searchKeys[];
+extern const uint32_t searchOffsets[];
+extern const uint8_t searchPostings[];
+
+struct SearchStats {
+  uint32_t candidates; // lines verified against the text
+  uint8_t trigrams;    // distinct trigrams in the query
+  uint8_t listsUsed;   // 0 = full scan
+  bool truncated;      // stopped with `out` full; more lines may match
+};
+
+// ─── API ────────────────────────────────────────────────────────
+
+/**
+ * @brief Corpus insults containing `query`, in corpus order.
+ *
+ * @param query UTF-8 text; matched case-insensitively, with punctuation and
+ * whitespace runs treated as one space.
+ * @param out Receives up to `capacity` corpus indices. The search stops once
+ * it is full, so a common word costs no more than a rare one.
+ * @return Indices written to `out`.
+ */
+size_t searchFind(const char *query, uint32_t *out, size_t capacity,
+                  SearchStats &stats);
+
+/**
+ * @brief Console handler for "find <text>" and "find #N".
+ */
+void searchCommand(const char *args);
+
+#endif // SEARCH_H
@@ -0,0 +1,366 @@
+#include "tags.h"
+#include <Arduino.h>
+#include <string.h>
+
+static constexpr size_t TAG_SET_WORDS = (CORPUS_INSULT_COUNT + 31) / 32;
+static constexpr size_t TAG_FILTER_CAPACITY = 48;
+static constexpr size_t TAG_NAME_CAPACITY = 16;
+static constexpr size_t TAG_CHUNK_BITS = 256;
+
+static_assert(TAG_SET_WORDS > 0, "tag sets need at least one insult");
+
+// ───────────────── State ─────────────────
+
+// The filter text and the round survive deep sleep; the active set and the
+// Fenwick tree are rebuilt from them on wake.
+static RTC_DATA_ATTR char filterText[TAG_FILTER_CAPACITY] = {0};
+static RTC_DATA_ATTR uint32_t remaining[TAG_SET_WORDS] = {0};
+static RTC_DATA_ATTR uint16_t lastDrawn = 0xFFFF;
+
+static uint32_t active[TAG_SET_WORDS] = {0};
+static uint16_t activeCount = 0;
+
+// fenwick[i] (1-based) sums popcount(remaining[]) over a power-of-two span
+// ending at word i-1.
+static uint16_t fenwick[TAG_SET_WORDS + 1] = {0};
+
+// ───────────────── Bit sets ─────────────────
+
+static uint16_t popcount(uint32_t word) {
+  return static_cast<uint16_t>(__builtin_popcount(word));
+}
+
+static void setClear(uint32_t *set) {
+  memset(set, 0, TAG_SET_WORDS * sizeof(uint32_t));
+}
+
+/**
+ * @brief All corpus insults (the bits past CORPUS_INSULT_COUNT stay clear).
+ */
+static void setFill(uint32_t *set) {
+  memset(set, 0xFF, TAG_SET_WORDS * sizeof(uint32_t));
+  if (CORPUS_INSULT_COUNT % 32 != 0) {
+    set[TAG_SET_WORDS - 1] = (1u << (CORPUS_INSULT_COUNT % 32)) - 1;
+  }
+}
+
+static uint16_t setCount(const uint32_t *set) {
+  uint16_t count = 0;
+  for (size_t i = 0; i < TAG_SET_WORDS; ++i) {
+    count += popcount(set[i]);
+  }
+  return count;
+}
+
+/**
+ * @brief Expand one tag's containers into a plain bitmap.
+ */
+static void expandTag(size_t tag, uint32_t *out) {
+  setClear(out);
+  for (uint16_t c = tagFirstContainer[tag]; c < tagFirstContainer[tag + 1];
+       ++c) {
+    const TagContainer &container = tagContainers[c];
+    const size_t base = container.key * TAG_CHUNK_BITS;
+    const uint8_t *data = tagData + container.offset;
+    if (container.kind == TagContainerKind::Bitmap) {
+      // 32 bytes, bit i of byte j = member base + 8j + i.
+      for (size_t j = 0; j < TAG_CHUNK_BITS / 8; ++j) {
+        const size_t word = (base + 8 * j) / 32;
+        if (word < TAG_SET_WORDS) {
+          out[word] |= static_cast<uint32_t>(data[j]) << ((8 * j) % 32);
+        }
+      }
+    } else {
+      for (uint16_t j = 0; j < container.cardinality; ++j) {
+        const size_t index = base + data[j];
+        out[index / 32] |= 1u << (index % 32);
+      }
+    }
+  }
+}
+
+// ───────────────── Rank / select ─────────────────
+
+static void fenwickBuild() {
+  memset(fenwick, 0, sizeof(fenwick));
+  for (size_t i = 1; i <= TAG_SET_WORDS; ++i) {
+    fenwick[i] += popcount(remaining[i - 1]);
+    const size_t parent = i + (i & (~i + 1));
+    if (parent <= TAG_SET_WORDS) {
+      fenwick[parent] += fenwick[i];
+    }
+  }
+}
+
+static void fenwickDecrement(size_t word) {
+  for (size_t i = word + 1; i <= TAG_SET_WORDS; i += i & (~i + 1)) {
+    fenwick[i]--;
+  }
+}
+
+static uint16_t fenwickTotal() {
+  uint16_t total = 0;
+  for (size_t i = TAG_SET_WORDS; i > 0; i -= i & (~i + 1)) {
+    total += fenwick[i];
+  }
+  return total;
+}
+
+/**
+ * @brief Index of the k-th (0-based) member of remaining[].
+ *
+ * Descends the Fenwick tree to the word holding it, then walks that word's
+ * set bits.
+ */
+static uint16_t selectRemaining(uint16_t k) {
+  size_t step = 1;
+  while (step * 2 <= TAG_SET_WORDS) {
+    step *= 2;
+  }
+
+  size_t word = 0; // words fully skipped
+  for (; step > 0; step /= 2) {
+    if (word + step <= TAG_SET_WORDS && fenwick[word + step] <= k) {
+      word += step;
+      k -= fenwick[word];
+    }
+  }
+
+  uint32_t bits = remaining[word];
+  for (; k > 0; --k) {
+    bits &= bits - 1; // drop the lowest set bit
+  }
+  return static_cast<uint16_t>(word * 32 + __builtin_ctz(bits));
+}
+
+static void startRound() {
+  memcpy(remaining, active, sizeof(remaining));
+  fenwickBuild();
+}
+
+// ───────────────── Filter expressions ─────────────────
+
+static size_t findTag(const char *name) {
+  size_t lo = 0;
+  size_t hi = TAG_COUNT;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    const int cmp = strcmp(tagNames[mid], name);
+    if (cmp == 0) {
+      return mid;
+    }
+    if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return TAG_COUNT;
+}
+
+static bool isNameChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-';
+}
+
+static const char *skipSpaces(const char *p) {
+  while (*p == ' ') {
+    ++p;
+  }
+  return p;
+}
+
+/**
+ * @brief Evaluate "a&b|c" (OR of AND-terms) into out.
+ */
+static TagFilterResult evaluate(const char *expr, uint32_t *out) {
+  static uint32_t term[TAG_SET_WORDS];
+  static uint32_t members[TAG_SET_WORDS];
+
+  setClear(out);
+  const char *p = expr;
+  for (;;) {
+    setFill(term);
+    for (;;) {
+      p = skipSpaces(p);
+      char name[TAG_NAME_CAPACITY];
+      size_t length = 0;
+      while (isNameChar(*p)) {
+        if (length + 1 >= sizeof(name)) {
+          return TagFilterResult::UnknownTag;
+        }
+        name[length++] = *p++;
+      }
+      if (length == 0) {
+        return TagFilterResult::Syntax;
+      }
+      name[length] = '\0';
+
+      const size_t tag = findTag(name);
+      if (tag == TAG_COUNT) {
+        return TagFilterResult::UnknownTag;
+      }
+      expandTag(tag, members);
+      for (size_t i = 0; i < TAG_SET_WORDS; ++i) {
+        term[i] &= members[i];
+      }
+
+      p = skipSpaces(p);
+      if (*p != '&') {
+        break;
+      }
+      ++p;
+    }
+
+    for (size_t i = 0; i < TAG_SET_WORDS; ++i) {
+      out[i] |= term[i];
+    }
+    if (*p == '\0') {
+      return TagFilterResult::Ok;
+    }
+    if (*p != '|') {
+      return TagFilterResult::Syntax;
+    }
+    ++p;
+  }
+}
+
+static bool isClearWord(const char *expr) {
+  const char *p = skipSpaces(expr);
+  return *p == '\0' || strcmp(p, "off") == 0 || strcmp(p, "all") == 0;
+}
+
+// ───────────────── API ─────────────────
+
+void tagsInit(bool wokeFromSleep) {
+  if (!wokeFromSleep || filterText[0] == '\0') {
+    filterText[0] = '\0';
+    activeCount = 0;
+    lastDrawn = 0xFFFF;
+    return;
+  }
+
+  // Same assets, same result; if it somehow fails, drop the filter.
+  if (evaluate(filterText, active) != TagFilterResult::Ok ||
+      (activeCount = setCount(active)) == 0) {
+    filterText[0] = '\0';
+    activeCount = 0;
+    return;
+  }
+  for (size_t i = 0; i < TAG_SET_WORDS; ++i) {
+    remaining[i] &= active[i];
+  }
+  fenwickBuild();
+}
+
+TagFilterResult tagsSetFilter(const char *expr) {
+  if (isClearWord(expr)) {
+    filterText[0] = '\0';
+    activeCount = 0;
+    return TagFilterResult::Cleared;
+  }
+  if (strlen(expr) >= TAG_FILTER_CAPACITY) {
+    return TagFilterResult::Syntax;
+  }
+
+  static uint32_t candidate[TAG_SET_WORDS];
+  const TagFilterResult result = evaluate(expr, candidate);
+  if (result != TagFilterResult::Ok) {
+    return result;
+  }
+  const uint16_t count = setCount(candidate);
+  if (count == 0) {
+    return TagFilterResult::Empty;
+  }
+
+  memcpy(active, candidate, sizeof(active));
+  activeCount = count;
+  strcpy(filterText, expr);
+  startRound();
+  return TagFilterResult::Ok;
+}
+
+bool tagsFilterActive() { return activeCount > 0; }
+
+uint16_t tagsDraw(uint32_t (*random32)(), bool (*avoid)(uint16_t index)) {
+  if (activeCount == 0) {
+    return 0;
+  }
+
+  uint16_t total = fenwickTotal();
+  const bool newRound = total == 0;
+  if (newRound) {
+    startRound();
+    total = activeCount;
+  }
+
+  uint16_t k = static_cast<uint16_t>(random32() % total);
+  uint16_t index = selectRemaining(k);
+  for (uint8_t i = 1; i < TAGS_AVOID_TRIES && total > 1 && avoid &&
+                      avoid(index);
+       ++i) {
+    k = static_cast<uint16_t>(random32() % total);
+    index = selectRemaining(k);
+  }
+  // Only a fresh round can still contain the last insult shown.
+  if (newRound && index == lastDrawn && total > 1) {
+    k = static_cast<uint16_t>((k + 1) % total);
+    index = selectRemaining(k);
+  }
+
+  remaining[index / 32] &= ~(1u << (index % 32));
+  fenwickDecrement(index / 32);
+  lastDrawn = index;
+  return index;
+}
+
+// ───────────────── Console ─────────────────
+
+static void printTags() {
+  Serial.printf("[Tags] filter: %s (%u of %u insults)\n",
+                filterText[0] != '\0' ? filterText : "off",
+                static_cast<unsigned>(activeCount != 0 ? activeCount
+                                                       : CORPUS_INSULT_COUNT),
+                static_cast<unsigned>(CORPUS_INSULT_COUNT));
+  for (size_t i = 0; i < TAG_COUNT; ++i) {
+    Serial.printf("  %-12s %5u\n", tagNames[i],
+                  static_cast<unsigned>(tagMemberCounts[i]));
+  }
+}
+
+/**
+ * @brief Console handler for "filter [expr|off]".
+ *
+ * - (none): current filter and the tags with their member counts
+ * - expr: tag names joined by & (and) and | (or), & binding tighter
+ * - off: draw from everything again
+ */
+void tagsCommand(const char *args) {
+  if (*skipSpaces(args) == '\0') {
+    printTags();
+    return;
+  }
+
+  const uint32_t startUs = micros();
+  const TagFilterResult result = tagsSetFilter(args);
+  const uint32_t elapsedUs = micros() - startUs;
+
+  switch (result) {
+  case TagFilterResult::Ok:
+    Serial.printf("[Tags] filter %s: %u insults (%lu us)\n", filterText,
+                  static_cast<unsigned>(activeCount),
+                  static_cast<unsigned long>(elapsedUs));
+    break;
+  case TagFilterResult::Cleared:
+    Serial.println(F("[Tags] filter off"));
+    break;
+  case TagFilterResult::Syntax:
+    Serial.println(F("[Tags] usage: filter <tag[&tag...]|...>|off"));
+    break;
+  case TagFilterResult::UnknownTag:
+    Serial.println(F("[Tags] unknown tag (run \"filter\" for the list)"));
+    break;
+  case TagFilterResult::Empty:
+    Serial.println(F("[Tags] no insult matches; filter unchanged"));
+    break;
+  }
+}
@@ -0,0 +1,89 @@
+#ifndef TAGS_H
+#define TAGS_H
+
+#include "corpus.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Generated at build time by scripts/pack_corpus.py (tag table sizes).
+#include "tags_gen.h"
+
+// ─── Tag index ──────────────────────────────────────────────────
+//
+// Corpus insults carry tags ({tags=pg,pirate} in assets/insults.txt, plus the
+// derived "short"). Each tag's members are stored roaring-style: one
+// container per 256-index chunk, either a sorted byte array or a 256-bit
+// bitmap (scripts/bardpack/tags.py).
+//
+// A filter such as "pg&short|pirate" (& binds tighter than |) is evaluated
+// into an active-set bitmap once, when it changes. Draws then pick uniformly
+// among the active insults not yet shown this round, by rank/select over a
+// Fenwick tree of per-word popcounts: O(log n) per draw, no corpus scan.
+
+enum class TagContainerKind : uint8_t { Array = 0, Bitmap };
+
+struct TagContainer {
+  uint8_t key; // chunk: insult index / 256
+  TagContainerKind kind;
+  uint16_t cardinality;
+  uint16_t offset; // into tagData[]
+};
+
+// ─── Generated tables (flash) ───────────────────────────────────
+extern const char *const tagNames[];
+extern const uint16_t tagMemberCounts[];
+extern const uint16_t tagFirstContainer[];
+extern const TagContainer tagContainers[];
+extern const uint8_t tagData[];
+
+enum class TagFilterResult : uint8_t {
+  Ok,
+  Cleared,
+  Syntax,     // expected tag names joined by & and |
+  UnknownTag, // a name that no insult carries
+  Empty       // valid, but matches no insult
+};
+
+// Picks tagsDraw() makes before taking an insult its `avoid` flags.
+static constexpr uint8_t TAGS_AVOID_TRIES = 4;
+
+// ─── API ────────────────────────────────────────────────────────
+
+/**
+ * @brief Restore the filter after deep sleep, or clear it on cold boot.
+ */
+void tagsInit(bool wokeFromSleep);
+
+/**
+ * @brief Set the draw filter.
+ *
+ * On anything but Ok/Cleared the previous filter stays in place.
+ *
+ * @param expr "tag&tag|tag"; empty, "off" or "all" clears the filter.
+ */
+TagFilterResult tagsSetFilter(const char *expr);
+
+/**
+ * @brief Whether corpus draws are currently restricted by a filter.
+ */
+bool tagsFilterActive();
+
+/**
+ * @brief Draw an active insult; no repeats until the active set is used up.
+ *
+ * Only meaningful while tagsFilterActive().
+ *
+ * @param random32 Uniform 32-bit random source.
+ * @param avoid Optional: insults to re-pick (up to TAGS_AVOID_TRIES times)
+ * before taking one anyway. Passed-over insults stay in the round.
+ * @return Corpus index.
+ */
+uint16_t tagsDraw(uint32_t (*random32)(),
+                  bool (*avoid)(uint16_t index) = nullptr);
+
+/**
+ * @brief Console handler for "filter [expr|off]".
+ */
+void tagsCommand(const char *args);
+
+#endif // TAGS_H
@@ -0,0 +1,178 @@
+#include "trace.h"
+#include <Arduino.h>
+#include <string.h>
+
+#if BARD_TRACE
+
+// Power of two so the ring index is a mask.
+static constexpr uint32_t TRACE_RING_CAPACITY = 1024;
+static_assert((TRACE_RING_CAPACITY & (TRACE_RING_CAPACITY - 1)) == 0,
+              "ring capacity must be a power of two");
+
+enum class TraceMode : uint8_t { Stopped, Ring, OneShot };
+
+static TraceRecord ring[TRACE_RING_CAPACITY];
+static uint32_t ringHead = 0; // total records written (wraps the ring)
+static TraceMode mode = TraceMode::Ring;
+static uint32_t enabledMask = 0xFFFFFFFFu;
+
+uint8_t traceDepth = 0;
+
+#if !defined(ARDUINO)
+#include <chrono>
+uint32_t traceHostMicros() {
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+#endif
+
+/**
+ * @brief Append one record. Called from ~TraceScope on the loop task only.
+ *
+ * OneShot mode stops by itself when the ring is full, so a capture keeps the
+ * first TRACE_RING_CAPACITY records after "trace start oneshot".
+ */
+void traceRecord(TraceId id, uint32_t start, uint32_t duration, uint8_t depth) {
+  if (mode == TraceMode::Stopped ||
+      (enabledMask & (1u << static_cast<uint8_t>(id))) == 0) {
+    return;
+  }
+
+  TraceRecord &r = ring[ringHead & (TRACE_RING_CAPACITY - 1)];
+  r.start = start;
+  r.duration = duration;
+  r.id = static_cast<uint8_t>(id);
+  r.depth = depth;
+  r.reserved = 0;
+  ringHead++;
+
+  if (mode == TraceMode::OneShot && ringHead >= TRACE_RING_CAPACITY) {
+    mode = TraceMode::Stopped;
+  }
+}
+
+static const char *traceIdName(uint8_t id) {
+  switch (static_cast<TraceId>(id)) {
+  case TraceId::Loop:
+    return "loop";
+  case TraceId::UpdateButton:
+    return "updateButton";
+  case TraceId::HandleButtonEvent:
+    return "handleButtonEvent";
+  case TraceId::InsultsStartOperation:
+    return "insultsStartOperation";
+  case TraceId::InsultsPoll:
+    return "insultsPoll";
+  case TraceId::RenderInsult:
+    return "renderInsult";
+  case TraceId::RenderBodyLive:
+    return "renderBodyLive";
+  case TraceId::RenderBodyCached:
+    return "renderBodyCached";
+  case TraceId::DisplayFlush:
+    return "displayFlush";
+  case TraceId::NvsRead:
+    return "nvsRead";
+  case TraceId::NvsWrite:
+    return "nvsWrite";
+  case TraceId::LedShow:
+    return "led.show";
+  case TraceId::LightSleep:
+    return "lightSleep";
+  case TraceId::SleepPrepare:
+    return "sleepPrepare";
+  case TraceId::Count:
+    break;
+  }
+  return "?";
+}
+
+/**
+ * @brief Print the ring, oldest first, in the text format
+ * scripts/trace_to_chrome.py reads.
+ *
+ *   TRACE BEGIN hz=<ticks per second> n=<records>
+ *   N <id> <name>                (one per TraceId)
+ *   R <start> <duration> <id> <depth>   (hex, one per record)
+ *   TRACE END
+ *
+ * Recording pauses while dumping so the dump doesn't trace itself.
+ */
+static void dumpRing() {
+  const TraceMode saved = mode;
+  mode = TraceMode::Stopped;
+
+  const uint32_t count =
+      ringHead < TRACE_RING_CAPACITY ? ringHead : TRACE_RING_CAPACITY;
+  const uint32_t first = ringHead - count;
+
+  // Records are in µs whatever the CPU clock was when they were taken.
+  const uint32_t hz = 1000000u;
+
+  Serial.printf("TRACE BEGIN hz=%lu n=%lu\n", static_cast<unsigned long>(hz),
+                static_cast<unsigned long>(count));
+  for (uint8_t id = 0; id < static_cast<uint8_t>(TraceId::Count); ++id) {
+    Serial.printf("N %u %s\n", id, traceIdName(id));
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    const TraceRecord &r = ring[(first + i) & (TRACE_RING_CAPACITY - 1)];
+    Serial.printf("R %08lx %08lx %02x %02x\n",
+                  static_cast<unsigned long>(r.start),
+                  static_cast<unsigned long>(r.duration), r.id, r.depth);
+  }
+  Serial.println(F("TRACE END"));
+
+  mode = saved;
+}
+
+/**
+ * @brief Console handler for "trace <start|stop|mask|dump|clear>".
+ *
+ * - start [ring|oneshot]: clear and record. ring (default) keeps the most
+ *   recent records; oneshot stops once the ring is full.
+ * - stop: stop recording (the ring is kept for dump).
+ * - mask <hex>: only record ids whose bit is set (bit n = TraceId n).
+ * - dump: print the ring.
+ * - clear: drop all records.
+ */
+void traceCommand(const char *args) {
+  if (strncmp(args, "start", 5) == 0) {
+    ringHead = 0;
+    mode = (strstr(args, "oneshot") != nullptr) ? TraceMode::OneShot
+                                                : TraceMode::Ring;
+    Serial.println(mode == TraceMode::OneShot ? F("[Trace] oneshot")
+                                              : F("[Trace] ring"));
+    return;
+  }
+  if (strcmp(args, "stop") == 0) {
+    mode = TraceMode::Stopped;
+    Serial.println(F("[Trace] stopped"));
+    return;
+  }
+  if (strncmp(args, "mask", 4) == 0) {
+    enabledMask = static_cast<uint32_t>(strtoul(args + 4, nullptr, 16));
+    Serial.printf("[Trace] mask=%08lx\n",
+                  static_cast<unsigned long>(enabledMask));
+    return;
+  }
+  if (strcmp(args, "dump") == 0) {
+    dumpRing();
+    return;
+  }
+  if (strcmp(args, "clear") == 0) {
+    ringHead = 0;
+    Serial.println(F("[Trace] cleared"));
+    return;
+  }
+  Serial.println(F("Usage: trace <start [ring|oneshot]|stop|mask <hex>|dump|clear>"));
+}
+
+#else
+
+void traceCommand(const char *) {
+  Serial.println(F("[Trace] compiled out; build with -DBARD_TRACE=1"));
+}
+
+#endif // BARD_TRACE
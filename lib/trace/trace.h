@@ -0,0 +1,105 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// ─── Hot-path tracing ───────────────────────────────────────────
+//
+// TRACE_SCOPE(TraceId::X) records one compact binary record (start time,
+// duration, id, nesting depth; microseconds) into a RAM ring when the
+// enclosing scope exits. "trace dump" on the serial console prints the ring;
+// scripts/trace_to_chrome.py turns a captured log into Chrome trace_event
+// JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Build with -DBARD_TRACE=1 to enable. With BARD_TRACE=0 (default) the macros
+// expand to nothing and no trace code or RAM is linked in.
+
+#ifndef BARD_TRACE
+#define BARD_TRACE 0
+#endif
+
+// Keep in sync with traceIdName() in trace.cpp.
+enum class TraceId : uint8_t {
+  Loop = 0,
+  UpdateButton,
+  HandleButtonEvent,
+  InsultsStartOperation,
+  InsultsPoll,
+  RenderInsult,
+  RenderBodyLive,
+  RenderBodyCached,
+  DisplayFlush,
+  NvsRead,
+  NvsWrite,
+  LedShow,
+  LightSleep,
+  SleepPrepare,
+  Count
+};
+
+/**
+ * @brief Console handler for "trace <start|stop|mask|dump|clear>".
+ *
+ * Available in every build so the command table doesn't change; reports
+ * that tracing is compiled out when BARD_TRACE is 0.
+ */
+void traceCommand(const char *args);
+
+#if BARD_TRACE
+
+// esp_timer rather than the CPU cycle counter: cycles change rate with
+// ClockBoost (80 <-> 240 MHz, even inside a scope) and stop in light sleep.
+// Wraps every ~71 min.
+#if defined(ARDUINO)
+#include <esp_timer.h>
+#define TRACE_NOW_US() static_cast<uint32_t>(esp_timer_get_time())
+#else
+// Host shim: the monotonic clock.
+uint32_t traceHostMicros();
+#define TRACE_NOW_US() traceHostMicros()
+#endif
+
+// 12 bytes per record; the ring holds the most recent TRACE_RING_CAPACITY.
+struct TraceRecord {
+  uint32_t start;    // µs at scope entry
+  uint32_t duration; // µs
+  uint8_t id;        // TraceId
+  uint8_t depth;     // nesting depth at entry (0 = outermost)
+  uint16_t reserved;
+};
+
+void traceRecord(TraceId id, uint32_t start, uint32_t duration, uint8_t depth);
+
+extern uint8_t traceDepth;
+
+class TraceScope {
+public:
+  explicit TraceScope(TraceId id)
+      : id_(id), depth_(traceDepth++), start_(TRACE_NOW_US()) {}
+  ~TraceScope() {
+    const uint32_t end = TRACE_NOW_US();
+    traceDepth--;
+    traceRecord(id_, start_, end - start_, depth_);
+  }
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  TraceId id_;
+  uint8_t depth_;
+  uint32_t start_;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(id) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(id)
+
+#else
+
+#define TRACE_SCOPE(id)                                                        \
+  do {                                                                         \
+  } while (0)
+
+#endif // BARD_TRACE
+
+#endif // TRACE_H
@@ -0,0 +1,79 @@
+#include "ulp_wake.h"
+
+#if BARD_ULP_WAKE
+
+#include <sdkconfig.h>
+
+#if !CONFIG_ULP_COPROC_ENABLED ||                                              \
+    !(CONFIG_ULP_COPROC_TYPE_RISCV || CONFIG_ULP_COPROC_RISCV)
+#error "BARD_ULP_WAKE needs the RISC-V ULP enabled in sdkconfig"
+#endif
+
+#include "driver/rtc_io.h"
+#include "ulp_main.h" // generated by ulp_embed_binary(ulp_main ...)
+#include "ulp_riscv.h"
+#include <esp_sleep.h>
+
+extern const uint8_t ulpMainBinStart[] asm("_binary_ulp_main_bin_start");
+extern const uint8_t ulpMainBinEnd[] asm("_binary_ulp_main_bin_end");
+
+// Sampling period. Must divide the debounce time so the ULP sees the same
+// 30 ms window as the main cores.
+static constexpr uint32_t ULP_TICK_MS = 10;
+static_assert(BUTTON_DEBOUNCE_TIME_MS % ULP_TICK_MS == 0,
+              "ULP tick must divide the debounce time");
+
+/**
+ * @brief Load and start the ULP button program and enable ULP wake.
+ */
+bool ulpWakeStart(const uint8_t (&pins)[BUTTON_ID_COUNT]) {
+  for (size_t i = 0; i < BUTTON_ID_COUNT; ++i) {
+    const gpio_num_t gpio = static_cast<gpio_num_t>(pins[i]);
+    rtc_gpio_init(gpio);
+    rtc_gpio_set_direction(gpio, RTC_GPIO_MODE_INPUT_ONLY);
+    rtc_gpio_pullup_en(gpio);
+    rtc_gpio_pulldown_dis(gpio);
+  }
+
+  if (ulp_riscv_load_binary(ulpMainBinStart, ulpMainBinEnd - ulpMainBinStart) !=
+      ESP_OK) {
+    return false;
+  }
+
+  volatile uint32_t *ulpPins = &ulp_button_pin;
+  for (size_t i = 0; i < BUTTON_ID_COUNT; ++i) {
+    ulpPins[i] = pins[i];
+  }
+  ulp_tick_ms = ULP_TICK_MS;
+  ulp_gesture_count = 0;
+
+  ulp_set_wakeup_period(0, ULP_TICK_MS * 1000);
+  if (ulp_riscv_run() != ESP_OK) {
+    return false;
+  }
+  return esp_sleep_enable_ulp_wakeup() == ESP_OK;
+}
+
+/**
+ * @brief Stop the ULP and read the gesture that woke us.
+ */
+bool ulpWakeTakeGesture(ButtonId &outButton, ButtonEvent &outEvent) {
+  ulp_riscv_timer_stop();
+  ulp_riscv_halt();
+
+  if (ulp_gesture_count == 0 || ulp_gesture_button >= BUTTON_ID_COUNT) {
+    return false;
+  }
+  outButton = static_cast<ButtonId>(ulp_gesture_button);
+  outEvent = static_cast<ButtonEvent>(ulp_gesture_event);
+  ulp_gesture_count = 0;
+  return true;
+}
+
+#else
+
+bool ulpWakeStart(const uint8_t (&)[BUTTON_ID_COUNT]) { return false; }
+
+bool ulpWakeTakeGesture(ButtonId &, ButtonEvent &) { return false; }
+
+#endif // BARD_ULP_WAKE
@@ -0,0 +1,34 @@
+#ifndef ULP_WAKE_H
+#define ULP_WAKE_H
+
+#include "button.h"
+#include <stdint.h>
+
+// Set to 1 (platformio.ini build_flags) to let the ULP-RISC-V debounce the
+// buttons during deep sleep instead of waking on raw EXT0/EXT1 levels.
+// Needs an ESP-IDF build with CONFIG_ULP_COPROC_ENABLED, the RISC-V ULP
+// selected and ulp/button_wake/ embedded as `ulp_main` (see Readme).
+#ifndef BARD_ULP_WAKE
+#define BARD_ULP_WAKE 0
+#endif
+
+/**
+ * @brief Load and start the ULP button program and enable ULP wake.
+ *
+ * Call right before esp_deep_sleep_start().
+ *
+ * @param pins GPIOs in ButtonId order (Sleep, Random, Next, Prev).
+ * @return true if the ULP is running; false (e.g. compiled out) means the
+ * caller should fall back to EXT0/EXT1 wake.
+ */
+bool ulpWakeStart(const uint8_t (&pins)[BUTTON_ID_COUNT]);
+
+/**
+ * @brief After an ESP_SLEEP_WAKEUP_ULP wake: stop the ULP and read the
+ * gesture that woke us.
+ *
+ * @return false if no gesture was recorded (or compiled out).
+ */
+bool ulpWakeTakeGesture(ButtonId &outButton, ButtonEvent &outEvent);
+
+#endif // ULP_WAKE_H
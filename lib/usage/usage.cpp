@@ -0,0 +1,416 @@
+#include "usage.h"
+#include "clock.h"
+#include "content.h"
+#include "corpus.h"
+#include "energy.h"
+#include "font.h"
+#include "persist_keys.h"
+#include "trace.h"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr size_t KIND_COUNT = static_cast<size_t>(ContentKind::Count);
+
+static constexpr uint32_t USAGE_MAGIC = 0x55534732; // "USG2"
+static constexpr const char *USAGE_NVS_KEY = "usage";
+static constexpr size_t USAGE_TOP_DEFAULT = 10;
+static constexpr size_t USAGE_TOP_MAX = 50;
+
+// Morris counter: value c stands for (b^c - 1) / (b - 1) shows, b = 2^(1/8).
+// An increment succeeds with probability b^-c; MORRIS_STEP[k] = 2^31 * 2^(-k/8).
+static constexpr uint8_t MORRIS_SUBSTEPS = 8;
+static constexpr uint32_t MORRIS_STEP[MORRIS_SUBSTEPS] = {
+    0x80000000, 0x75606374, 0x6BA27E65, 0x62B39509,
+    0x5A82799A, 0x52FF6B55, 0x4C1BF829, 0x45CAE0F2,
+};
+
+// ───────────────── Session (RTC) ─────────────────
+
+struct UsageSession {
+  uint32_t ids[USAGE_SESSION_IDS]; // corpus ids shown, ring
+  uint16_t head;                   // next write
+  uint16_t count;                  // ids held (saturates)
+  uint32_t kindShows[KIND_COUNT];
+  uint16_t shows; // since the last fold
+};
+
+static RTC_DATA_ATTR UsageSession session;
+
+// ───────────────── Lifetime (NVS, staged in RAM) ─────────────────
+
+struct UsageHeader {
+  uint32_t magic;
+  uint32_t kindShows[KIND_COUNT];
+};
+
+struct UsagePair {
+  uint8_t id[4]; // little-endian stable id; packed, 5 bytes per pair
+  uint8_t counter;
+};
+
+static_assert(sizeof(UsagePair) == 5, "pairs are packed");
+
+// Tracked insults, sorted by id.
+struct UsageEntry {
+  uint32_t id;
+  uint8_t counter;
+};
+
+static UsageHeader lifetime;
+static UsageEntry entries[USAGE_TRACKED];
+static size_t entryCount = 0;
+static uint8_t nvsBuffer[sizeof(UsageHeader) +
+                         USAGE_TRACKED * sizeof(UsagePair)];
+
+// ───────────────── Morris counters ─────────────────
+
+static void morrisIncrement(uint8_t &counter) {
+  if (counter == 0xFF) {
+    return;
+  }
+  const uint32_t threshold =
+      MORRIS_STEP[counter % MORRIS_SUBSTEPS] >> (counter / MORRIS_SUBSTEPS);
+  if ((esp_random() >> 1) < threshold) {
+    counter++;
+  }
+}
+
+static double morrisEstimate(uint8_t counter) {
+  const double base = pow(2.0, 1.0 / MORRIS_SUBSTEPS);
+  return (pow(base, counter) - 1.0) / (base - 1.0);
+}
+
+// ───────────────── Tracked table ─────────────────
+
+/**
+ * @brief Position of `id` in entries[], or where it would be inserted.
+ */
+static size_t entryLowerBound(uint32_t id) {
+  size_t lo = 0;
+  size_t hi = entryCount;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (entries[mid].id < id) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static void entryRemove(size_t at) {
+  memmove(&entries[at], &entries[at + 1],
+          (entryCount - at - 1) * sizeof(entries[0]));
+  entryCount--;
+}
+
+/**
+ * @brief Count one show of `id`.
+ *
+ * An untracked id takes a free slot, or else the slot of the least-shown
+ * tracked insult and its counter (space-saving): the table keeps the heavy
+ * hitters, and a newcomer's count can only be overestimated.
+ */
+static void entryNoteShow(uint32_t id) {
+  size_t at = entryLowerBound(id);
+  if (at < entryCount && entries[at].id == id) {
+    morrisIncrement(entries[at].counter);
+    return;
+  }
+
+  uint8_t counter = 0;
+  if (entryCount == USAGE_TRACKED) {
+    size_t coldest = 0;
+    for (size_t i = 1; i < entryCount; ++i) {
+      if (entries[i].counter < entries[coldest].counter) {
+        coldest = i;
+      }
+    }
+    counter = entries[coldest].counter;
+    entryRemove(coldest);
+    at = entryLowerBound(id);
+  }
+  memmove(&entries[at + 1], &entries[at],
+          (entryCount - at) * sizeof(entries[0]));
+  entryCount++;
+  entries[at].id = id;
+  entries[at].counter = counter;
+  morrisIncrement(entries[at].counter);
+}
+
+// ───────────────── NVS ─────────────────
+
+/**
+ * @brief Stage the lifetime counters in RAM (pairs for lines that no longer
+ * exist are dropped).
+ */
+static void loadLifetime() {
+  memset(&lifetime, 0, sizeof(lifetime));
+  entryCount = 0;
+  lifetime.magic = USAGE_MAGIC;
+
+  TRACE_SCOPE(TraceId::NvsRead);
+  ClockBoost boost;
+  Preferences prefs;
+  if (!prefs.begin(NVS_NS, true)) {
+    return;
+  }
+  const size_t length = prefs.getBytesLength(USAGE_NVS_KEY);
+  const bool ok = length >= sizeof(UsageHeader) &&
+                  length <= sizeof(nvsBuffer) &&
+                  prefs.getBytes(USAGE_NVS_KEY, nvsBuffer, length) == length;
+  prefs.end();
+
+  UsageHeader header;
+  memcpy(&header, nvsBuffer, sizeof(header));
+  if (!ok || header.magic != USAGE_MAGIC) {
+    return;
+  }
+  lifetime = header;
+
+  // Stored in id order, so entries[] comes out sorted.
+  const size_t pairs = (length - sizeof(UsageHeader)) / sizeof(UsagePair);
+  for (size_t i = 0; i < pairs; ++i) {
+    UsagePair pair;
+    memcpy(&pair, nvsBuffer + sizeof(UsageHeader) + i * sizeof(UsagePair),
+           sizeof(pair));
+    const uint32_t id = pair.id[0] | (pair.id[1] << 8) | (pair.id[2] << 16) |
+                        (static_cast<uint32_t>(pair.id[3]) << 24);
+    uint16_t index = 0;
+    if (contentCorpusIndex(id, index) &&
+        (entryCount == 0 || entries[entryCount - 1].id < id)) {
+      entries[entryCount].id = id;
+      entries[entryCount].counter = pair.counter;
+      entryCount++;
+    }
+  }
+}
+
+/**
+ * @return false if the blob could not be written (NVS full or closed).
+ */
+static bool storeLifetime() {
+  memcpy(nvsBuffer, &lifetime, sizeof(lifetime));
+  size_t length = sizeof(UsageHeader);
+  for (size_t i = 0; i < entryCount; ++i) {
+    const uint32_t id = entries[i].id;
+    const UsagePair pair = {{static_cast<uint8_t>(id),
+                             static_cast<uint8_t>(id >> 8),
+                             static_cast<uint8_t>(id >> 16),
+                             static_cast<uint8_t>(id >> 24)},
+                            entries[i].counter};
+    memcpy(nvsBuffer + length, &pair, sizeof(pair));
+    length += sizeof(pair);
+  }
+
+  TRACE_SCOPE(TraceId::NvsWrite);
+  ClockBoost boost;
+  Preferences prefs;
+  if (!prefs.begin(NVS_NS, false)) {
+    return false;
+  }
+  const bool written = prefs.putBytes(USAGE_NVS_KEY, nvsBuffer, length) == length;
+  prefs.end();
+  energyNoteFlashWrite();
+  return written;
+}
+
+/**
+ * @brief Add the session to the lifetime counters and start a new session.
+ *
+ * On a failed write the session is kept, so the next fold retries it.
+ */
+static bool fold() {
+  loadLifetime();
+  for (size_t i = 0; i < session.count; ++i) {
+    entryNoteShow(session.ids[i]);
+  }
+  for (size_t k = 0; k < KIND_COUNT; ++k) {
+    lifetime.kindShows[k] += session.kindShows[k];
+  }
+  if (!storeLifetime()) {
+    Serial.println(F("[Usage] fold failed: NVS write rejected"));
+    return false;
+  }
+  memset(&session, 0, sizeof(session));
+  return true;
+}
+
+// ───────────────── API ─────────────────
+
+void usageInit(bool wokeFromSleep) {
+  if (!wokeFromSleep) {
+    memset(&session, 0, sizeof(session));
+  }
+}
+
+void usageNoteShow(uint32_t id) {
+  const ContentKind kind = contentKindOf(id);
+  if (kind >= ContentKind::Count) {
+    return;
+  }
+  session.kindShows[static_cast<size_t>(kind)]++;
+  session.shows++;
+  if (kind != ContentKind::Corpus) {
+    return;
+  }
+  // Ring order doesn't matter to a fold; after failed folds the oldest
+  // shows are the ones lost.
+  session.ids[session.head] = id;
+  session.head = static_cast<uint16_t>((session.head + 1) % USAGE_SESSION_IDS);
+  if (session.count < USAGE_SESSION_IDS) {
+    session.count++;
+  }
+  if (session.count == USAGE_SESSION_IDS) {
+    fold();
+  }
+}
+
+void usageNoteSleep() {
+  if (session.shows >= USAGE_FOLD_SHOWS) {
+    fold();
+  }
+}
+
+// ───────────────── Console ─────────────────
+
+/**
+ * @brief Print insult text (codepage) as UTF-8.
+ */
+static void printInsultText(uint16_t index) {
+  const char *text = corpusText(index);
+  char utf8[3];
+  for (size_t i = 0; text[i] != '\0'; ++i) {
+    const size_t n = fontCodeToUtf8(static_cast<uint8_t>(text[i]), utf8);
+    Serial.write(reinterpret_cast<const uint8_t *>(utf8), n);
+  }
+  Serial.println();
+}
+
+static uint16_t sessionShowsOf(uint32_t id) {
+  uint16_t shows = 0;
+  for (size_t i = 0; i < session.count; ++i) {
+    shows += session.ids[i] == id ? 1 : 0;
+  }
+  return shows;
+}
+
+/**
+ * @brief Insert into the sorted top-n (hottest first) if it makes the cut.
+ */
+static void offerTop(uint32_t id, double shows, size_t n, uint32_t *top,
+                     double *topShows, size_t &found) {
+  size_t pos = 0;
+  if (found < n) {
+    pos = found++;
+  } else if (shows > topShows[n - 1]) {
+    pos = n - 1;
+  } else {
+    return;
+  }
+  while (pos > 0 && topShows[pos - 1] < shows) {
+    top[pos] = top[pos - 1];
+    topShows[pos] = topShows[pos - 1];
+    pos--;
+  }
+  top[pos] = id;
+  topShows[pos] = shows;
+}
+
+/**
+ * @brief Top-n insults by lifetime + session shows, hottest first.
+ *
+ * Printed in assets/hotlist.txt format (comments + one insult per line), so
+ * the output can be pasted there to steer the raster cache.
+ */
+static void printTop(size_t n) {
+  static uint32_t top[USAGE_TOP_MAX];
+  static double topShows[USAGE_TOP_MAX];
+  size_t found = 0;
+
+  loadLifetime();
+  for (size_t i = 0; i < entryCount; ++i) {
+    offerTop(entries[i].id,
+             morrisEstimate(entries[i].counter) +
+                 sessionShowsOf(entries[i].id),
+             n, top, topShows, found);
+  }
+  // Session-only insults (each once: at its first ring slot).
+  for (size_t i = 0; i < session.count; ++i) {
+    const uint32_t id = session.ids[i];
+    const size_t at = entryLowerBound(id);
+    bool seen = at < entryCount && entries[at].id == id;
+    for (size_t j = 0; j < i && !seen; ++j) {
+      seen = session.ids[j] == id;
+    }
+    if (!seen) {
+      offerTop(id, sessionShowsOf(id), n, top, topShows, found);
+    }
+  }
+
+  static const char *const kindNames[KIND_COUNT] = {"corpus", "grammar",
+                                                    "ngram"};
+  Serial.printf("# usage: top %u of %u tracked corpus insults (approximate "
+                "shows)\n",
+                static_cast<unsigned>(found),
+                static_cast<unsigned>(entryCount));
+  for (size_t k = 0; k < KIND_COUNT; ++k) {
+    Serial.printf("# %-8s %lu shows\n", kindNames[k],
+                  static_cast<unsigned long>(lifetime.kindShows[k] +
+                                             session.kindShows[k]));
+  }
+  for (size_t i = 0; i < found; ++i) {
+    uint16_t index = 0;
+    if (!contentCorpusIndex(top[i], index)) {
+      continue;
+    }
+    Serial.printf("# %lu\n", static_cast<unsigned long>(topShows[i] + 0.5));
+    printInsultText(index);
+  }
+}
+
+/**
+ * @brief Console handler for "usage [N|save|reset]".
+ *
+ * - (none) / N: top 10 / top N (max USAGE_TOP_MAX) in hotlist format
+ * - save: fold the session into NVS now
+ * - reset: zero session and lifetime counters
+ */
+void usageCommand(const char *args) {
+  if (strcmp(args, "save") == 0) {
+    if (fold()) {
+      Serial.printf("[Usage] folded into NVS (%u of %u tracked)\n",
+                    static_cast<unsigned>(entryCount),
+                    static_cast<unsigned>(USAGE_TRACKED));
+    }
+    return;
+  }
+  if (strcmp(args, "reset") == 0) {
+    memset(&session, 0, sizeof(session));
+    ClockBoost boost;
+    Preferences prefs;
+    if (prefs.begin(NVS_NS, false)) {
+      prefs.remove(USAGE_NVS_KEY);
+      prefs.end();
+    }
+    Serial.println(F("[Usage] reset"));
+    return;
+  }
+
+  size_t n = USAGE_TOP_DEFAULT;
+  if (*args != '\0') {
+    const long requested = strtol(args, nullptr, 10);
+    if (requested <= 0) {
+      Serial.println(F("[Usage] usage: usage [N|save|reset]"));
+      return;
+    }
+    n = requested > static_cast<long>(USAGE_TOP_MAX)
+            ? USAGE_TOP_MAX
+            : static_cast<size_t>(requested);
+  }
+  printTop(n);
+}
@@ -0,0 +1,51 @@
+#ifndef USAGE_H
+#define USAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ─── Show counters ──────────────────────────────────────────────
+//
+// How often each corpus insult has been shown, approximately, for weighting
+// ({w=N}) and raster-cache (assets/hotlist.txt) decisions. Two tiers:
+//
+// - session: the corpus ids shown since the last fold, a ring of
+//   USAGE_SESSION_IDS in RTC memory. A show is one store, no flash.
+// - lifetime: 8-bit Morris counters (base 2^(1/8): ~20% relative error,
+//   counts into the billions) for at most USAGE_TRACKED insults, stored in
+//   NVS as (stable id, counter) pairs. When the table is full a newly shown
+//   insult replaces the least-shown one and inherits its counter
+//   (space-saving), so the most shown insults are always tracked. Ids keep
+//   counts attached to their lines across corpus updates.
+//
+// Folding touches only the ids actually shown. It happens before deep sleep
+// once the session holds USAGE_FOLD_SHOWS shows, and whenever the ring
+// fills, so flash sees one write per few dozen shows. RAM and NVS use are
+// fixed (USAGE_TRACKED * 5 + 16 bytes of blob) whatever the corpus size.
+// Generated insults (grammar, n-gram) are only counted per engine.
+
+static constexpr uint16_t USAGE_FOLD_SHOWS = 48;
+static constexpr size_t USAGE_SESSION_IDS = 64;
+static constexpr size_t USAGE_TRACKED = 256;
+
+/**
+ * @brief Clear the session on cold boot; keep it across deep sleep.
+ */
+void usageInit(bool wokeFromSleep);
+
+/**
+ * @brief Count one completed show of a content id.
+ */
+void usageNoteShow(uint32_t id);
+
+/**
+ * @brief Fold the session into NVS if due; call before deep sleep.
+ */
+void usageNoteSleep();
+
+/**
+ * @brief Console handler for "usage [N|save|reset]".
+ */
+void usageCommand(const char *args);
+
+#endif // USAGE_H
@@ -0,0 +1,130 @@
+#ifndef WAKE_H
+#define WAKE_H
+
+#include "button.h"
+#include "insults.h"
+#include <stdint.h>
+
+// ─── Wake-by-action ─────────────────────────────────────────────
+//
+// Random/Next/Prev are EXT1 wake sources, so the press that wakes the device
+// also runs its action. Kept free of ESP-IDF calls so it builds on the host.
+
+/**
+ * @brief Map an EXT1 wake status bitmask to the action to run after restore.
+ *
+ * Bit n of `ext1Mask` is GPIO n (as from esp_sleep_get_ext1_wakeup_status()).
+ * If several action pins are set, Random wins over Next over Prev.
+ *
+ * @return The action, or PendingAction::None if no action pin woke us.
+ */
+inline PendingAction wakeActionFromExt1Mask(uint64_t ext1Mask,
+                                            uint8_t randomPin,
+                                            uint8_t nextPin,
+                                            uint8_t prevPin) {
+  if (ext1Mask & (1ULL << randomPin)) {
+    return PendingAction::Random;
+  }
+  if (ext1Mask & (1ULL << nextPin)) {
+    return PendingAction::Next;
+  }
+  if (ext1Mask & (1ULL << prevPin)) {
+    return PendingAction::Prev;
+  }
+  return PendingAction::None;
+}
+
+/**
+ * @brief Map a gesture confirmed by the ULP button program to an action.
+ *
+ * Only a Tap on Random/Next/Prev runs an action; other gestures just wake.
+ */
+inline PendingAction wakeActionFromGesture(ButtonId button, ButtonEvent event) {
+  if (event != ButtonEvent::Tap) {
+    return PendingAction::None;
+  }
+  switch (button) {
+  case ButtonId::Random:
+    return PendingAction::Random;
+  case ButtonId::Next:
+    return PendingAction::Next;
+  case ButtonId::Prev:
+    return PendingAction::Prev;
+  default:
+    return PendingAction::None;
+  }
+}
+
+/**
+ * @brief EXT1 wake mask (bit n = GPIO n) for the action pins.
+ */
+constexpr uint64_t wakeExt1PinMask(uint8_t randomPin, uint8_t nextPin,
+                                   uint8_t prevPin) {
+  return (1ULL << randomPin) | (1ULL << nextPin) | (1ULL << prevPin);
+}
+
+// ─── Deep-sleep wake stub decision ──────────────────────────────
+//
+// What an esp_wake_deep_sleep() stub would do before the bootloader: a
+// Prev/Next that stays inside history only moves the RTC cursor and goes
+// straight back to sleep; everything else boots. Only the decision ships
+// (host-tested in test/test_wake); the stub itself waits for a panel driver
+// that can update without the main CPU. A stub runs from RTC fast memory, so
+// the decision must stay inline, call nothing and use only 32-bit arithmetic.
+
+#define WAKE_STUB_INLINE inline __attribute__((always_inline))
+
+/**
+ * @brief Everything the stub knows, kept in RTC slow memory across sleeps.
+ *
+ * Pin masks use bit n = RTC GPIO n (same as GPIO n on the ESP32-S3 for the
+ * button pins).
+ */
+struct WakeStubState {
+  uint32_t randomMask;
+  uint32_t nextMask;
+  uint32_t prevMask;
+  uint16_t historySize;
+  uint16_t position; // logical history cursor, 0 = oldest
+  uint16_t moves;    // cursor moves served by the stub since armed
+  uint8_t armed;     // state matches what insults persisted
+};
+
+enum class WakeStubDecision : uint8_t { Boot, Sleep };
+
+/**
+ * @brief Decide what the stub does with an EXT1 wake.
+ *
+ * Prev with an older entry and Next with a newer entry move the cursor and
+ * return Sleep. Random, Next at the newest entry (needs a new insult), Prev
+ * at the oldest, non-EXT1 wakes and an unarmed state return Boot. Same
+ * button priority as wakeActionFromExt1Mask().
+ *
+ * @param ext1Status EXT1 wake status bits (0 if EXT1 didn't wake us).
+ * @param state Stub state; position/moves are updated on Sleep.
+ */
+WAKE_STUB_INLINE WakeStubDecision wakeStubDecide(uint32_t ext1Status,
+                                                 WakeStubState &state) {
+  if (!state.armed || ext1Status == 0 || (ext1Status & state.randomMask)) {
+    return WakeStubDecision::Boot;
+  }
+  if (ext1Status & state.nextMask) {
+    if (state.position + 1u >= state.historySize) {
+      return WakeStubDecision::Boot;
+    }
+    state.position++;
+    state.moves++;
+    return WakeStubDecision::Sleep;
+  }
+  if (ext1Status & state.prevMask) {
+    if (state.position == 0 || state.historySize == 0) {
+      return WakeStubDecision::Boot;
+    }
+    state.position--;
+    state.moves++;
+    return WakeStubDecision::Sleep;
+  }
+  return WakeStubDecision::Boot;
+}
+
+#endif // WAKE_H
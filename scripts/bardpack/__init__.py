@@ -0,0 +1,10 @@
+"""Build-time packing of the insult corpus and font into C++ tables.
+
+Everything here runs on the build host (PlatformIO pre-script or plain
+`python3 scripts/pack_corpus.py`). The firmware only ever sees the generated
+tables in lib/corpus/.
+"""
+
+
+class PackError(Exception):
+    """Raised when the corpus or font cannot be packed; fails the build."""
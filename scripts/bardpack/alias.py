@@ -0,0 +1,72 @@
+"""Walker/Vose alias table for O(1) weighted draws.
+
+Every slot holds ONE units of probability mass: `threshold` of it for the
+slot's own insult, the rest for `alias`. The firmware turns one 32-bit random
+number r into a slot (high word of r * n) and a 16-bit fraction (the next 16
+bits of that product) and returns `slot` if fraction < threshold, else
+`alias`. A full slot is stored as threshold 0xFFFF with alias = itself.
+
+Everything is integer: weights are apportioned to exactly n * ONE units
+(largest remainder), and verify() checks the table hands every insult
+exactly its units.
+"""
+
+from . import PackError
+
+ONE = 1 << 16
+
+
+def _apportion(weights):
+    n = len(weights)
+    total = sum(weights)
+    scaled = [w * n * ONE for w in weights]
+    units = [s // total for s in scaled]
+    short = n * ONE - sum(units)
+    # Hand the leftover units to the largest remainders (ties: lowest index).
+    order = sorted(range(n), key=lambda i: (-(scaled[i] % total), i))
+    for i in order[:short]:
+        units[i] += 1
+    return units
+
+
+def build(weights):
+    """Returns [(threshold, alias)] per slot."""
+    n = len(weights)
+    units = _apportion(weights)
+    threshold = [ONE] * n
+    alias = list(range(n))
+
+    left = list(units)
+    small = [i for i in range(n) if left[i] < ONE]
+    large = [i for i in range(n) if left[i] >= ONE]
+    while small and large:
+        s = small.pop()
+        g = large.pop()
+        threshold[s] = left[s]
+        alias[s] = g
+        left[g] -= ONE - left[s]
+        (small if left[g] < ONE else large).append(g)
+    # Whatever is left is full up to rounding already absorbed above.
+    for i in small + large:
+        threshold[i] = ONE
+        alias[i] = i
+
+    table = [
+        (0xFFFF, i) if threshold[i] == ONE else (threshold[i], alias[i])
+        for i in range(n)
+    ]
+    verify(table, units)
+    return table
+
+
+def verify(table, units):
+    """Recompute each insult's probability mass from the table."""
+    got = [0] * len(table)
+    for i, (threshold, alias) in enumerate(table):
+        if threshold == 0xFFFF and alias == i:
+            got[i] += ONE
+            continue
+        got[i] += threshold
+        got[alias] += ONE - threshold
+    if got != units:
+        raise PackError("alias table does not reproduce the weights")
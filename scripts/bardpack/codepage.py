@@ -0,0 +1,62 @@
+"""One-byte codepage shared by the packed corpus and the packed font.
+
+0x20..0x7E are printable ASCII, unchanged. Every other code point the corpus
+uses gets the next free byte from 0x80 up, in code point order. The firmware
+indexes glyphs directly with these bytes and never decodes UTF-8.
+"""
+
+from . import PackError
+
+FIRST_CODE = 0x20
+ASCII_LAST = 0x7E
+EXTENDED_FIRST = 0x80
+LAST_CODE = 0xFF
+
+
+class Codepage:
+    def __init__(self, extended):
+        self.to_byte = {cp: cp for cp in range(FIRST_CODE, ASCII_LAST + 1)}
+        self.to_codepoint = {cp: cp for cp in range(FIRST_CODE, ASCII_LAST + 1)}
+        for i, cp in enumerate(extended):
+            self.to_byte[cp] = EXTENDED_FIRST + i
+            self.to_codepoint[EXTENDED_FIRST + i] = cp
+
+    @property
+    def last_code(self):
+        return max(self.to_codepoint)
+
+    def encode(self, text):
+        out = bytearray()
+        for ch in text:
+            code = self.to_byte.get(ord(ch))
+            if code is None:
+                raise PackError("%r (U+%04X) is not in the codepage" % (ch, ord(ch)))
+            out.append(code)
+        return bytes(out)
+
+
+def build_codepage(texts, font):
+    """Map every code point used by `texts` to one byte.
+
+    Rejects control characters, characters the font can't draw and more
+    extended characters than fit in 0x80..0xFF.
+    """
+    extended = set()
+    for text in texts:
+        for ch in text:
+            cp = ord(ch)
+            if cp < FIRST_CODE or cp == 0x7F:
+                raise PackError("control character U+%04X in %r" % (cp, text))
+            if cp > 0xFFFF:
+                raise PackError("U+%04X is outside the BMP in %r" % (cp, text))
+            if not font.has(ch):
+                raise PackError("no glyph for %r (U+%04X) in %r" % (ch, cp, text))
+            if cp > ASCII_LAST:
+                extended.add(cp)
+
+    if len(extended) > LAST_CODE - EXTENDED_FIRST + 1:
+        raise PackError(
+            "%d non-ASCII characters; the codepage has room for %d"
+            % (len(extended), LAST_CODE - EXTENDED_FIRST + 1)
+        )
+    return Codepage(sorted(extended))
@@ -0,0 +1,79 @@
+"""Loader for assets/insults.txt.
+
+A line may start with a metadata block, e.g. `{w=8} You fight like...`:
+
+  w=N       draw weight, 1..255 (default DEFAULT_WEIGHT). Relative: w=1
+            shows up a quarter as often as an unmarked line, w=8 twice as
+            often.
+  tags=a,b  filter tags (lowercase letters, digits, '-'), e.g. tags=pg,pirate
+"""
+
+import re
+import unicodedata
+
+from . import PackError
+
+DEFAULT_WEIGHT = 4
+MAX_WEIGHT = 0xFF
+
+_META = re.compile(r"^\{([^}]*)\}\s*(.*)$")
+_TAG = re.compile(r"^[a-z0-9-]+$")
+
+
+class Entry:
+    def __init__(self, text, lineno, weight=DEFAULT_WEIGHT):
+        self.text = text
+        self.lineno = lineno
+        self.weight = weight
+        self.tags = []
+
+
+def _parse_meta(path, lineno, meta, entry):
+    for item in meta.split():
+        key, sep, value = item.partition("=")
+        if not sep:
+            raise PackError("%s:%d: metadata %r is not key=value" % (path, lineno, item))
+        if key == "w":
+            try:
+                weight = int(value)
+            except ValueError:
+                weight = -1
+            if not 1 <= weight <= MAX_WEIGHT:
+                raise PackError(
+                    "%s:%d: weight %r is not 1..%d" % (path, lineno, value, MAX_WEIGHT)
+                )
+            entry.weight = weight
+        elif key == "tags":
+            for tag in value.split(","):
+                if not _TAG.match(tag):
+                    raise PackError("%s:%d: bad tag %r" % (path, lineno, tag))
+                if tag not in entry.tags:
+                    entry.tags.append(tag)
+        else:
+            raise PackError("%s:%d: unknown metadata key %r" % (path, lineno, key))
+
+
+def load_corpus(path):
+    entries = []
+    with open(path, encoding="utf-8") as f:
+        for lineno, raw in enumerate(f, 1):
+            line = raw.rstrip("\n").strip()
+            if not line or line.startswith("#"):
+                continue
+            meta = None
+            m = _META.match(line)
+            if m:
+                meta, line = m.group(1), m.group(2)
+                if not line:
+                    raise PackError("%s:%d: metadata without text" % (path, lineno))
+            text = unicodedata.normalize("NFC", line)
+            entry = Entry(text, lineno)
+            if meta is not None:
+                _parse_meta(path, lineno, meta, entry)
+            entries.append(entry)
+
+    if not entries:
+        raise PackError("%s: corpus is empty" % path)
+    if len(entries) > 0xFFFF:
+        raise PackError("%s: %d insults; indices are uint16_t" % (path, len(entries)))
+    return entries
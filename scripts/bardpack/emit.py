@@ -0,0 +1,47 @@
+"""Helpers for writing generated C++ sources."""
+
+import os
+
+BANNER = (
+    "// Generated by scripts/pack_corpus.py — do not edit.\n"
+    "// Edit assets/ and rebuild instead.\n"
+)
+
+
+def c_string(data):
+    """Render bytes as a C string literal. Octal escapes never swallow the
+    following character, unlike \\x escapes."""
+    out = ['"']
+    for b in data:
+        ch = chr(b)
+        if ch == '"' or ch == "\\":
+            out.append("\\" + ch)
+        elif 0x20 <= b < 0x7F:
+            out.append(ch)
+        else:
+            out.append("\\%03o" % b)
+    out.append('"')
+    return "".join(out)
+
+
+def c_array(values, per_line=12, fmt="%d"):
+    """Render an iterable of ints as the body of a C array initializer."""
+    values = list(values)
+    if not values:
+        return "    0,"
+    rows = []
+    for i in range(0, len(values), per_line):
+        rows.append("    " + ", ".join(fmt % v for v in values[i : i + per_line]) + ",")
+    return "\n".join(rows)
+
+
+def write_if_changed(path, text):
+    """Only touch the file when the content changes so incremental builds stay
+    incremental."""
+    if os.path.exists(path):
+        with open(path, encoding="utf-8") as f:
+            if f.read() == text:
+                return False
+    with open(path, "w", encoding="utf-8", newline="\n") as f:
+        f.write(text)
+    return True
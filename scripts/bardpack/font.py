@@ -0,0 +1,86 @@
+"""Loader for the plain-text `.font` glyph files in assets/."""
+
+from . import PackError
+
+
+class Glyph:
+    def __init__(self, codepoint, rows):
+        self.codepoint = codepoint
+        self.rows = rows  # list of strings, '#' = ink
+        self.width = len(rows[0]) if rows else 0
+
+
+class Font:
+    def __init__(self, name, height, ascent, spacing, glyphs):
+        self.name = name
+        self.height = height
+        self.ascent = ascent
+        self.spacing = spacing
+        self.glyphs = glyphs  # codepoint -> Glyph
+
+    def has(self, ch):
+        return ord(ch) in self.glyphs
+
+    def advance(self, ch):
+        """Horizontal advance of one character at scale 1 (width + spacing)."""
+        return self.glyphs[ord(ch)].width + self.spacing
+
+
+def load_font(path, name):
+    header = {}
+    glyphs = {}
+    current = None
+    rows = []
+
+    def finish(lineno):
+        if current is None:
+            return
+        height = header.get("height", 0)
+        if len(rows) > height:
+            raise PackError(
+                "%s:%d: glyph U+%04X has %d rows, font height is %d"
+                % (path, lineno, current, len(rows), height)
+            )
+        width = len(rows[0]) if rows else 0
+        for row in rows:
+            if len(row) != width:
+                raise PackError(
+                    "%s:%d: glyph U+%04X has ragged rows" % (path, lineno, current)
+                )
+        padded = rows + ["." * width] * (height - len(rows))
+        glyphs[current] = Glyph(current, padded)
+
+    with open(path, encoding="utf-8") as f:
+        for lineno, raw in enumerate(f, 1):
+            line = raw.strip()
+            if line.startswith("#") and current is None:
+                continue
+            if not line:
+                finish(lineno)
+                current = None
+                rows = []
+                continue
+            if line.startswith("glyph "):
+                finish(lineno)
+                parts = line.split()
+                if len(parts) != 2 or not parts[1].startswith("U+"):
+                    raise PackError("%s:%d: expected 'glyph U+XXXX'" % (path, lineno))
+                current = int(parts[1][2:], 16)
+                if current in glyphs:
+                    raise PackError("%s:%d: duplicate glyph U+%04X" % (path, lineno, current))
+                rows = []
+                continue
+            if current is None:
+                key, _, value = line.partition(" ")
+                header[key] = int(value)
+                continue
+            if set(line) - {"#", "."}:
+                raise PackError("%s:%d: glyph rows may only contain '#' and '.'" % (path, lineno))
+            rows.append(line)
+    finish(0)
+
+    for key in ("height", "ascent", "spacing"):
+        if key not in header:
+            raise PackError("%s: missing '%s' header" % (path, key))
+
+    return Font(name, header["height"], header["ascent"], header["spacing"], glyphs)
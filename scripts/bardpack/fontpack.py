@@ -0,0 +1,101 @@
+"""Pack a Font into 1bpp glyph bitmaps, run-length encoded where it pays off.
+
+Raw glyphs are the glyph's pixels as one MSB-first bit stream, row after row,
+with no per-row padding. RLE glyphs are a stream of 4-bit run lengths
+(high nibble first) that alternate paper, ink, paper, ... starting with
+paper; a run longer than 15 is split with a zero-length opposite run. The
+firmware stops decoding after width*height pixels, so a trailing pad nibble
+is ignored.
+"""
+
+from . import PackError
+
+ENCODING_RAW = 0
+ENCODING_RLE = 1
+
+# The blitter reads glyph rows through a 32-bit window, so it may touch up to
+# three bytes past the last glyph.
+TAIL_PADDING = 3
+
+
+def _pixels(glyph):
+    return [1 if c == "#" else 0 for row in glyph.rows for c in row]
+
+
+def encode_raw(glyph):
+    bits = _pixels(glyph)
+    out = bytearray((len(bits) + 7) // 8)
+    for i, bit in enumerate(bits):
+        if bit:
+            out[i >> 3] |= 0x80 >> (i & 7)
+    return bytes(out)
+
+
+def encode_rle(glyph):
+    nibbles = []
+    color = 0
+    run = 0
+    for bit in _pixels(glyph):
+        if bit == color:
+            run += 1
+            continue
+        while run > 15:
+            nibbles += [15, 0]
+            run -= 15
+        nibbles.append(run)
+        color ^= 1
+        run = 1
+    while run > 15:
+        nibbles += [15, 0]
+        run -= 15
+    nibbles.append(run)
+    if len(nibbles) % 2:
+        nibbles.append(0)
+    return bytes((nibbles[i] << 4) | nibbles[i + 1] for i in range(0, len(nibbles), 2))
+
+
+class PackedFont:
+    def __init__(self, first_code, codepoints, glyphs, bitmaps):
+        self.first_code = first_code
+        self.codepoints = codepoints  # per code from first_code; 0 = unused
+        self.glyphs = glyphs  # (offset, width, encoding), parallel to codepoints
+        self.bitmaps = bitmaps
+
+
+def pack_font(font, codepage, max_scale, use_rle=True):
+    """Pack one glyph per codepage byte into a dense table.
+
+    Bytes the codepage doesn't use (e.g. 0x7F) get an empty zero-width glyph
+    so the firmware can index the table without a lookup.
+    """
+    first = min(codepage.to_codepoint)
+    last = codepage.last_code
+    codepoints = []
+    glyphs = []
+    blob = bytearray()
+    for code in range(first, last + 1):
+        cp = codepage.to_codepoint.get(code)
+        if cp is None:
+            codepoints.append(0)
+            glyphs.append((0, 0, ENCODING_RAW))
+            continue
+        glyph = font.glyphs.get(cp)
+        if glyph is None:
+            raise PackError("font %s has no glyph for U+%04X" % (font.name, cp))
+        if glyph.width * max_scale > 32:
+            raise PackError(
+                "glyph U+%04X is too wide for the 32-bit blitter at %dx" % (cp, max_scale)
+            )
+        raw = encode_raw(glyph)
+        data, encoding = raw, ENCODING_RAW
+        if use_rle:
+            rle = encode_rle(glyph)
+            if len(rle) < len(raw):
+                data, encoding = rle, ENCODING_RLE
+        if len(blob) > 0xFFFF:
+            raise PackError("font bitmap blob exceeds 64 KiB")
+        codepoints.append(cp)
+        glyphs.append((len(blob), glyph.width, encoding))
+        blob += data
+    blob += bytes(TAIL_PADDING)
+    return PackedFont(first, codepoints, glyphs, bytes(blob))
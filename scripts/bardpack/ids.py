@@ -0,0 +1,65 @@
+"""Stable insult ids: a hash of the normalized text.
+
+History and saved state name corpus insults by id, not by position, so
+inserting, deleting or reordering lines in assets/insults.txt leaves every
+other line's id alone. Normalization makes cosmetic edits free too: case,
+runs of whitespace, compatibility forms and curly vs straight quotes don't
+change the id. Rewording a line gives it a new id (it is a new insult).
+
+An id is 32-bit FNV-1a of the normalized UTF-8, xor-folded to the 28 bits
+under the content-kind nibble (lib/content/content.h).
+"""
+
+import unicodedata
+
+from . import PackError
+
+ID_BITS = 28
+ID_MASK = (1 << ID_BITS) - 1
+
+_QUOTES = str.maketrans({"‘": "'", "’": "'", "“": '"', "”": '"'})
+
+
+def normalize(text):
+    text = unicodedata.normalize("NFKC", text).translate(_QUOTES).casefold()
+    return " ".join(text.split())
+
+
+def fnv1a32(data):
+    h = 0x811C9DC5
+    for b in data:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def line_id(text):
+    h = fnv1a32(normalize(text).encode("utf-8"))
+    return (h >> ID_BITS) ^ (h & ID_MASK)
+
+
+def build(entries, path):
+    """Returns (ids in corpus order, corpus indices sorted by id).
+
+    Fails on two lines that normalize the same (a duplicate) or, far less
+    likely, whose ids collide (reword one of them)."""
+    ids = [line_id(e.text) for e in entries]
+    seen = {}
+    for entry, i in zip(entries, ids):
+        other = seen.get(i)
+        if other is not None:
+            what = (
+                "duplicate of line %d" % other.lineno
+                if normalize(other.text) == normalize(entry.text)
+                else "id 0x%07x collides with line %d; reword one" % (i, other.lineno)
+            )
+            raise PackError("%s:%d: %s" % (path, entry.lineno, what))
+        seen[i] = entry
+    order = sorted(range(len(ids)), key=lambda k: ids[k])
+    return ids, order
+
+
+def fingerprint(ids):
+    """Changes whenever the set of ids does (not on a pure reorder)."""
+    data = b"".join(i.to_bytes(4, "little") for i in sorted(ids))
+    return fnv1a32(data)
@@ -0,0 +1,106 @@
+"""Panel geometry and word wrapping for the e-ink body text.
+
+This is the single source of truth for where insult text lands on the panel.
+The firmware gets these numbers as generated constants and never re-measures.
+"""
+
+from . import PackError
+
+# Waveshare 2.13" V4, landscape.
+PANEL_WIDTH = 250
+PANEL_HEIGHT = 122
+
+MARGIN = 4
+HEADER_HEIGHT = 12  # one scale-1 text row for the "[Done] (Random)" header
+
+BODY_X = MARGIN
+BODY_Y = MARGIN + HEADER_HEIGHT
+BODY_WIDTH = PANEL_WIDTH - 2 * MARGIN
+BODY_HEIGHT = PANEL_HEIGHT - BODY_Y - MARGIN
+
+# Integer glyph scales, largest first. The renderer uses the first one that
+# fits, so short lines get big text.
+FONT_SCALES = (3, 2, 1)
+
+LINE_GAP = 1  # blank rows between text lines, before scaling
+
+
+class Line:
+    def __init__(self, start, length, width):
+        self.start = start  # byte offset into the insult's encoded text
+        self.length = length  # bytes, excluding the break space
+        self.width = width  # pixels
+
+
+def line_pitch(font, scale):
+    return (font.height + LINE_GAP) * scale
+
+
+def max_lines(font, scale):
+    # The last line does not need its trailing gap.
+    return (BODY_HEIGHT + LINE_GAP * scale) // line_pitch(font, scale)
+
+
+def _run_width(font, scale, chars):
+    if not chars:
+        return 0
+    return sum(font.advance(c) for c in chars) * scale - font.spacing * scale
+
+
+def wrap(font, scale, text, encode):
+    """Greedy word wrap of `text` into BODY_WIDTH at `scale`.
+
+    `encode` maps a str to the byte string the firmware stores, so line offsets
+    are in the same units the renderer indexes with.
+
+    Returns a list of Line, or None if the text does not fit the body box.
+    """
+    for ch in text:
+        if not font.has(ch):
+            raise PackError("no glyph for %r (U+%04X)" % (ch, ord(ch)))
+
+    lines = []
+    cursor = 0  # char index into text
+    n = len(text)
+
+    while cursor < n:
+        # Skip the spaces we broke on.
+        while cursor < n and text[cursor] == " ":
+            cursor += 1
+        if cursor >= n:
+            break
+
+        end = cursor
+        best = None  # char index of the last word boundary that fits
+        while end < n:
+            word_end = end
+            while word_end < n and text[word_end] != " ":
+                word_end += 1
+            if _run_width(font, scale, text[cursor:word_end]) > BODY_WIDTH:
+                break
+            best = word_end
+            end = word_end
+            while end < n and text[end] == " ":
+                end += 1
+
+        if best is None:
+            # A single word wider than the panel: hard-break it by characters.
+            best = cursor + 1
+            while best < n and text[best] != " " and (
+                _run_width(font, scale, text[cursor : best + 1]) <= BODY_WIDTH
+            ):
+                best += 1
+            if _run_width(font, scale, text[cursor:best]) > BODY_WIDTH:
+                return None
+
+        chunk = text[cursor:best]
+        start = len(encode(text[:cursor]))
+        length = len(encode(chunk))
+        if length > 0xFF:
+            raise PackError("wrapped line longer than 255 bytes: %r" % chunk)
+        lines.append(Line(start, length, _run_width(font, scale, chunk)))
+        cursor = best
+
+    if len(lines) > max_lines(font, scale):
+        return None
+    return lines
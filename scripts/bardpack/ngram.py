@@ -0,0 +1,220 @@
+"""Word-level n-gram model of the corpus, trained at pack time.
+
+Words are the space-separated runs of each insult's codepage bytes
+(punctuation stays on its word). Word id 0 is the end-of-line token and also
+pads the start context. A state is the previous ORDER-1 word ids packed into
+a uint32 (older word in the high half); states are sorted by that key so the
+firmware finds one by binary search.
+
+Each state's successors are sorted by word id and carry a cumulative weight:
+counts are quantized to at most 8 bits, scaled so the state's total stays
+within uint16. Sampling draws r < total and binary-searches the first
+cumulative weight above it.
+
+The novelty table is an open-addressed hash set (FNV-1a of the line's bytes,
+0 = empty) so generated lines identical to a training line can be rejected.
+
+generate() replays the firmware's walk for a seed, so the pack step can
+check how many distinct lines a trained model really produces.
+"""
+
+from bisect import bisect_right
+
+from . import PackError
+
+END = 0
+MAX_WEIGHT = 0xFF
+MAX_TOTAL = 0xFFFF
+
+# Must match lib/ngram/ngram.h.
+TEXT_CAPACITY = 128  # NGRAM_TEXT_CAPACITY
+MAX_WORDS = 24  # NGRAM_MAX_WORDS
+MAX_ATTEMPTS = 8  # NGRAM_MAX_ATTEMPTS
+
+MASK32 = 0xFFFFFFFF
+
+
+def fnv1a(data):
+    """32-bit FNV-1a; must match ngramHash() in lib/ngram/ngram.cpp."""
+    h = 0x811C9DC5
+    for b in data:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h or 1  # 0 marks an empty slot
+
+
+class Model:
+    def __init__(self):
+        self.order = 0
+        self.words = []  # word id -> bytes; words[0] = b"" (END)
+        self.states = []  # [(key, [(word id, cumulative)])], sorted by key
+        self.novelty = []  # hash slots, power of two
+        self.max_words = 0  # longest training line in words
+
+
+def _key(context):
+    key = 0
+    for word in context:
+        key = (key << 16) | word
+    return key
+
+
+def _quantize(counts):
+    """counts: {word id: count} -> [(word id, cumulative)] sorted by word id."""
+    items = sorted(counts.items())
+    limit = min(MAX_WEIGHT, MAX_TOTAL // len(items))
+    top = max(c for _, c in items)
+    out = []
+    total = 0
+    for word, count in items:
+        weight = count if top <= limit else max(1, (count * limit) // top)
+        total += weight
+        out.append((word, total))
+    return out
+
+
+def train(lines, order):
+    """lines: codepage-encoded insult texts. Returns a Model."""
+    if order not in (2, 3):
+        raise PackError("custom_ngram_order must be 2 or 3, not %d" % order)
+
+    model = Model()
+    model.order = order
+    ids = {}
+    model.words.append(b"")
+    transitions = {}
+
+    for data in lines:
+        words = [w for w in data.split(b" ") if w]
+        model.max_words = max(model.max_words, len(words))
+        context = [END] * (order - 1)
+        for word in words + [None]:
+            if word is None:
+                wid = END
+            else:
+                wid = ids.get(word)
+                if wid is None:
+                    wid = len(model.words)
+                    ids[word] = wid
+                    model.words.append(word)
+            key = _key(context)
+            counts = transitions.setdefault(key, {})
+            counts[wid] = counts.get(wid, 0) + 1
+            context = context[1:] + [wid]
+
+    if len(model.words) > 0xFFFF:
+        raise PackError("n-gram vocabulary of %d words; ids are uint16_t" % len(model.words))
+
+    model.states = [(key, _quantize(transitions[key])) for key in sorted(transitions)]
+
+    slots = 1
+    while slots < 2 * len(lines):
+        slots *= 2
+    table = [0] * slots
+    for data in lines:
+        h = fnv1a(b" ".join(w for w in data.split(b" ") if w))
+        i = h & (slots - 1)
+        while table[i] not in (0, h):
+            i = (i + 1) & (slots - 1)
+        table[i] = h
+    model.novelty = table
+    return model
+
+
+def model_hash(model):
+    """Changes whenever the trained tables do, i.e. whenever a seed may
+    generate a different line. Saved seeds are dropped when it differs."""
+    parts = [bytes([model.order])]
+    for word in model.words:
+        parts.append(word + b"\0")
+    for key, successors in model.states:
+        parts.append(key.to_bytes(4, "little"))
+        for word, cumulative in successors:
+            parts.append(word.to_bytes(2, "little") + cumulative.to_bytes(2, "little"))
+    for h in model.novelty:
+        parts.append(h.to_bytes(4, "little"))
+    return fnv1a(b"".join(parts))
+
+
+def table_bytes(model):
+    """Flash the generated tables take (for the pack summary)."""
+    words = sum(len(w) + 1 for w in model.words) + 2 * (len(model.words) + 1)
+    states = 4 * len(model.states) + 2 * (len(model.states) + 1)
+    transitions = 4 * sum(len(t) for _, t in model.states)
+    return words + states + transitions + 4 * len(model.novelty)
+
+
+def _xorshift(x):
+    x ^= (x << 13) & MASK32
+    x ^= x >> 17
+    x ^= (x << 5) & MASK32
+    return x
+
+
+def _scramble(seed):
+    """Seed -> first xorshift state, as in ngramGenerate()."""
+    x = (seed ^ 0x9E3779B9) & MASK32
+    x ^= x >> 16
+    x = (x * 0x85EBCA6B) & MASK32
+    x ^= x >> 13
+    x = (x * 0xC2B2AE35) & MASK32
+    x ^= x >> 16
+    return x or 0x6D2B79F5
+
+
+def _walk(model, states, rng):
+    """One walk from the start state, as walk() in lib/ngram/ngram.cpp.
+    Returns (rng, line bytes or None)."""
+    context = 0
+    out = b""
+    for _ in range(MAX_WORDS + 1):
+        successors = states.get(context)
+        if successors is None:
+            return rng, None
+        words, cumulative = successors
+        rng = _xorshift(rng)
+        word = words[bisect_right(cumulative, rng % cumulative[-1])]
+        if word == END:
+            return rng, out
+        text = model.words[word]
+        needed = (1 if out else 0) + len(text)
+        if len(out) + needed >= TEXT_CAPACITY:
+            return rng, None
+        out = out + b" " + text if out else text
+        context = ((context << 16) | word) & MASK32 if model.order > 2 else word
+    return rng, None
+
+
+def generate(model, seed, states=None):
+    """The line ngramGenerate() produces for `seed` (before the panel-fit
+    check), or None if no novel line comes out within MAX_ATTEMPTS walks."""
+    if states is None:
+        states = _walk_table(model)
+    training = set(h for h in model.novelty if h)
+    rng = _scramble(seed)
+    for _ in range(MAX_ATTEMPTS):
+        rng, line = _walk(model, states, rng)
+        if line and fnv1a(line) not in training:
+            return line
+    return None
+
+
+def _walk_table(model):
+    return {
+        key: ([w for w, _ in successors], [c for _, c in successors])
+        for key, successors in model.states
+    }
+
+
+def sample(model, seeds):
+    """Generates every seed. Returns (distinct novel lines, failed seeds)."""
+    states = _walk_table(model)
+    lines = set()
+    failed = 0
+    for seed in seeds:
+        line = generate(model, seed, states)
+        if line is None:
+            failed += 1
+        else:
+            lines.add(line)
+    return len(lines), failed
@@ -0,0 +1,78 @@
+"""Pre-rasterize insult bodies into compressed framebuffer rows.
+
+The drawing here mirrors render.cpp + font.cpp pixel for pixel: same body
+box, same vertical/horizontal centering, same glyph scaling. The cached rows
+cover the full framebuffer width for BODY_Y..BODY_Y+BODY_HEIGHT-1, so the
+firmware can expand them straight over the framebuffer.
+
+Compressed stream, one token byte at a time:
+  0nnnnnnn            n+1 zero words
+  1nnnnnnn w0 w1 ...  n+1 literal words, 4 bytes each, little-endian
+"""
+
+from . import layout
+
+WORDS_PER_ROW = (layout.PANEL_WIDTH + 31) // 32
+ROW_BITS = WORDS_PER_ROW * 32
+
+
+def render_body(font, codepage, text_bytes, lines, scale):
+    """Returns BODY_HEIGHT rows as ints, bit (ROW_BITS-1-x) = pixel x."""
+    rows = [0] * layout.PANEL_HEIGHT
+    pitch = (font.height + layout.LINE_GAP) * scale
+    block = len(lines) * pitch - layout.LINE_GAP * scale
+    y = layout.BODY_Y + (layout.BODY_HEIGHT - block) // 2
+
+    for line in lines:
+        x = layout.BODY_X + (layout.BODY_WIDTH - line.width) // 2
+        for code in text_bytes[line.start : line.start + line.length]:
+            glyph = font.glyphs[codepage.to_codepoint[code]]
+            if glyph.width == 0:
+                continue
+            for r, row in enumerate(glyph.rows):
+                for c, px in enumerate(row):
+                    if px != "#":
+                        continue
+                    for sy in range(scale):
+                        py = y + r * scale + sy
+                        if py >= layout.PANEL_HEIGHT:
+                            continue
+                        for sx in range(scale):
+                            px_x = x + c * scale + sx
+                            if px_x < ROW_BITS:
+                                rows[py] |= 1 << (ROW_BITS - 1 - px_x)
+            x += (glyph.width + font.spacing) * scale
+        y += pitch
+
+    return rows[layout.BODY_Y : layout.BODY_Y + layout.BODY_HEIGHT]
+
+
+def to_words(rows):
+    words = []
+    for row in rows:
+        for w in range(WORDS_PER_ROW):
+            shift = (WORDS_PER_ROW - 1 - w) * 32
+            words.append((row >> shift) & 0xFFFFFFFF)
+    return words
+
+
+def compress(words):
+    out = bytearray()
+    i = 0
+    n = len(words)
+    while i < n:
+        if words[i] == 0:
+            run = 1
+            while i + run < n and words[i + run] == 0 and run < 128:
+                run += 1
+            out.append(run - 1)
+            i += run
+            continue
+        run = 1
+        while i + run < n and words[i + run] != 0 and run < 128:
+            run += 1
+        out.append(0x80 | (run - 1))
+        for w in words[i : i + run]:
+            out += w.to_bytes(4, "little")
+        i += run
+    return bytes(out)
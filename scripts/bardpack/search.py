@@ -0,0 +1,118 @@
+"""Trigram index over the corpus for the `find` console command (lib/search).
+
+Text is matched after folding, on codepage bytes:
+
+  fold    a 256-entry table: letters and digits map to their lowercase code,
+          everything else to 0 (a separator). Runs of separators become one
+          space; leading/trailing ones are dropped.
+  grams   every 3-byte window of the folded text, key = b0 << 16 | b1 << 8 | b2
+
+Each distinct trigram has a posting list of the insults that contain it:
+
+  varint count, then count varints: the first index, then gaps to the next
+
+Lists are concatenated in key order; `offsets` has one entry per key plus
+the end. Varints are LEB128 (7 bits per byte, low first).
+"""
+
+from . import PackError
+
+
+class Index:
+    def __init__(self, fold, keys, offsets, data):
+        self.fold = fold
+        self.keys = keys
+        self.offsets = offsets
+        self.data = data
+
+
+def fold_table(codepage):
+    table = [0] * 256
+    for code, cp in codepage.to_codepoint.items():
+        ch = chr(cp)
+        if not ch.isalnum():
+            continue
+        lower = ch.lower()
+        table[code] = codepage.to_byte.get(ord(lower), code) if len(lower) == 1 else code
+    return table
+
+
+def normalize(data, fold):
+    out = bytearray()
+    for b in data:
+        f = fold[b]
+        if f:
+            out.append(f)
+        elif out and out[-1] != 0x20:
+            out.append(0x20)
+    if out and out[-1] == 0x20:
+        out.pop()
+    return bytes(out)
+
+
+def grams(folded):
+    return {
+        folded[i] << 16 | folded[i + 1] << 8 | folded[i + 2]
+        for i in range(len(folded) - 2)
+    }
+
+
+def _varint(value, out):
+    while value >= 0x80:
+        out.append(0x80 | (value & 0x7F))
+        value >>= 7
+    out.append(value)
+
+
+def _read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+
+
+def build(texts, fold):
+    """texts: codepage-encoded insults, in corpus order."""
+    postings = {}
+    for index, text in enumerate(texts):
+        for gram in grams(normalize(text, fold)):
+            postings.setdefault(gram, []).append(index)
+
+    keys = sorted(postings)
+    offsets = []
+    data = bytearray()
+    for key in keys:
+        offsets.append(len(data))
+        members = postings[key]
+        _varint(len(members), data)
+        previous = 0
+        for index in members:
+            _varint(index - previous, data)
+            previous = index
+    offsets.append(len(data))
+
+    built = Index(fold, keys, offsets, bytes(data))
+    for i, key in enumerate(keys):
+        if decode(built, i) != postings[key]:
+            raise PackError("trigram list %06X does not round-trip" % key)
+    return built
+
+
+def decode(index, i):
+    """Posting list i back to insult indices (pack-time self-check)."""
+    pos = index.offsets[i]
+    count, pos = _read_varint(index.data, pos)
+    out = []
+    value = 0
+    for _ in range(count):
+        gap, pos = _read_varint(index.data, pos)
+        value += gap
+        out.append(value)
+    if pos != index.offsets[i + 1]:
+        raise PackError("trigram list %d has trailing bytes" % i)
+    return out
@@ -0,0 +1,78 @@
+"""Per-tag insult sets as roaring-style compressed bitmaps.
+
+Insult indices are split into chunks of CHUNK (256) by their high byte. A tag
+stores one container per chunk it has members in, and skips empty chunks:
+
+  array   sorted low bytes, one per member (fewer than ARRAY_MAX members)
+  bitmap  CHUNK bits, 32 bytes, bit i of byte i/8 = low byte i
+
+Containers are sorted by chunk key. The firmware expands them into an
+uncompressed set once per filter change (lib/tags).
+"""
+
+from . import PackError
+
+CHUNK = 256
+BITMAP_BYTES = CHUNK // 8
+ARRAY_MAX = BITMAP_BYTES  # an array this long is no smaller than a bitmap
+MAX_TAGS = 32
+
+ARRAY = 0
+BITMAP = 1
+
+# Derived tag: the insult lays out at the largest font scale.
+SHORT = "short"
+
+
+class Container:
+    def __init__(self, key, kind, cardinality, data):
+        self.key = key
+        self.kind = kind
+        self.cardinality = cardinality
+        self.data = data
+
+
+def _containers(members):
+    chunks = {}
+    for index in sorted(members):
+        chunks.setdefault(index // CHUNK, []).append(index % CHUNK)
+    out = []
+    for key in sorted(chunks):
+        lows = chunks[key]
+        if len(lows) < ARRAY_MAX:
+            out.append(Container(key, ARRAY, len(lows), bytes(lows)))
+        else:
+            bits = bytearray(BITMAP_BYTES)
+            for low in lows:
+                bits[low // 8] |= 1 << (low % 8)
+            out.append(Container(key, BITMAP, len(lows), bytes(bits)))
+    return out
+
+
+def build(entries, short):
+    """entries: corpus entries; short: set of indices that fit the largest
+    scale. Returns [(name, members, [Container])] sorted by name."""
+    members = {}
+    for i, entry in enumerate(entries):
+        for tag in entry.tags:
+            members.setdefault(tag, set()).add(i)
+    members.setdefault(SHORT, set()).update(short)
+    if len(members) > MAX_TAGS:
+        raise PackError("%d tags; at most %d are supported" % (len(members), MAX_TAGS))
+    return [(name, members[name], _containers(members[name])) for name in sorted(members)]
+
+
+def expand(containers, count):
+    """Containers back to a sorted index list (pack-time self-check)."""
+    out = []
+    for c in containers:
+        base = c.key * CHUNK
+        if c.kind == ARRAY:
+            out.extend(base + low for low in c.data)
+        else:
+            out.extend(
+                base + low for low in range(CHUNK) if c.data[low // 8] >> (low % 8) & 1
+            )
+    if any(i >= count for i in out):
+        raise PackError("tag container out of range")
+    return out
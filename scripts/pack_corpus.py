@@ -0,0 +1,829 @@
+"""Pack assets/ (insult corpus + bitmap font) into lib/corpus/corpus_gen.*,
+lib/font/font_gen.*, lib/render/raster_gen.*, lib/ngram/ngram_gen.*,
+lib/tags/tags_gen.* and lib/search/search_gen.*.
+
+Runs automatically before every PlatformIO build (see `extra_scripts` in
+platformio.ini) and can also be run by hand:
+
+    python3 scripts/pack_corpus.py
+
+Any insult that cannot be laid out on the 250x122 panel at any supported
+font scale fails the build.
+"""
+
+import math
+import os
+import sys
+
+
+def _project_dir():
+    try:
+        return env.subst("$PROJECT_DIR")  # noqa: F821 (PlatformIO SCons env)
+    except NameError:
+        return os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+PROJECT_DIR = _project_dir()
+sys.path.insert(0, os.path.join(PROJECT_DIR, "scripts"))
+
+from bardpack import PackError  # noqa: E402
+from bardpack import alias  # noqa: E402
+from bardpack import ids  # noqa: E402
+from bardpack import layout  # noqa: E402
+from bardpack import ngram  # noqa: E402
+from bardpack import search  # noqa: E402
+from bardpack import tags  # noqa: E402
+from bardpack import raster  # noqa: E402
+from bardpack.codepage import build_codepage  # noqa: E402
+from bardpack.corpus import load_corpus  # noqa: E402
+from bardpack.emit import BANNER, c_array, c_string, write_if_changed  # noqa: E402
+from bardpack.font import load_font  # noqa: E402
+from bardpack.fontpack import pack_font  # noqa: E402
+
+CORPUS_PATH = os.path.join(PROJECT_DIR, "assets", "insults.txt")
+FONT_PATH = os.path.join(PROJECT_DIR, "assets", "bard9.font")
+OUT_DIR = os.path.join(PROJECT_DIR, "lib", "corpus")
+FONT_OUT_DIR = os.path.join(PROJECT_DIR, "lib", "font")
+RENDER_OUT_DIR = os.path.join(PROJECT_DIR, "lib", "render")
+NGRAM_OUT_DIR = os.path.join(PROJECT_DIR, "lib", "ngram")
+TAGS_OUT_DIR = os.path.join(PROJECT_DIR, "lib", "tags")
+SEARCH_OUT_DIR = os.path.join(PROJECT_DIR, "lib", "search")
+HOTLIST_PATH = os.path.join(PROJECT_DIR, "assets", "hotlist.txt")
+
+
+def project_option(name, default):
+    """A `custom_*` option from platformio.ini, or `default` outside PlatformIO."""
+    try:
+        return env.GetProjectOption(name, default)  # noqa: F821
+    except NameError:
+        return default
+
+
+# Flash/latency trade-off for the pre-rasterized body cache: how many of the
+# hottest insults to cache, and the most flash the cache may use.
+RASTER_CACHE_LINES = int(project_option("custom_raster_cache_lines", "8"))
+RASTER_CACHE_BUDGET = int(project_option("custom_raster_cache_budget", "16384"))
+
+# Words of context + 1 for the n-gram generator (2 = bigram, 3 = trigram).
+NGRAM_ORDER = int(project_option("custom_ngram_order", "2"))
+
+# Share of new insults from the template grammar and the n-gram model, in
+# percent; the rest come from the corpus.
+GRAMMAR_DRAW_PERCENT = int(project_option("custom_grammar_draw_percent", "10"))
+NGRAM_DRAW_PERCENT = int(project_option("custom_ngram_draw_percent", "5"))
+
+
+# Seeds the pack step generates to see how many distinct lines the n-gram
+# model really has (seed i * golden ratio, like the firmware's 28-bit seeds).
+# Below NGRAM_MIN_DISTINCT_LINES the model mostly repeats a few lines, and its
+# draw share goes to the corpus.
+NGRAM_SAMPLE_SEEDS = 1024
+NGRAM_MIN_DISTINCT_LINES = 64
+
+
+def ngram_draw_percent(model, requested):
+    """The n-gram share to build with: `requested`, or 0 (with a warning)
+    when the model yields too few distinct novel lines."""
+    if requested == 0:
+        return 0
+    seeds = [(i * 0x9E3779B1) & 0x0FFFFFFF for i in range(1, NGRAM_SAMPLE_SEEDS + 1)]
+    distinct, failed = ngram.sample(model, seeds)
+    if distinct >= NGRAM_MIN_DISTINCT_LINES:
+        return requested
+    print(
+        "pack_corpus: warning: the n-gram model yields %d distinct novel lines "
+        "from %d seeds (%d failed; need %d); custom_ngram_draw_percent = %d "
+        "ignored, n-gram draws off. Add corpus lines to turn them back on."
+        % (
+            distinct,
+            NGRAM_SAMPLE_SEEDS,
+            failed,
+            NGRAM_MIN_DISTINCT_LINES,
+            requested,
+        )
+    )
+    return 0
+
+
+def check_draw_mix(grammar, ngram):
+    """Fails the build unless both shares are percentages that fit together."""
+    for name, value in (("grammar", grammar), ("ngram", ngram)):
+        if not 0 <= value <= 100:
+            raise PackError(
+                "custom_%s_draw_percent = %d; must be 0..100" % (name, value)
+            )
+    if grammar + ngram > 100:
+        raise PackError(
+            "custom_grammar_draw_percent + custom_ngram_draw_percent = %d; "
+            "must be at most 100" % (grammar + ngram)
+        )
+
+
+def build_layouts(entries, font, encode):
+    """Returns (lines, layouts): a flat list of layout.Line and, per insult and
+    per scale, a (firstLine, lineCount) pair. lineCount 0 = does not fit."""
+    lines = []
+    layouts = []
+    for entry in entries:
+        fits_somewhere = False
+        for scale in layout.FONT_SCALES:
+            try:
+                wrapped = layout.wrap(font, scale, entry.text, encode)
+            except PackError as e:
+                raise PackError("%s:%d: %s" % (CORPUS_PATH, entry.lineno, e))
+            if wrapped is None:
+                layouts.append((0, 0))
+                continue
+            fits_somewhere = True
+            layouts.append((len(lines), len(wrapped)))
+            lines.extend(wrapped)
+        if not fits_somewhere:
+            raise PackError(
+                "%s:%d: insult does not fit the %dx%d panel at any scale: %r"
+                % (
+                    CORPUS_PATH,
+                    entry.lineno,
+                    layout.PANEL_WIDTH,
+                    layout.PANEL_HEIGHT,
+                    entry.text,
+                )
+            )
+    if len(lines) >= (1 << 24):
+        raise PackError("layout table overflow: %d lines" % len(lines))
+    return lines, layouts
+
+
+def epoch_budgets(entries):
+    """Weights reduced by their GCD: how often each insult is drawn per
+    weighted epoch. Equal weights give 1 each, i.e. plain deck semantics."""
+    g = 0
+    for e in entries:
+        g = math.gcd(g, e.weight)
+    return [e.weight // g for e in entries]
+
+
+def render_header(entries, line_ids, grammar_percent, ngram_percent):
+    scales = ", ".join(str(s) for s in layout.FONT_SCALES)
+    return (
+        BANNER
+        + """
+#ifndef CORPUS_GEN_H
+#define CORPUS_GEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static constexpr size_t CORPUS_INSULT_COUNT = {count};
+
+// Draws in one weighted epoch (sum of corpusEpochBudgets[]).
+static constexpr uint32_t CORPUS_EPOCH_DRAWS = {epoch};
+
+// Changes whenever an insult is added, removed or reworded (not on a pure
+// reorder); saved history is remapped when it differs.
+static constexpr uint32_t CORPUS_ID_FINGERPRINT = 0x{fingerprint:08X};
+
+// Share of new insults from the generators, in percent
+// (custom_grammar_draw_percent, custom_ngram_draw_percent; the n-gram share
+// is 0 when the model yields too few distinct lines); the rest come from the
+// corpus.
+static constexpr uint8_t GRAMMAR_DRAW_PERCENT = {grammar_percent};
+static constexpr uint8_t NGRAM_DRAW_PERCENT = {ngram_percent};
+
+// Panel + body box geometry (scripts/bardpack/layout.py).
+static constexpr uint16_t PANEL_WIDTH = {pw};
+static constexpr uint16_t PANEL_HEIGHT = {ph};
+static constexpr uint16_t PANEL_MARGIN = {margin};
+static constexpr uint16_t BODY_X = {bx};
+static constexpr uint16_t BODY_Y = {by};
+static constexpr uint16_t BODY_WIDTH = {bw};
+static constexpr uint16_t BODY_HEIGHT = {bh};
+
+// Layout font scales (integer multiples of the bard9 font), largest first.
+static constexpr uint8_t FONT_LINE_GAP = {gap};
+static constexpr size_t CORPUS_FONT_SCALE_COUNT = {nscales};
+static constexpr uint8_t CORPUS_FONT_SCALES[CORPUS_FONT_SCALE_COUNT] = {{{scales}}};
+
+#endif // CORPUS_GEN_H
+""".format(
+            count=len(entries),
+            epoch=sum(epoch_budgets(entries)),
+            fingerprint=ids.fingerprint(line_ids[0]),
+            grammar_percent=grammar_percent,
+            ngram_percent=ngram_percent,
+            pw=layout.PANEL_WIDTH,
+            ph=layout.PANEL_HEIGHT,
+            margin=layout.MARGIN,
+            bx=layout.BODY_X,
+            by=layout.BODY_Y,
+            bw=layout.BODY_WIDTH,
+            bh=layout.BODY_HEIGHT,
+            gap=layout.LINE_GAP,
+            nscales=len(layout.FONT_SCALES),
+            scales=scales,
+        )
+    )
+
+
+def render_source(entries, line_ids, lines, layouts, encode):
+    blob_rows = []
+    offsets = []
+    offset = 0
+    for i, entry in enumerate(entries):
+        data = encode(entry.text)
+        offsets.append(offset)
+        blob_rows.append("    /* %d */ %s \"\\0\"" % (i, c_string(data)))
+        offset += len(data) + 1
+    offsets.append(offset)
+
+    line_rows = [
+        "    {%d, %d, %d}," % (ln.start, ln.length, ln.width) for ln in lines
+    ] or ["    {0, 0, 0},"]
+    layout_rows = []
+    for i in range(len(entries)):
+        row = layouts[i * len(layout.FONT_SCALES) : (i + 1) * len(layout.FONT_SCALES)]
+        layout_rows.append(
+            "    " + " ".join("{%d, %d}," % pair for pair in row) + " // %d" % i
+        )
+
+    return (
+        BANNER
+        + """
+#include "corpus.h"
+
+// NUL-terminated insult texts in the font codepage (see font.h), back to back.
+const char corpusBlob[] =
+{blob};
+
+const uint32_t corpusOffsets[CORPUS_INSULT_COUNT + 1] = {{
+{offsets}
+}};
+
+const CorpusLine corpusLines[] = {{
+{lines}
+}};
+
+// CORPUS_FONT_SCALE_COUNT entries per insult, in CORPUS_FONT_SCALES order.
+const CorpusLayout corpusLayouts[CORPUS_INSULT_COUNT * CORPUS_FONT_SCALE_COUNT] = {{
+{layouts}
+}};
+
+// Draw weights ({{w=N}} in assets/insults.txt) reduced by their GCD.
+const uint8_t corpusEpochBudgets[CORPUS_INSULT_COUNT] = {{
+{budgets}
+}};
+
+// Walker/Vose alias table over the weights (scripts/bardpack/alias.py).
+const CorpusAlias corpusAlias[CORPUS_INSULT_COUNT] = {{
+{alias}
+}};
+
+// Stable id per insult: hash of the normalized text (scripts/bardpack/ids.py).
+const uint32_t corpusIds[CORPUS_INSULT_COUNT] = {{
+{ids}
+}};
+
+// Insult indices sorted by id, for corpusFindId().
+const uint16_t corpusIdOrder[CORPUS_INSULT_COUNT] = {{
+{order}
+}};
+""".format(
+            blob="\n".join(blob_rows),
+            offsets=c_array(offsets),
+            lines="\n".join(line_rows),
+            layouts="\n".join(layout_rows),
+            budgets=c_array(epoch_budgets(entries)),
+            alias="\n".join(
+                "    {%d, %d}, // %d" % (threshold, other, i)
+                for i, (threshold, other) in enumerate(
+                    alias.build([e.weight for e in entries])
+                )
+            ),
+            ids="\n".join(
+                "    0x%07X, // %d" % (v, i) for i, v in enumerate(line_ids[0])
+            ),
+            order=c_array(line_ids[1]),
+        )
+    )
+
+
+def load_hotlist(entries):
+    """Insult indices, hottest first.
+
+    assets/hotlist.txt (optional) lists insult texts, one per line, hottest
+    first. Insults it doesn't mention follow in corpus order.
+    """
+    order = []
+    if os.path.exists(HOTLIST_PATH):
+        by_text = {e.text: i for i, e in enumerate(entries)}
+        with open(HOTLIST_PATH, encoding="utf-8") as f:
+            for raw in f:
+                line = raw.strip()
+                if not line or line.startswith("#"):
+                    continue
+                index = by_text.get(line)
+                if index is None:
+                    print("pack_corpus: warning: hotlist line not in corpus: %r" % line)
+                elif index not in order:
+                    order.append(index)
+    listed = set(order)
+    order += [i for i in range(len(entries)) if i not in listed]
+    return order
+
+
+def build_raster_cache(entries, font, codepage, lines, layouts):
+    """Returns [(index, compressed bytes)] sorted by index, within budget."""
+    cached = []
+    used = 0
+    nscales = len(layout.FONT_SCALES)
+    for index in load_hotlist(entries):
+        if len(cached) >= RASTER_CACHE_LINES:
+            break
+        for s in range(nscales):
+            first, count = layouts[index * nscales + s]
+            if count:
+                scale = layout.FONT_SCALES[s]
+                break
+        rows = raster.render_body(
+            font,
+            codepage,
+            codepage.encode(entries[index].text),
+            lines[first : first + count],
+            scale,
+        )
+        data = raster.compress(raster.to_words(rows))
+        if used + len(data) > RASTER_CACHE_BUDGET:
+            continue
+        cached.append((index, data))
+        used += len(data)
+    return sorted(cached)
+
+
+def render_raster_header(cached):
+    return (
+        BANNER
+        + """
+#ifndef RASTER_GEN_H
+#define RASTER_GEN_H
+
+#include <stddef.h>
+
+// custom_raster_cache_lines = {lines}, custom_raster_cache_budget = {budget}
+static constexpr size_t RASTER_CACHE_COUNT = {count};
+static constexpr size_t RASTER_CACHE_BYTES = {size};
+
+#endif // RASTER_GEN_H
+""".format(
+            lines=RASTER_CACHE_LINES,
+            budget=RASTER_CACHE_BUDGET,
+            count=len(cached),
+            size=sum(len(d) for _, d in cached),
+        )
+    )
+
+
+def render_raster_source(cached):
+    offsets = []
+    blob = bytearray()
+    for _, data in cached:
+        offsets.append(len(blob))
+        blob += data
+    offsets.append(len(blob))
+    return (
+        BANNER
+        + """
+#include "render.h"
+
+// Sorted insult indices with a pre-rasterized body.
+const uint16_t rasterCacheIndices[] = {{
+{indices}
+}};
+
+const uint32_t rasterCacheOffsets[] = {{
+{offsets}
+}};
+
+// Compressed body rows (see scripts/bardpack/raster.py for the format).
+const uint8_t rasterCacheData[] = {{
+{data}
+}};
+""".format(
+            indices=c_array(i for i, _ in cached),
+            offsets=c_array(offsets),
+            data=c_array(blob, fmt="0x%02X"),
+        )
+    )
+
+
+def render_ngram_header(model):
+    return (
+        BANNER
+        + """
+#ifndef NGRAM_GEN_H
+#define NGRAM_GEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// custom_ngram_order = {order}
+static constexpr uint8_t NGRAM_ORDER = {order};
+static constexpr size_t NGRAM_WORD_COUNT = {words};
+static constexpr size_t NGRAM_STATE_COUNT = {states};
+static constexpr size_t NGRAM_TRANSITION_COUNT = {transitions};
+static constexpr size_t NGRAM_NOVELTY_SLOTS = {slots};
+static constexpr size_t NGRAM_TABLE_BYTES = {size};
+
+// Changes whenever the trained tables do (any corpus edit, a new order):
+// saved seeds may then generate other lines and are dropped.
+static constexpr uint32_t NGRAM_MODEL_HASH = 0x{model_hash:08X};
+
+#endif // NGRAM_GEN_H
+""".format(
+            order=model.order,
+            words=len(model.words),
+            states=len(model.states),
+            transitions=sum(len(t) for _, t in model.states),
+            slots=len(model.novelty),
+            size=ngram.table_bytes(model),
+            model_hash=ngram.model_hash(model),
+        )
+    )
+
+
+def render_ngram_source(model):
+    blob_rows = []
+    offsets = []
+    offset = 0
+    for i, word in enumerate(model.words):
+        offsets.append(offset)
+        blob_rows.append("    /* %d */ %s \"\\0\"" % (i, c_string(word)))
+        offset += len(word) + 1
+    offsets.append(offset)
+    if offset > 0xFFFF:
+        raise PackError("n-gram word blob is %d bytes; offsets are uint16_t" % offset)
+
+    first = []
+    transitions = []
+    for _, successors in model.states:
+        first.append(len(transitions))
+        transitions.extend(successors)
+    first.append(len(transitions))
+    if len(transitions) > 0xFFFF:
+        raise PackError("%d n-gram transitions; offsets are uint16_t" % len(transitions))
+
+    return (
+        BANNER
+        + """
+#include "ngram.h"
+
+// Word id -> codepage bytes; id 0 is the end-of-line token.
+const char ngramWordBlob[] =
+{blob};
+
+const uint16_t ngramWordOffsets[NGRAM_WORD_COUNT + 1] = {{
+{offsets}
+}};
+
+// Sorted context keys (previous NGRAM_ORDER-1 word ids, older in the high
+// half) and where each state's transitions start.
+const uint32_t ngramStateKeys[NGRAM_STATE_COUNT] = {{
+{keys}
+}};
+
+const uint16_t ngramStateFirst[NGRAM_STATE_COUNT + 1] = {{
+{first}
+}};
+
+// Per state: successors by word id with quantized cumulative weights.
+const NgramTransition ngramTransitions[NGRAM_TRANSITION_COUNT] = {{
+{transitions}
+}};
+
+// FNV-1a of every training line (open addressing, 0 = empty).
+const uint32_t ngramNoveltyHashes[NGRAM_NOVELTY_SLOTS] = {{
+{novelty}
+}};
+""".format(
+            blob="\n".join(blob_rows),
+            offsets=c_array(offsets),
+            keys=c_array((k for k, _ in model.states), per_line=6, fmt="0x%08X"),
+            first=c_array(first),
+            transitions="\n".join(
+                "    {%d, %d}," % (word, cumulative) for word, cumulative in transitions
+            ),
+            novelty=c_array(model.novelty, per_line=6, fmt="0x%08X"),
+        )
+    )
+
+
+def build_tags(entries, layouts):
+    """Tag sets, with `short` = insults that fit at the largest scale."""
+    nscales = len(layout.FONT_SCALES)
+    short = {i for i in range(len(entries)) if layouts[i * nscales][1] > 0}
+    built = tags.build(entries, short)
+    for name, members, containers in built:
+        if tags.expand(containers, len(entries)) != sorted(members):
+            raise PackError("tag %r does not round-trip" % name)
+    return built
+
+
+def render_tags_header(built):
+    return (
+        BANNER
+        + """
+#ifndef TAGS_GEN_H
+#define TAGS_GEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static constexpr size_t TAG_COUNT = {count};
+static constexpr size_t TAG_CONTAINER_COUNT = {containers};
+static constexpr size_t TAG_DATA_BYTES = {size};
+
+#endif // TAGS_GEN_H
+""".format(
+            count=len(built),
+            containers=sum(len(c) for _, _, c in built),
+            size=sum(len(x.data) for _, _, c in built for x in c),
+        )
+    )
+
+
+def render_tags_source(built):
+    names = []
+    counts = []
+    first = []
+    rows = []
+    data = bytearray()
+    for name, members, containers in built:
+        names.append('    "%s",' % name)
+        counts.append(len(members))
+        first.append(len(rows))
+        for c in containers:
+            rows.append(
+                "    {%d, TagContainerKind::%s, %d, %d}, // %s"
+                % (
+                    c.key,
+                    "Array" if c.kind == tags.ARRAY else "Bitmap",
+                    c.cardinality,
+                    len(data),
+                    name,
+                )
+            )
+            data += c.data
+    first.append(len(rows))
+    if len(data) > 0xFFFF:
+        raise PackError("tag data is %d bytes; offsets are uint16_t" % len(data))
+
+    return (
+        BANNER
+        + """
+#include "tags.h"
+
+// Sorted by name; "short" is derived (fits at the largest font scale).
+const char *const tagNames[TAG_COUNT] = {{
+{names}
+}};
+
+const uint16_t tagMemberCounts[TAG_COUNT] = {{
+{counts}
+}};
+
+const uint16_t tagFirstContainer[TAG_COUNT + 1] = {{
+{first}
+}};
+
+// Per tag, sorted by chunk key (see scripts/bardpack/tags.py).
+const TagContainer tagContainers[] = {{
+{containers}
+}};
+
+const uint8_t tagData[] = {{
+{data}
+}};
+""".format(
+            names="\n".join(names),
+            counts=c_array(counts),
+            first=c_array(first),
+            containers="\n".join(rows) or "    {0, TagContainerKind::Array, 0, 0},",
+            data=c_array(data, fmt="0x%02X"),
+        )
+    )
+
+
+def render_search_header(index):
+    return (
+        BANNER
+        + """
+#ifndef SEARCH_GEN_H
+#define SEARCH_GEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static constexpr size_t SEARCH_TRIGRAM_COUNT = {count};
+static constexpr size_t SEARCH_POSTING_BYTES = {size};
+
+#endif // SEARCH_GEN_H
+""".format(count=len(index.keys), size=len(index.data))
+    )
+
+
+def render_search_source(index):
+    return (
+        BANNER
+        + """
+#include "search.h"
+
+// Codepage byte -> folded byte; 0 = separator (scripts/bardpack/search.py).
+const uint8_t searchFold[256] = {{
+{fold}
+}};
+
+// Sorted trigram keys (b0 << 16 | b1 << 8 | b2 over folded text).
+const uint32_t searchKeys[] = {{
+{keys}
+}};
+
+// searchPostings[] offset of each key's list, plus the end.
+const uint32_t searchOffsets[SEARCH_TRIGRAM_COUNT + 1] = {{
+{offsets}
+}};
+
+// Per key: varint count, then varint index gaps.
+const uint8_t searchPostings[] = {{
+{data}
+}};
+""".format(
+            fold=c_array(index.fold, per_line=16, fmt="0x%02X"),
+            keys=c_array(index.keys, per_line=8, fmt="0x%06X"),
+            offsets=c_array(index.offsets, per_line=8),
+            data=c_array(index.data, fmt="0x%02X"),
+        )
+    )
+
+
+def render_font_header(font, packed):
+    return (
+        BANNER
+        + """
+#ifndef FONT_GEN_H
+#define FONT_GEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Codepage bytes FONT_FIRST_CODE..FONT_LAST_CODE index fontGlyphs[] directly.
+static constexpr uint8_t FONT_FIRST_CODE = 0x{first:02X};
+static constexpr uint8_t FONT_LAST_CODE = 0x{last:02X};
+static constexpr size_t FONT_GLYPH_COUNT = {count};
+static constexpr uint8_t FONT_HEIGHT = {height};
+static constexpr uint8_t FONT_ASCENT = {ascent};
+static constexpr uint8_t FONT_SPACING = {spacing};
+
+#endif // FONT_GEN_H
+""".format(
+            first=packed.first_code,
+            last=packed.first_code + len(packed.codepoints) - 1,
+            count=len(packed.codepoints),
+            height=font.height,
+            ascent=font.ascent,
+            spacing=font.spacing,
+        )
+    )
+
+
+def render_font_source(font, packed):
+    glyph_rows = []
+    for i, (cp, (offset, width, encoding)) in enumerate(
+        zip(packed.codepoints, packed.glyphs)
+    ):
+        glyph_rows.append(
+            "    {%d, %d, GlyphEncoding::%s}, // 0x%02X -> %s"
+            % (
+                offset,
+                width,
+                "Rle" if encoding else "Raw",
+                packed.first_code + i,
+                "U+%04X" % cp if cp else "unused",
+            )
+        )
+    return (
+        BANNER
+        + """
+#include "font.h"
+
+// {name}: {count} glyphs, {size} bitmap bytes.
+const uint8_t fontBitmaps[] = {{
+{bitmaps}
+}};
+
+// Codepage byte -> Unicode code point (0 = unused), parallel to fontGlyphs[].
+const uint16_t fontCodepage[FONT_GLYPH_COUNT] = {{
+{codepoints}
+}};
+
+const FontGlyph fontGlyphs[FONT_GLYPH_COUNT] = {{
+{glyphs}
+}};
+""".format(
+            name=font.name,
+            count=len(packed.codepoints),
+            size=len(packed.bitmaps),
+            bitmaps=c_array(packed.bitmaps, fmt="0x%02X"),
+            codepoints=c_array(packed.codepoints, per_line=8, fmt="0x%04X"),
+            glyphs="\n".join(glyph_rows),
+        )
+    )
+
+
+def pack():
+    check_draw_mix(GRAMMAR_DRAW_PERCENT, NGRAM_DRAW_PERCENT)
+    font = load_font(FONT_PATH, "bard9")
+    entries = load_corpus(CORPUS_PATH)
+    codepage = build_codepage([e.text for e in entries], font)
+    lines, layouts = build_layouts(entries, font, codepage.encode)
+    packed = pack_font(font, codepage, max(layout.FONT_SCALES))
+    cached = build_raster_cache(entries, font, codepage, lines, layouts)
+    model = ngram.train([codepage.encode(e.text) for e in entries], NGRAM_ORDER)
+    ngram_percent = ngram_draw_percent(model, NGRAM_DRAW_PERCENT)
+    built_tags = build_tags(entries, layouts)
+    line_ids = ids.build(entries, CORPUS_PATH)
+    index = search.build(
+        [codepage.encode(e.text) for e in entries], search.fold_table(codepage)
+    )
+
+    changed = write_if_changed(
+        os.path.join(OUT_DIR, "corpus_gen.h"),
+        render_header(entries, line_ids, GRAMMAR_DRAW_PERCENT, ngram_percent),
+    )
+    changed |= write_if_changed(
+        os.path.join(OUT_DIR, "corpus_gen.cpp"),
+        render_source(entries, line_ids, lines, layouts, codepage.encode),
+    )
+    changed |= write_if_changed(
+        os.path.join(FONT_OUT_DIR, "font_gen.h"), render_font_header(font, packed)
+    )
+    changed |= write_if_changed(
+        os.path.join(FONT_OUT_DIR, "font_gen.cpp"), render_font_source(font, packed)
+    )
+    changed |= write_if_changed(
+        os.path.join(RENDER_OUT_DIR, "raster_gen.h"), render_raster_header(cached)
+    )
+    changed |= write_if_changed(
+        os.path.join(RENDER_OUT_DIR, "raster_gen.cpp"), render_raster_source(cached)
+    )
+    changed |= write_if_changed(
+        os.path.join(NGRAM_OUT_DIR, "ngram_gen.h"), render_ngram_header(model)
+    )
+    changed |= write_if_changed(
+        os.path.join(NGRAM_OUT_DIR, "ngram_gen.cpp"), render_ngram_source(model)
+    )
+    changed |= write_if_changed(
+        os.path.join(TAGS_OUT_DIR, "tags_gen.h"), render_tags_header(built_tags)
+    )
+    changed |= write_if_changed(
+        os.path.join(TAGS_OUT_DIR, "tags_gen.cpp"), render_tags_source(built_tags)
+    )
+    changed |= write_if_changed(
+        os.path.join(SEARCH_OUT_DIR, "search_gen.h"), render_search_header(index)
+    )
+    changed |= write_if_changed(
+        os.path.join(SEARCH_OUT_DIR, "search_gen.cpp"), render_search_source(index)
+    )
+    print(
+        "pack_corpus: %d insults, %d layout lines, %d glyphs (%d bytes), "
+        "%d cached bodies (%d bytes), %d-gram model (%d words, %d bytes), "
+        "%d tags, %d trigrams (%d bytes), draws %d%% grammar %d%% ngram%s"
+        % (
+            len(entries),
+            len(lines),
+            len(packed.codepoints),
+            len(packed.bitmaps),
+            len(cached),
+            sum(len(d) for _, d in cached),
+            model.order,
+            len(model.words),
+            ngram.table_bytes(model),
+            len(built_tags),
+            len(index.keys),
+            4 * (2 * len(index.keys) + 1) + len(index.data),
+            GRAMMAR_DRAW_PERCENT,
+            ngram_percent,
+            "" if changed else " (unchanged)",
+        )
+    )
+
+
+def main():
+    try:
+        pack()
+    except PackError as e:
+        print("pack_corpus: error: %s" % e, file=sys.stderr)
+        try:
+            env.Exit(1)  # noqa: F821
+        except NameError:
+            sys.exit(1)
+
+
+main()
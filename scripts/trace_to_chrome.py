@@ -0,0 +1,87 @@
+"""Convert a "trace dump" serial capture into Chrome trace_event JSON.
+
+    pio device monitor -b 115200 | tee trace.log    # then type: trace dump
+    python3 scripts/trace_to_chrome.py trace.log > trace.json
+
+Open trace.json in chrome://tracing or https://ui.perfetto.dev.
+
+Records are written when a scope exits, so their end times are in order;
+the 32-bit timestamps are unwrapped on end times (at hz=1000000 they wrap
+every ~71 min, far longer than the gap between records).
+"""
+
+import json
+import sys
+
+
+def parse(lines):
+    hz = None
+    names = {}
+    records = []
+    inside = False
+    for raw in lines:
+        line = raw.strip()
+        if line.startswith("TRACE BEGIN"):
+            inside = True
+            names = {}
+            records = []
+            fields = dict(f.split("=", 1) for f in line.split()[2:])
+            hz = int(fields["hz"])
+            continue
+        if not inside:
+            continue
+        if line == "TRACE END":
+            inside = False
+            continue
+        parts = line.split()
+        if parts[:1] == ["N"] and len(parts) >= 3:
+            names[int(parts[1])] = parts[2]
+        elif parts[:1] == ["R"] and len(parts) == 5:
+            start, duration, rid, depth = (int(p, 16) for p in parts[1:])
+            records.append((start, duration, rid, depth))
+    if hz is None:
+        raise SystemExit("no TRACE BEGIN found")
+    return hz, names, records
+
+
+def to_events(hz, names, records):
+    spans = []
+    epoch = 0
+    prev_end = None
+    for start, duration, rid, depth in records:
+        end = (start + duration) & 0xFFFFFFFF
+        if prev_end is not None and end + epoch < prev_end:
+            epoch += 1 << 32
+        end_abs = end + epoch
+        prev_end = end_abs
+        spans.append((end_abs - duration, duration, rid, depth))
+
+    # Timeline starts at the earliest recorded scope entry.
+    origin = min((s[0] for s in spans), default=0)
+    events = []
+    for start_abs, duration, rid, depth in spans:
+        events.append(
+            {
+                "name": names.get(rid, "id%d" % rid),
+                "ph": "X",
+                "ts": (start_abs - origin) * 1e6 / hz,
+                "dur": duration * 1e6 / hz,
+                "pid": 0,
+                "tid": 0,
+                "args": {"depth": depth, "ticks": duration},
+            }
+        )
+    return events
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else "-"
+    stream = sys.stdin if path == "-" else open(path, encoding="utf-8", errors="replace")
+    with stream:
+        hz, names, records = parse(stream)
+    json.dump({"traceEvents": to_events(hz, names, records)}, sys.stdout, indent=1)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()
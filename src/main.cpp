@@ -1,11 +1,29 @@
+#include "batterysim.h"
+#include "bench.h"
+#include "boot.h"
 #include "button.h"
+#include "clock.h"
+#include "console.h"
+#include "display.h"
+#include "driver/gpio.h"
 #include "driver/rtc_io.h"
+#include "energy.h"
+#include "favorites.h"
+#include "governor.h"
 #include "insults.h"
+#include "latency.h"
 #include "led.h"
 #include "persist_keys.h"
+#include "search.h"
+#include "tags.h"
+#include "trace.h"
+#include "ulp_wake.h"
+#include "usage.h"
+#include "wake.h"
 #include <Arduino.h>
 #include <Preferences.h>
 #include <esp_sleep.h>
+#include <esp_system.h>
 
 // ───────────────── Logging ───────────────────────
 
@@ -31,9 +49,13 @@ static constexpr uint8_t PIN_NEXT_BUTTON = 5;
 static constexpr uint8_t PIN_PREV_BUTTON = 6;
 static constexpr uint8_t PIN_SLEEP_BUTTON = 7;
 
-// Boot splash duration (Boot LED pattern)
+// Boot splash duration (Boot LED pattern), cold boot only.
 static constexpr uint32_t LED_BOOT_DURATION_MS = 2000;
 
+// Input is ignored for this long after boot/wake. On wake this is also how
+// long Resumed lasts before Idle.
+static constexpr uint32_t IGNORE_INPUT_AFTER_BOOT_MS = 200;
+
 // Toggle this later when you want boot-insult behavior on screen too.
 static constexpr bool PRINT_INSULT_ON_BOOT = true;
 
@@ -41,10 +63,83 @@ static constexpr bool PRINT_INSULT_ON_BOOT = true;
 // Using the same physical Sleep button for both sleep + wake.
 static constexpr gpio_num_t WAKEUP_GPIO = GPIO_NUM_7;
 
+// Inactivity governor: light sleep, then render + persist + deep sleep.
+// 0 disables a level.
+static constexpr GovernorConfig GOVERNOR_CONFIG = {
+    30 * 1000,     // lightSleepAfterMs
+    3 * 60 * 1000, // deepSleepAfterMs
+};
+
+// Current model for energy accounting ("energy" on the console). Rough
+// ESP32-S3 + NeoPixel + 2.13" e-paper figures; measure and adjust.
+static constexpr EnergyModel ENERGY_MODEL = {
+    40000,    // activeHighUa (240 MHz, radios off)
+    20000,    // activeLowUa (80 MHz)
+    250,      // lightSleepUa
+    10,       // deepSleepUa
+    700,      // ledQuiescentUa
+    12000,    // ledChannelUa
+    16000000, // displayRefreshUaMs (~8 mA for ~2 s)
+    200000,   // flashWriteUaMs (~20 mA for ~10 ms)
+};
+
+// Battery-life simulator inputs ("bench battery").
+static constexpr uint32_t DEEP_SLEEP_WAKE_MS = 300; // ROM + boot + Resumed
+static constexpr uint32_t BATTERY_CAPACITY_MAH = 1000;
+
+// Button GPIOs in ButtonId order.
+static constexpr uint8_t BUTTON_PINS[BUTTON_ID_COUNT] = {
+    PIN_SLEEP_BUTTON, PIN_RANDOM_BUTTON, PIN_NEXT_BUTTON, PIN_PREV_BUTTON};
+
+// EXT1 wake on the action buttons: the press that wakes also runs its action.
+static constexpr uint64_t WAKEUP_ACTION_PIN_MASK =
+    wakeExt1PinMask(PIN_RANDOM_BUTTON, PIN_NEXT_BUTTON, PIN_PREV_BUTTON);
+
+// Serial console commands ("help" lists them).
+static const ConsoleCommand consoleCommands[] = {
+    {"bench",
+     "bench <name>: run an on-device benchmark "
+     "(font|raster|clock|alias|grammar|ngram|recent|find|battery)",
+     benchCommand},
+    {"trace", "trace <start [ring|oneshot]|stop|mask <hex>|dump|clear>",
+     traceCommand},
+    {"boot", "boot: last cold-boot and wake timelines", bootProfileCommand},
+    {"clock", "clock [reset]: time at each CPU clock per state", clockCommand},
+    {"energy", "energy [save|reset]: residency and estimated mAh",
+     energyCommand},
+    {"lat", "lat [reset]: input-to-render latency percentiles", latencyCommand},
+    {"filter", "filter [tag&tag|tag|off]: draw only matching insults",
+     tagsCommand},
+    {"usage", "usage [N|save|reset]: most shown insults (hotlist format)",
+     usageCommand},
+    {"fav", "fav [only [on|off]|clear]: list favorites / favorites-only mode",
+     favoritesCommand},
+    {"history", "history: entries (capped), cursor and the newest ones",
+     historyCommand},
+    {"find", "find <text> | find #N: search the corpus / show result N",
+     searchCommand},
+};
+
 // ───────────────── App State ─────────────────────
 
-enum class ApplicationState { Boot, Idle, Updating };
-enum class ButtonId { Sleep, Random, Next, Prev };
+enum class ApplicationState { Boot, Resumed, Idle, Updating };
+
+// For "clock"/"energy" output, indexed by ApplicationState.
+static const char *const APPLICATION_STATE_NAMES[] = {"boot", "resumed",
+                                                      "idle", "updating"};
+
+/**
+ * @brief Tell the clock and energy modules about a new state.
+ *
+ * Idle only polls four pins, so it runs at the low clock; everything else
+ * runs at full speed.
+ */
+static void noteStateEntered(ApplicationState state) {
+  clockSetState(static_cast<uint8_t>(state), state == ApplicationState::Idle
+                                                 ? ClockDemand::Low
+                                                 : ClockDemand::High);
+  energySetState(static_cast<uint8_t>(state));
+}
 
 static ApplicationState currentState = ApplicationState::Boot;
 
@@ -62,6 +157,12 @@ static uint32_t ignoreInputUntil = 0;
 // classification.
 static bool needsSleepFlagClear = false;
 
+// Whether this boot followed deep sleep (for the boot timeline).
+static bool bootWasWake = false;
+
+// Inactivity governor state (see lib/governor/).
+static GovernorState governor;
+
 // ───────────────── State transitions ─────────────
 
 /**
@@ -73,6 +174,20 @@ static bool needsSleepFlagClear = false;
 static void enterBoot() {
   ledShowBoot();
   currentState = ApplicationState::Boot;
+  noteStateEntered(currentState);
+  stateEnteredAt = millis();
+}
+
+/**
+ * @brief Enter the Resumed state (wake fast path, no splash).
+ *
+ * The restored insult is already on screen; Resumed only waits out the
+ * post-wake input ignore window before Idle.
+ */
+static void enterResumed() {
+  ledShowIdle();
+  currentState = ApplicationState::Resumed;
+  noteStateEntered(currentState);
   stateEnteredAt = millis();
 }
 
@@ -88,15 +203,21 @@ static void enterIdle() {
   // Clear the sleep marker after the boot splash so a monitor-triggered reset
   // right after wake doesn’t misclassify future boots.
   if (needsSleepFlagClear) {
+    TRACE_SCOPE(TraceId::NvsWrite);
+    ClockBoost boost;
     Preferences prefs;
     if (prefs.begin(NVS_NS, false)) {
       prefs.putUChar("slept", 0);
       prefs.end();
+      energyNoteFlashWrite();
     }
     needsSleepFlagClear = false;
   }
 
+  bootProfileFinish(bootWasWake);
+
   currentState = ApplicationState::Idle;
+  noteStateEntered(currentState);
   stateEnteredAt = millis();
 }
 
@@ -108,6 +229,7 @@ static void enterIdle() {
 static void enterUpdating() {
   ledShowUpdating();
   currentState = ApplicationState::Updating;
+  noteStateEntered(currentState);
   stateEnteredAt = millis();
 }
 
@@ -121,6 +243,7 @@ static void restoreLedForState() {
   case ApplicationState::Boot:
     ledShowBoot();
     break;
+  case ApplicationState::Resumed:
   case ApplicationState::Idle:
     ledShowIdle();
     break;
@@ -131,7 +254,47 @@ static void restoreLedForState() {
 }
 
 /**
- * @brief Enter deep sleep and configure wake via the Sleep button (EXT0).
+ * @brief Configure one action button pin as a pulled-up RTC wake input.
+ */
+static void prepareActionWakePin(uint8_t pin) {
+  const gpio_num_t gpio = static_cast<gpio_num_t>(pin);
+  rtc_gpio_pullup_en(gpio);
+  rtc_gpio_pulldown_dis(gpio);
+}
+
+/**
+ * @brief Configure raw-level wake: Sleep button on EXT0, action buttons on
+ * EXT1 (any LOW).
+ */
+static void configureLevelWake() {
+  // Configure wake on Sleep button press (LOW).
+  esp_err_t err = esp_sleep_enable_ext0_wakeup(WAKEUP_GPIO, 0 /* LOW */);
+  if (err != ESP_OK) {
+    Serial.printf("EXT0 wake config failed: %d\n", err);
+  }
+
+  // Keep the wake pin at the inactive level while asleep.
+  // (Pull-up enabled since inactive is HIGH, pull-down disabled.)
+  rtc_gpio_pullup_en(WAKEUP_GPIO);
+  rtc_gpio_pulldown_dis(WAKEUP_GPIO);
+
+#if defined(CONFIG_IDF_TARGET_ESP32)
+  // The original ESP32 only has ALL_LOW, which can't express "any button".
+#else
+  err = esp_sleep_enable_ext1_wakeup(WAKEUP_ACTION_PIN_MASK,
+                                     ESP_EXT1_WAKEUP_ANY_LOW);
+  if (err != ESP_OK) {
+    Serial.printf("EXT1 wake config failed: %d\n", err);
+  }
+  prepareActionWakePin(PIN_RANDOM_BUTTON);
+  prepareActionWakePin(PIN_NEXT_BUTTON);
+  prepareActionWakePin(PIN_PREV_BUTTON);
+#endif
+}
+
+/**
+ * @brief Enter deep sleep and configure wake via the Sleep button (EXT0) and
+ * the action buttons (EXT1), or via the ULP button program.
  *
  * This configures EXT0 wake on the Sleep button GPIO.
  * EXT0 wake is *level-based* (not edge-based): the chip wakes when the RTC GPIO
@@ -140,6 +303,12 @@ static void restoreLedForState() {
  * With the button wired to GND and the pin using a pull-up, the “pressed” level
  * is LOW, so we wake on LOW. This means wake happens immediately on press.
  *
+ * Random/Next/Prev are EXT1 sources (any pin LOW); setup() reads which one
+ * woke us and runs its action (see lib/wake/).
+ *
+ * With BARD_ULP_WAKE, the ULP-RISC-V debounces all four buttons instead and
+ * wakes us only for a confirmed Tap/HoldStart (see lib/ulpwake/).
+ *
  * Before sleeping:
  * - Persist the insults module state so we can restore it on wake.
  * - Store an NVS "slept" flag so setup() can treat the next boot as
@@ -151,26 +320,22 @@ static void enterSleep() {
   // Turn off LEDs before power domains drop.
   ledOff();
 
-  // Configure wake on Sleep button press (LOW).
-  esp_err_t err = esp_sleep_enable_ext0_wakeup(WAKEUP_GPIO, 0 /* LOW */);
-  if (err != ESP_OK) {
-    Serial.printf("EXT0 wake config failed: %d\n", err);
-  }
-
-  // Keep the wake pin at the inactive level while asleep.
-  // (Pull-up enabled since inactive is HIGH, pull-down disabled.)
-  rtc_gpio_pullup_en(WAKEUP_GPIO);
-  rtc_gpio_pulldown_dis(WAKEUP_GPIO);
-
   // Persist app/module state for restore after wake.
   insultsPersistForSleep();
+  latencyPersistForSleep();
+  usageNoteSleep();
+  bootProfileNoteSleep();
+  energyNoteSleep();
 
   // Mark intent-to-sleep in NVS so next boot is treated as "wake".
   {
+    TRACE_SCOPE(TraceId::NvsWrite);
+    ClockBoost boost;
     Preferences prefs;
     if (prefs.begin(NVS_NS, false)) {
       prefs.putUChar("slept", 1);
       prefs.end();
+      energyNoteFlashWrite();
     }
   }
 
@@ -178,11 +343,127 @@ static void enterSleep() {
   Serial.flush();
   delay(50);
 
+  // Started last so the ULP can't report a gesture while we're still awake.
+  if (!ulpWakeStart(BUTTON_PINS)) {
+    configureLevelWake();
+  }
+
   esp_deep_sleep_start(); // returns void
 }
 
+/**
+ * @brief Light-sleep until a button goes LOW or `maxMs` passes.
+ *
+ * RAM, timers and the app state survive; loop() just continues afterwards,
+ * and the button that woke us is picked up by the normal polling. The LED is
+ * off meanwhile (a NeoPixel keeps drawing current while lit).
+ */
+static void lightSleepFor(uint32_t maxMs) {
+  TRACE_SCOPE(TraceId::LightSleep);
+  ledOff();
+
+  for (uint8_t pin : BUTTON_PINS) {
+    gpio_wakeup_enable(static_cast<gpio_num_t>(pin), GPIO_INTR_LOW_LEVEL);
+  }
+  esp_sleep_enable_gpio_wakeup();
+  if (maxMs != UINT32_MAX) {
+    esp_sleep_enable_timer_wakeup(static_cast<uint64_t>(maxMs) * 1000);
+  }
+
+  Serial.flush();
+  energySetMode(EnergyMode::LightSleep);
+  esp_light_sleep_start();
+  energySetMode(EnergyMode::Active);
+
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+  for (uint8_t pin : BUTTON_PINS) {
+    gpio_wakeup_disable(static_cast<gpio_num_t>(pin));
+  }
+  restoreLedForState();
+}
+
+/**
+ * @brief True while any button is down or settling.
+ *
+ * A held button produces no events after HoldStart, but its level-low GPIO
+ * wake would end every light sleep at once, so it has to count as busy.
+ */
+static bool anyButtonActive() {
+  const Button *const all[] = {&sleepButton, &randomButton, &nextButton,
+                               &prevButton};
+  for (const Button *button : all) {
+    if (button->core.pressed || button->core.edgePending) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief True while a serial console is attached or has input pending.
+ *
+ * The console is USB CDC (ARDUINO_USB_CDC_ON_BOOT), which stops in light
+ * sleep and can't wake the chip, so typed commands would be lost until a
+ * button press. With CDC, `Serial` is true only while a USB host is
+ * connected; on battery there is none and the governor sleeps as usual.
+ */
+static bool consoleActive() {
+  return static_cast<bool>(Serial) || Serial.available() > 0;
+}
+
+/**
+ * @brief Apply the governor's decision for this loop iteration.
+ *
+ * Logs each level change, so the escalation timeline shows up on Serial
+ * (and as lightSleep/sleepPrepare scopes in trace output).
+ */
+static void runGovernor(uint32_t now) {
+  const PowerLevel previous = governor.level;
+  const bool busy = (currentState != ApplicationState::Idle) || sleepArmed ||
+                    anyButtonActive() || consoleActive();
+  const PowerLevel level =
+      governorStep(GOVERNOR_CONFIG, governor, now, busy);
+
+  if (level != previous) {
+    Serial.printf("[Governor] %s -> %s after %lu ms idle\n",
+                  governorLevelName(previous), governorLevelName(level),
+                  static_cast<unsigned long>(now - governor.lastActivityAt));
+  }
+
+  switch (level) {
+  case PowerLevel::Active:
+  case PowerLevel::Count:
+    break;
+  case PowerLevel::LightSleep:
+    lightSleepFor(governorMsUntilNextLevel(GOVERNOR_CONFIG, governor, now));
+    break;
+  case PowerLevel::DeepSleep: {
+    // E-ink keeps the image with the MCU off: leave the insult on screen.
+    TRACE_SCOPE(TraceId::SleepPrepare);
+    insultsEnsureOnDisplay();
+    enterSleep();
+    break;
+  }
+  }
+}
+
 // ───────────────── Work Orchestration ────────────
 
+/**
+ * @brief Start an insult operation from a button intent.
+ *
+ * On success, opens the latency record for this intent (using the button's
+ * edge/decision timestamps) and transitions to Updating.
+ */
+static void startOperation(ButtonId buttonId, const Button &button,
+                           PendingAction action, uint32_t now) {
+  if (!insultsStartOperation(action, now)) {
+    return;
+  }
+  latencyBegin(buttonId, action, button.edgeAtUs, button.eventAtUs);
+  enterUpdating();
+}
+
 /**
  * @brief Handle a debounced button intent event and apply app-level behavior.
  *
@@ -198,6 +479,8 @@ static void enterSleep() {
  * Random/Next/Prev behavior:
  * - Only processed while in Idle.
  * - Tap starts the corresponding insult operation and transitions to Updating.
+ * - Random HoldStart marks/unmarks the current insult as a favorite.
+ * - Prev HoldStart toggles favorites-only mode.
  */
 static void handleButtonEvent(ButtonId buttonId, ButtonEvent event,
                               uint32_t now) {
@@ -205,6 +488,8 @@ static void handleButtonEvent(ButtonId buttonId, ButtonEvent event,
     return;
   }
 
+  TRACE_SCOPE(TraceId::HandleButtonEvent);
+
   // Ignore all button intent events for a short window after boot/wake.
   // Wraparound-safe check.
   if (static_cast<int32_t>(now - ignoreInputUntil) < 0) {
@@ -244,25 +529,48 @@ static void handleButtonEvent(ButtonId buttonId, ButtonEvent event,
     switch (buttonId) {
     case ButtonId::Random:
       APP_LOGLN("[Random] Tap");
-      if (insultsStartOperation(PendingAction::Random, now)) {
-        enterUpdating();
-      }
+      startOperation(buttonId, randomButton, PendingAction::Random, now);
       break;
     case ButtonId::Next:
       APP_LOGLN("[Next] Tap");
-      if (insultsStartOperation(PendingAction::Next, now)) {
-        enterUpdating();
-      }
+      startOperation(buttonId, nextButton, PendingAction::Next, now);
       break;
     case ButtonId::Prev:
       APP_LOGLN("[Prev] Tap");
-      if (insultsStartOperation(PendingAction::Prev, now)) {
-        enterUpdating();
-      }
+      startOperation(buttonId, prevButton, PendingAction::Prev, now);
       break;
     default:
       break;
     }
+    return;
+  }
+
+  if (event == ButtonEvent::HoldStart) {
+    if (buttonId == ButtonId::Random) {
+      uint32_t id = 0;
+      if (!insultsCurrentId(id)) {
+        return;
+      }
+      switch (favoritesToggle(id)) {
+      case FavoriteToggle::Added:
+        APP_LOGLN("[Fav] Random hold: added");
+        break;
+      case FavoriteToggle::Removed:
+        APP_LOGLN("[Fav] Random hold: removed");
+        break;
+      case FavoriteToggle::Full:
+        APP_LOGLN("[Fav] Random hold: favorites full");
+        break;
+      }
+    } else if (buttonId == ButtonId::Prev) {
+      if (!favoritesSetOnly(!favoritesOnly())) {
+        APP_LOGLN("[Fav] Prev hold: no favorites yet");
+      } else if (favoritesOnly()) {
+        APP_LOGLN("[Fav] Prev hold: favorites-only on");
+      } else {
+        APP_LOGLN("[Fav] Prev hold: favorites-only off");
+      }
+    }
   }
 }
 
@@ -273,17 +581,36 @@ static void handleButtonEvent(ButtonId buttonId, ButtonEvent event,
  * - Reads an NVS "slept" flag to classify this boot as wake-from-deep-sleep.
  * - Sets a brief ignore window to suppress accidental input immediately after
  * boot/wake.
- * - Initializes LEDs and buttons.
+ * - Initializes LEDs, the display framebuffer and buttons.
  * - If waking from EXT0 deep sleep, deinitializes the wake GPIO from RTC IO
  * mode so it can be used as a normal digital input with INPUT_PULLUP again.
- * - Enters Boot state (boot LED splash) and initializes the insults module.
+ * - On a deep-sleep wake, skips the serial settle delay and the boot splash
+ * and enters Resumed; otherwise enters Boot (boot LED splash). Then
+ * initializes the insults module, which restores and renders the last insult
+ * on wake.
+ * - If an action button woke us (EXT1, or a ULP-confirmed Tap), starts that
+ * action right away.
+ * - Registers the serial console commands.
+ * - Marks each phase on the boot timeline (see lib/boot/).
  */
 void setup() {
+  bootProfileStart();
+  clockInit(APPLICATION_STATE_NAMES,
+            sizeof(APPLICATION_STATE_NAMES) / sizeof(APPLICATION_STATE_NAMES[0]));
+
+  // Classify early from the hardware reset reason; the NVS flag below is
+  // still what decides whether to restore state.
+  const bool fastWake = (esp_reset_reason() == ESP_RST_DEEPSLEEP);
+
   Serial.begin(115200);
-  delay(50);
+  if (!fastWake) {
+    delay(50);
+  }
+  bootProfileMark(BootPhase::Serial);
 
   bool wokeFromSleep = false;
   {
+    TRACE_SCOPE(TraceId::NvsRead);
     Preferences prefs;
     if (prefs.begin(NVS_NS, false)) {
       const uint8_t slept = prefs.getUChar("slept", 0);
@@ -297,46 +624,114 @@ void setup() {
       prefs.end();
     }
   }
+  bootWasWake = wokeFromSleep;
+  energyInit(ENERGY_MODEL, APPLICATION_STATE_NAMES,
+             sizeof(APPLICATION_STATE_NAMES) / sizeof(APPLICATION_STATE_NAMES[0]),
+             wokeFromSleep);
+  batterySimSetPlatform({GOVERNOR_CONFIG, ENERGY_MODEL, LED_BRIGHTNESS,
+                         MOCK_WORK_MS, DEEP_SLEEP_WAKE_MS,
+                         BATTERY_CAPACITY_MAH});
+  bootProfileMark(BootPhase::NvsRead);
 
   Serial.println();
   Serial.println(F("Booting Bard's Assistant..."));
 
   // Seed RNG for deck shuffling
   randomSeed(esp_random());
+  bootProfileMark(BootPhase::Seed);
 
   // Ignore intent events briefly after boot/wake.
-  ignoreInputUntil = millis() + 200;
+  ignoreInputUntil = millis() + IGNORE_INPUT_AFTER_BOOT_MS;
 
   ledInit();
+  bootProfileMark(BootPhase::Led);
+  displayInit();
+  bootProfileMark(BootPhase::Display);
 
-  // After EXT0 deep-sleep wake, the wake pin may be latched as RTC IO.
-  // Deinit it so we can use it as a normal GPIO with INPUT_PULLUP.
+  // After EXT0/EXT1 deep-sleep wake, the wake pins may be latched as RTC IO.
+  // Deinit them so we can use them as normal GPIOs with INPUT_PULLUP.
   // On cold boot this is a no-op (returns error, which we ignore)
   rtc_gpio_deinit(WAKEUP_GPIO);
+  rtc_gpio_deinit(static_cast<gpio_num_t>(PIN_RANDOM_BUTTON));
+  rtc_gpio_deinit(static_cast<gpio_num_t>(PIN_NEXT_BUTTON));
+  rtc_gpio_deinit(static_cast<gpio_num_t>(PIN_PREV_BUTTON));
 
   buttonInit(sleepButton, PIN_SLEEP_BUTTON);
   buttonInit(randomButton, PIN_RANDOM_BUTTON);
   buttonInit(nextButton, PIN_NEXT_BUTTON);
   buttonInit(prevButton, PIN_PREV_BUTTON);
+  bootProfileMark(BootPhase::Buttons);
 
-  enterBoot();
+  if (fastWake && wokeFromSleep) {
+    enterResumed();
+  } else {
+    enterBoot();
+  }
 
+  tagsInit(wokeFromSleep);
+  usageInit(wokeFromSleep);
+  favoritesInit();
   insultsInit(PRINT_INSULT_ON_BOOT, wokeFromSleep);
+  bootProfileMark(BootPhase::Insults);
+
+  // Wake-by-action: run the action of the button that woke us, and swallow
+  // that press so its release doesn't tap again.
+  if (fastWake && wokeFromSleep) {
+    PendingAction wakeAction = PendingAction::None;
+    const esp_sleep_source_t cause = esp_sleep_get_wakeup_cause();
+    if (cause == ESP_SLEEP_WAKEUP_EXT1) {
+      wakeAction = wakeActionFromExt1Mask(esp_sleep_get_ext1_wakeup_status(),
+                                          PIN_RANDOM_BUTTON, PIN_NEXT_BUTTON,
+                                          PIN_PREV_BUTTON);
+      buttonIgnoreUntilRelease(randomButton);
+      buttonIgnoreUntilRelease(nextButton);
+      buttonIgnoreUntilRelease(prevButton);
+    } else if (cause == ESP_SLEEP_WAKEUP_ULP) {
+      ButtonId gestureButton = ButtonId::Sleep;
+      ButtonEvent gestureEvent = ButtonEvent::None;
+      if (ulpWakeTakeGesture(gestureButton, gestureEvent)) {
+        wakeAction = wakeActionFromGesture(gestureButton, gestureEvent);
+      }
+      // A HoldStart gesture is still held down.
+      buttonIgnoreUntilRelease(sleepButton);
+      buttonIgnoreUntilRelease(randomButton);
+      buttonIgnoreUntilRelease(nextButton);
+      buttonIgnoreUntilRelease(prevButton);
+    }
+    if (wakeAction != PendingAction::None &&
+        insultsStartOperation(wakeAction, millis())) {
+      APP_LOGLN("[Wake] running the wake button's action");
+      enterUpdating();
+    }
+  }
+
+  consoleInit(consoleCommands,
+              sizeof(consoleCommands) / sizeof(consoleCommands[0]));
+
+  governorInit(governor, millis());
 }
 
 /**
  * @brief Main application loop: poll buttons and advance the state machine.
  *
+ * - Runs any complete serial console command.
  * - Polls all buttons and routes debounced intent events through
  * handleButtonEvent().
  * - Boot: holds the boot LED splash for a short duration, then enters Idle.
+ * - Resumed: enters Idle as soon as the post-wake ignore window has passed.
  * - Idle: waits for button-driven actions.
  * - Updating: advances the active insult operation via insultsPoll() until
  * done.
+ * - Finally lets the inactivity governor light-sleep or deep-sleep the device
+ * once it has been idle long enough.
  */
 void loop() {
+  TRACE_SCOPE(TraceId::Loop);
   const uint32_t now = millis();
 
+  const bool consoleInput = consolePoll();
+  energyPoll();
+
   // Poll buttons
   const ButtonEvent sleepEvent = updateButton(sleepButton, now);
   const ButtonEvent randomEvent = updateButton(randomButton, now);
@@ -348,6 +743,12 @@ void loop() {
   handleButtonEvent(ButtonId::Next, nextEvent, now);
   handleButtonEvent(ButtonId::Prev, prevEvent, now);
 
+  if (consoleInput || sleepEvent != ButtonEvent::None ||
+      randomEvent != ButtonEvent::None || nextEvent != ButtonEvent::None ||
+      prevEvent != ButtonEvent::None) {
+    governorNoteActivity(governor, now);
+  }
+
   // High-level app state machine
   switch (currentState) {
   case ApplicationState::Boot:
@@ -356,6 +757,12 @@ void loop() {
     }
     break;
 
+  case ApplicationState::Resumed:
+    if (static_cast<int32_t>(now - ignoreInputUntil) >= 0) {
+      enterIdle();
+    }
+    break;
+
   case ApplicationState::Idle:
     break;
 
@@ -365,4 +772,6 @@ void loop() {
     }
     break;
   }
+
+  runGovernor(now);
 }
@@ -0,0 +1,142 @@
+// Debounce + tap/hold state machine shared by the main cores and the ULP
+// (button_core.h).
+
+#include "button_core.h"
+#include <unity.h>
+
+static ButtonCore core;
+
+void setUp() { buttonCoreInit(&core, false, 0); }
+void tearDown() {}
+
+/**
+ * @brief Hold the raw level for [from, to) in 1 ms samples.
+ *
+ * @return The first event seen, or BUTTON_CORE_NONE.
+ */
+static ButtonCoreEvent hold(bool rawPressed, uint32_t from, uint32_t to,
+                            uint32_t *outAt = nullptr) {
+  for (uint32_t now = from; now < to; ++now) {
+    const ButtonCoreEvent event = buttonCoreUpdate(&core, rawPressed, now);
+    if (event != BUTTON_CORE_NONE) {
+      if (outAt) {
+        *outAt = now;
+      }
+      return event;
+    }
+  }
+  return BUTTON_CORE_NONE;
+}
+
+static void test_short_glitch_is_rejected() {
+  // Pressed for less than the debounce time, then released for good.
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(true, 100, 100 + 20));
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(false, 120, 2000));
+  TEST_ASSERT_FALSE(core.pressed);
+}
+
+static void test_chatter_restarts_the_window() {
+  // Contact bounce: the level flips every 10 ms, never stable for 30 ms.
+  for (uint32_t now = 100; now < 400; now += 10) {
+    TEST_ASSERT_EQUAL(BUTTON_CORE_NONE,
+                      hold(((now / 10) & 1) != 0, now, now + 10));
+  }
+  TEST_ASSERT_FALSE(core.pressed);
+}
+
+static void test_tap() {
+  uint32_t at = 0;
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(true, 100, 300));
+  TEST_ASSERT_TRUE(core.pressed);
+  TEST_ASSERT_EQUAL(BUTTON_CORE_TAP, hold(false, 300, 400, &at));
+  // Reported once the release has been stable for the debounce time.
+  TEST_ASSERT_EQUAL_UINT32(300 + BUTTON_DEBOUNCE_TIME_MS, at);
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(false, 400, 2000));
+}
+
+static void test_bouncy_tap_is_one_tap() {
+  hold(true, 100, 105);
+  hold(false, 105, 108);
+  hold(true, 108, 300);
+  hold(false, 300, 302);
+  hold(true, 302, 305);
+  TEST_ASSERT_EQUAL(BUTTON_CORE_TAP, hold(false, 305, 400));
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(false, 400, 2000));
+}
+
+static void test_hold_start_then_hold_end() {
+  uint32_t at = 0;
+  TEST_ASSERT_EQUAL(BUTTON_CORE_HOLD_START, hold(true, 100, 2000, &at));
+  // The press is debounced at 130 ms; the hold is timed from there.
+  TEST_ASSERT_EQUAL_UINT32(100 + BUTTON_DEBOUNCE_TIME_MS +
+                               BUTTON_HOLD_THRESHOLD_MS,
+                           at);
+  // HoldStart fires once, and the release is a HoldEnd, not a Tap.
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(true, at + 1, 3000));
+  TEST_ASSERT_EQUAL(BUTTON_CORE_HOLD_END, hold(false, 3000, 3100));
+}
+
+static void test_release_just_before_hold_is_tap() {
+  hold(true, 100, 101);
+  // Debounced at 130; HoldStart would fire at 930.
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(true, 101, 930));
+  TEST_ASSERT_EQUAL(BUTTON_CORE_TAP, hold(false, 930, 1000));
+}
+
+static void test_ignore_until_release_swallows_tap() {
+  hold(true, 100, 200);
+  buttonCoreIgnoreUntilRelease(&core, true);
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(false, 200, 300));
+  TEST_ASSERT_FALSE(core.ignoreUntilRelease);
+  // The next press is reported normally.
+  hold(true, 300, 400);
+  TEST_ASSERT_EQUAL(BUTTON_CORE_TAP, hold(false, 400, 500));
+}
+
+static void test_ignore_until_release_swallows_hold() {
+  hold(true, 100, 200);
+  buttonCoreIgnoreUntilRelease(&core, true);
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(true, 200, 3000));
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(false, 3000, 3100));
+}
+
+static void test_ignore_before_press_is_debounced() {
+  // The wake press is latched before the debounce saw it: the flag is set
+  // from the raw level, and a release that settles clears it.
+  buttonCoreInit(&core, true, 0);
+  buttonCoreIgnoreUntilRelease(&core, true);
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(true, 0, 10));
+  TEST_ASSERT_EQUAL(BUTTON_CORE_NONE, hold(false, 10, 100));
+  TEST_ASSERT_FALSE(core.ignoreUntilRelease);
+  hold(true, 100, 200);
+  TEST_ASSERT_EQUAL(BUTTON_CORE_TAP, hold(false, 200, 300));
+}
+
+static void test_ignore_when_released_is_noop() {
+  buttonCoreIgnoreUntilRelease(&core, false);
+  hold(true, 100, 200);
+  TEST_ASSERT_EQUAL(BUTTON_CORE_TAP, hold(false, 200, 300));
+}
+
+static void test_edge_pending() {
+  buttonCoreUpdate(&core, true, 100);
+  TEST_ASSERT_TRUE(core.edgePending);
+  hold(true, 101, 200);
+  TEST_ASSERT_FALSE(core.edgePending);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_short_glitch_is_rejected);
+  RUN_TEST(test_chatter_restarts_the_window);
+  RUN_TEST(test_tap);
+  RUN_TEST(test_bouncy_tap_is_one_tap);
+  RUN_TEST(test_hold_start_then_hold_end);
+  RUN_TEST(test_release_just_before_hold_is_tap);
+  RUN_TEST(test_ignore_until_release_swallows_tap);
+  RUN_TEST(test_ignore_until_release_swallows_hold);
+  RUN_TEST(test_ignore_before_press_is_debounced);
+  RUN_TEST(test_ignore_when_released_is_noop);
+  RUN_TEST(test_edge_pending);
+  return UNITY_END();
+}
@@ -0,0 +1,127 @@
+// Weighted corpus draws (corpus.h) against the packed weights: alias-table
+// goodness of fit and exact per-epoch budgets. Fixed seed, so a failure
+// reproduces; `bench alias` measures the speed on the device.
+
+#include "corpus.h"
+#include <unity.h>
+
+#include <math.h>
+#include <string.h>
+
+static constexpr uint32_t ALIAS_TEST_DRAWS = 200000;
+static constexpr uint32_t EPOCH_TEST_EPOCHS = 64;
+static constexpr uint32_t SEED = 0x2545F491;
+
+static uint32_t randomState;
+static uint32_t counts[CORPUS_INSULT_COUNT];
+
+static uint32_t testRandom() {
+  uint32_t x = randomState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  randomState = x;
+  return x;
+}
+
+void setUp() {
+  randomState = SEED;
+  memset(counts, 0, sizeof(counts));
+}
+
+void tearDown() {}
+
+/**
+ * @brief Upper 99.9% quantile of chi-square with `dof` degrees of freedom.
+ *
+ * Wilson–Hilferty approximation; close even for a handful of insults.
+ */
+static double chiSquareLimit(double dof) {
+  const double z = 3.09;
+  const double a = 2.0 / (9.0 * dof);
+  const double c = 1.0 - a + z * sqrt(a);
+  return dof * c * c * c;
+}
+
+static void test_alias_table_is_well_formed() {
+  for (size_t i = 0; i < CORPUS_INSULT_COUNT; ++i) {
+    TEST_ASSERT_LESS_THAN(CORPUS_INSULT_COUNT, corpusAlias[i].alias);
+    TEST_ASSERT_GREATER_THAN(0, corpusEpochBudgets[i]);
+  }
+  uint32_t total = 0;
+  for (size_t i = 0; i < CORPUS_INSULT_COUNT; ++i) {
+    total += corpusEpochBudgets[i];
+  }
+  TEST_ASSERT_EQUAL_UINT32(CORPUS_EPOCH_DRAWS, total);
+}
+
+static void test_alias_draws_fit_the_weights() {
+  for (uint32_t i = 0; i < ALIAS_TEST_DRAWS; ++i) {
+    const uint16_t index = corpusAliasDraw(testRandom());
+    TEST_ASSERT_LESS_THAN(CORPUS_INSULT_COUNT, index);
+    counts[index]++;
+  }
+  double chi2 = 0;
+  for (size_t i = 0; i < CORPUS_INSULT_COUNT; ++i) {
+    const double expected = static_cast<double>(ALIAS_TEST_DRAWS) *
+                            corpusEpochBudgets[i] / CORPUS_EPOCH_DRAWS;
+    const double diff = counts[i] - expected;
+    chi2 += diff * diff / expected;
+  }
+  const double dof = CORPUS_INSULT_COUNT > 1 ? CORPUS_INSULT_COUNT - 1 : 1;
+  TEST_ASSERT_LESS_OR_EQUAL(chiSquareLimit(dof), chi2);
+}
+
+static void test_alias_draw_edges() {
+  // r = 0 lands on slot 0 and r = ~0 on the last slot (or its alias).
+  const uint16_t first = corpusAliasDraw(0);
+  TEST_ASSERT_TRUE(first == 0 || first == corpusAlias[0].alias);
+  const uint16_t last = corpusAliasDraw(UINT32_MAX);
+  TEST_ASSERT_TRUE(last == CORPUS_INSULT_COUNT - 1 ||
+                   last == corpusAlias[CORPUS_INSULT_COUNT - 1].alias);
+}
+
+/**
+ * @brief Draw whole epochs and check each one against the budgets.
+ *
+ * Also checks that an insult only follows itself when it is the only one
+ * left with budget.
+ */
+static void checkEpochs(bool (*avoid)(uint16_t index)) {
+  CorpusEpoch epoch = CORPUS_EPOCH_INIT;
+  uint16_t previous = 0xFFFF;
+  for (uint32_t e = 0; e < EPOCH_TEST_EPOCHS; ++e) {
+    memset(counts, 0, sizeof(counts));
+    for (uint32_t d = 0; d < CORPUS_EPOCH_DRAWS; ++d) {
+      const uint16_t index = corpusEpochDraw(epoch, testRandom, avoid);
+      TEST_ASSERT_LESS_THAN(CORPUS_INSULT_COUNT, index);
+      if (index == previous) {
+        const uint32_t left = corpusEpochBudgets[index] - counts[index];
+        TEST_ASSERT_EQUAL_UINT32(CORPUS_EPOCH_DRAWS - d, left);
+      }
+      counts[index]++;
+      previous = index;
+    }
+    for (size_t i = 0; i < CORPUS_INSULT_COUNT; ++i) {
+      TEST_ASSERT_EQUAL_UINT32(corpusEpochBudgets[i], counts[i]);
+    }
+  }
+}
+
+static void test_epochs_match_budgets_exactly() { checkEpochs(nullptr); }
+
+static bool avoidEven(uint16_t index) { return (index & 1) == 0; }
+
+static void test_avoided_insults_keep_their_budget() {
+  checkEpochs(avoidEven);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_alias_table_is_well_formed);
+  RUN_TEST(test_alias_draws_fit_the_weights);
+  RUN_TEST(test_alias_draw_edges);
+  RUN_TEST(test_epochs_match_budgets_exactly);
+  RUN_TEST(test_avoided_insults_keep_their_budget);
+  return UNITY_END();
+}
@@ -0,0 +1,132 @@
+// Inactivity governor escalation (governor.h).
+
+#include "governor.h"
+#include <unity.h>
+
+static constexpr GovernorConfig CONFIG = {30 * 1000, 3 * 60 * 1000};
+
+void setUp() {}
+void tearDown() {}
+
+static void test_starts_active() {
+  GovernorState state;
+  governorInit(state, 1000);
+  TEST_ASSERT_EQUAL(PowerLevel::Active, state.level);
+  TEST_ASSERT_EQUAL(PowerLevel::Active,
+                    governorStep(CONFIG, state, 1000, false));
+}
+
+static void test_escalates_at_thresholds() {
+  GovernorState state;
+  governorInit(state, 0);
+  TEST_ASSERT_EQUAL(PowerLevel::Active,
+                    governorStep(CONFIG, state, 29999, false));
+  TEST_ASSERT_EQUAL(PowerLevel::LightSleep,
+                    governorStep(CONFIG, state, 30000, false));
+  TEST_ASSERT_EQUAL(PowerLevel::LightSleep,
+                    governorStep(CONFIG, state, 179999, false));
+  TEST_ASSERT_EQUAL(PowerLevel::DeepSleep,
+                    governorStep(CONFIG, state, 180000, false));
+}
+
+static void test_long_step_skips_to_deep() {
+  GovernorState state;
+  governorInit(state, 0);
+  TEST_ASSERT_EQUAL(PowerLevel::DeepSleep,
+                    governorStep(CONFIG, state, 10 * 60 * 1000, false));
+}
+
+static void test_busy_counts_as_activity() {
+  GovernorState state;
+  governorInit(state, 0);
+  governorStep(CONFIG, state, 40000, false);
+  TEST_ASSERT_EQUAL(PowerLevel::LightSleep, state.level);
+  TEST_ASSERT_EQUAL(PowerLevel::Active,
+                    governorStep(CONFIG, state, 50000, true));
+  // Idle time restarts from the busy step.
+  TEST_ASSERT_EQUAL(PowerLevel::Active,
+                    governorStep(CONFIG, state, 79999, false));
+  TEST_ASSERT_EQUAL(PowerLevel::LightSleep,
+                    governorStep(CONFIG, state, 80000, false));
+}
+
+static void test_activity_resets() {
+  GovernorState state;
+  governorInit(state, 0);
+  governorStep(CONFIG, state, 200000, false);
+  TEST_ASSERT_EQUAL(PowerLevel::DeepSleep, state.level);
+  governorNoteActivity(state, 200000);
+  TEST_ASSERT_EQUAL(PowerLevel::Active, state.level);
+  TEST_ASSERT_EQUAL(PowerLevel::Active,
+                    governorStep(CONFIG, state, 229999, false));
+}
+
+static void test_disabled_levels() {
+  const GovernorConfig noLight = {0, 60000};
+  GovernorState state;
+  governorInit(state, 0);
+  TEST_ASSERT_EQUAL(PowerLevel::Active,
+                    governorStep(noLight, state, 59999, false));
+  TEST_ASSERT_EQUAL(PowerLevel::DeepSleep,
+                    governorStep(noLight, state, 60000, false));
+
+  const GovernorConfig never = {0, 0};
+  governorInit(state, 0);
+  TEST_ASSERT_EQUAL(PowerLevel::Active,
+                    governorStep(never, state, UINT32_MAX - 1, false));
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX,
+                           governorMsUntilNextLevel(never, state, 0));
+}
+
+static void test_clock_wraparound() {
+  GovernorState state;
+  governorInit(state, UINT32_MAX - 1000);
+  TEST_ASSERT_EQUAL(PowerLevel::Active,
+                    governorStep(CONFIG, state, 1000, false));
+  TEST_ASSERT_EQUAL(PowerLevel::LightSleep,
+                    governorStep(CONFIG, state, 28999, false));
+}
+
+static void test_ms_until_next_level() {
+  GovernorState state;
+  governorInit(state, 0);
+  TEST_ASSERT_EQUAL_UINT32(30000, governorMsUntilNextLevel(CONFIG, state, 0));
+  TEST_ASSERT_EQUAL_UINT32(5000,
+                           governorMsUntilNextLevel(CONFIG, state, 25000));
+
+  governorStep(CONFIG, state, 30000, false);
+  TEST_ASSERT_EQUAL_UINT32(150000,
+                           governorMsUntilNextLevel(CONFIG, state, 30000));
+
+  governorStep(CONFIG, state, 180000, false);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX,
+                           governorMsUntilNextLevel(CONFIG, state, 180000));
+}
+
+static void test_ms_until_due_now() {
+  // A step that hasn't run yet past a threshold reports it as due.
+  GovernorState state;
+  governorInit(state, 0);
+  TEST_ASSERT_EQUAL_UINT32(0, governorMsUntilNextLevel(CONFIG, state, 40000));
+}
+
+static void test_level_names() {
+  TEST_ASSERT_EQUAL_STRING("active", governorLevelName(PowerLevel::Active));
+  TEST_ASSERT_EQUAL_STRING("light", governorLevelName(PowerLevel::LightSleep));
+  TEST_ASSERT_EQUAL_STRING("deep", governorLevelName(PowerLevel::DeepSleep));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_starts_active);
+  RUN_TEST(test_escalates_at_thresholds);
+  RUN_TEST(test_long_step_skips_to_deep);
+  RUN_TEST(test_busy_counts_as_activity);
+  RUN_TEST(test_activity_resets);
+  RUN_TEST(test_disabled_levels);
+  RUN_TEST(test_clock_wraparound);
+  RUN_TEST(test_ms_until_next_level);
+  RUN_TEST(test_ms_until_due_now);
+  RUN_TEST(test_level_names);
+  return UNITY_END();
+}
@@ -0,0 +1,136 @@
+// ULP-RISC-V button wake program (ulp/button_wake/main.c), run on the host
+// one timer tick at a time.
+
+#include "button_core.h"
+#include "ulp_riscv_gpio.h"
+#include "ulp_riscv_utils.h"
+#include <unity.h>
+
+#include <string.h>
+
+static constexpr uint32_t BUTTON_COUNT = 4; // Sleep, Random, Next, Prev
+static constexpr uint32_t TICK_MS = 10;     // ULP_TICK_MS in ulp_wake.cpp
+static const uint32_t PINS[BUTTON_COUNT] = {7, 4, 5, 6};
+
+extern "C" {
+int ulpButtonWakeMain(void);
+
+// Exported by the program (ulp_* on the main core).
+extern volatile uint32_t button_pin[BUTTON_COUNT];
+extern volatile uint32_t tick_ms;
+extern volatile uint32_t gesture_button;
+extern volatile uint32_t gesture_event;
+extern volatile uint32_t gesture_count;
+}
+
+static bool pressed[BUTTON_COUNT];
+static uint32_t wakeups;
+
+extern "C" uint8_t ulp_riscv_gpio_get_level(gpio_num_t gpio_num) {
+  for (uint32_t i = 0; i < BUTTON_COUNT; ++i) {
+    if (PINS[i] == static_cast<uint32_t>(gpio_num)) {
+      return pressed[i] ? 0 : 1; // pulled up, LOW = pressed
+    }
+  }
+  return 1;
+}
+
+extern "C" void ulp_riscv_wakeup_main_processor(void) { wakeups++; }
+
+/**
+ * @brief Run `ticks` timer ticks, stopping after the first wakeup.
+ *
+ * @return Ticks run.
+ */
+static uint32_t runTicks(uint32_t ticks) {
+  const uint32_t before = wakeups;
+  for (uint32_t i = 0; i < ticks; ++i) {
+    ulpButtonWakeMain();
+    if (wakeups != before) {
+      return i + 1;
+    }
+  }
+  return ticks;
+}
+
+void setUp() {
+  memset(pressed, 0, sizeof(pressed));
+  wakeups = 0;
+  for (uint32_t i = 0; i < BUTTON_COUNT; ++i) {
+    button_pin[i] = PINS[i];
+  }
+  tick_ms = TICK_MS;
+  gesture_count = 0;
+  // Tests end with every button released, so whatever state the program
+  // kept is a clean baseline; after a wake this tick takes a fresh one.
+  runTicks(1);
+}
+
+void tearDown() {}
+
+static void test_idle_never_wakes() {
+  runTicks(1000);
+  TEST_ASSERT_EQUAL_UINT32(0, wakeups);
+}
+
+static void test_bounce_never_wakes() {
+  for (uint32_t i = 0; i < 50; ++i) {
+    pressed[2] = (i & 1) != 0; // flips every tick, never stable for 30 ms
+    runTicks(1);
+  }
+  pressed[2] = false;
+  runTicks(100);
+  TEST_ASSERT_EQUAL_UINT32(0, wakeups);
+}
+
+static void test_tap_wakes_with_gesture() {
+  pressed[2] = true; // Next
+  runTicks(10);
+  TEST_ASSERT_EQUAL_UINT32(0, wakeups);
+  pressed[2] = false;
+  runTicks(10);
+  TEST_ASSERT_EQUAL_UINT32(1, wakeups);
+  TEST_ASSERT_EQUAL_UINT32(2, gesture_button);
+  TEST_ASSERT_EQUAL_UINT32(BUTTON_CORE_TAP, gesture_event);
+  TEST_ASSERT_EQUAL_UINT32(1, gesture_count);
+}
+
+static void test_hold_wakes_while_held() {
+  pressed[0] = true; // Sleep
+  const uint32_t ticks = runTicks(200);
+  TEST_ASSERT_EQUAL_UINT32(1, wakeups);
+  TEST_ASSERT_EQUAL_UINT32(0, gesture_button);
+  TEST_ASSERT_EQUAL_UINT32(BUTTON_CORE_HOLD_START, gesture_event);
+  // Debounce plus the hold threshold, give or take a tick.
+  TEST_ASSERT_LESS_OR_EQUAL(
+      (BUTTON_DEBOUNCE_TIME_MS + BUTTON_HOLD_THRESHOLD_MS) / TICK_MS + 2,
+      ticks);
+}
+
+static void test_wake_resets_baseline() {
+  pressed[1] = true; // Random
+  runTicks(10);
+  pressed[1] = false;
+  runTicks(10);
+  TEST_ASSERT_EQUAL_UINT32(1, wakeups);
+  // The next run re-takes the baseline instead of reporting stale state.
+  runTicks(100);
+  TEST_ASSERT_EQUAL_UINT32(1, wakeups);
+  pressed[3] = true; // Prev
+  runTicks(10);
+  pressed[3] = false;
+  runTicks(10);
+  TEST_ASSERT_EQUAL_UINT32(2, wakeups);
+  TEST_ASSERT_EQUAL_UINT32(3, gesture_button);
+  TEST_ASSERT_EQUAL_UINT32(2, gesture_count);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_idle_never_wakes);
+  RUN_TEST(test_bounce_never_wakes);
+  RUN_TEST(test_tap_wakes_with_gesture);
+  RUN_TEST(test_hold_wakes_while_held);
+  RUN_TEST(test_wake_resets_baseline);
+  return UNITY_END();
+}
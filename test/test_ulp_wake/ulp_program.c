@@ -0,0 +1,5 @@
+// Builds the ULP button program for the host against test/ulp_fakes. Its
+// main() is renamed so the Unity runner can call it once per timer tick.
+
+#define main ulpButtonWakeMain
+#include "../../ulp/button_wake/main.c"
@@ -0,0 +1,195 @@
+// Wake-by-action mapping and the wake stub's history decisions (wake.h).
+
+#include "wake.h"
+#include <unity.h>
+
+static constexpr uint8_t RANDOM_PIN = 4;
+static constexpr uint8_t NEXT_PIN = 5;
+static constexpr uint8_t PREV_PIN = 6;
+
+static constexpr uint64_t bit(uint8_t pin) { return 1ULL << pin; }
+
+void setUp() {}
+void tearDown() {}
+
+// ─── EXT1 mask → action ─────────────────────────────────────────
+
+static PendingAction fromMask(uint64_t mask) {
+  return wakeActionFromExt1Mask(mask, RANDOM_PIN, NEXT_PIN, PREV_PIN);
+}
+
+static void test_ext1_single_pins() {
+  TEST_ASSERT_EQUAL(PendingAction::Random, fromMask(bit(RANDOM_PIN)));
+  TEST_ASSERT_EQUAL(PendingAction::Next, fromMask(bit(NEXT_PIN)));
+  TEST_ASSERT_EQUAL(PendingAction::Prev, fromMask(bit(PREV_PIN)));
+}
+
+static void test_ext1_no_action_pin() {
+  TEST_ASSERT_EQUAL(PendingAction::None, fromMask(0));
+  TEST_ASSERT_EQUAL(PendingAction::None, fromMask(bit(0) | bit(7)));
+  TEST_ASSERT_EQUAL(PendingAction::None, fromMask(bit(63)));
+}
+
+static void test_ext1_priority() {
+  const uint64_t all = bit(RANDOM_PIN) | bit(NEXT_PIN) | bit(PREV_PIN);
+  TEST_ASSERT_EQUAL(PendingAction::Random, fromMask(all));
+  TEST_ASSERT_EQUAL(PendingAction::Random,
+                    fromMask(bit(RANDOM_PIN) | bit(PREV_PIN)));
+  TEST_ASSERT_EQUAL(PendingAction::Next,
+                    fromMask(bit(NEXT_PIN) | bit(PREV_PIN)));
+  TEST_ASSERT_EQUAL(PendingAction::Prev, fromMask(bit(PREV_PIN) | bit(0)));
+}
+
+static void test_ext1_high_pins() {
+  // GPIOs above 31 need the 64-bit mask.
+  TEST_ASSERT_EQUAL(PendingAction::Next,
+                    wakeActionFromExt1Mask(bit(40), 39, 40, 41));
+  TEST_ASSERT_EQUAL(PendingAction::None,
+                    wakeActionFromExt1Mask(bit(8), 39, 40, 41));
+}
+
+static void test_ext1_pin_mask() {
+  TEST_ASSERT_EQUAL_HEX64(bit(RANDOM_PIN) | bit(NEXT_PIN) | bit(PREV_PIN),
+                          wakeExt1PinMask(RANDOM_PIN, NEXT_PIN, PREV_PIN));
+}
+
+// ─── Gesture → action ───────────────────────────────────────────
+
+static void test_gesture_tap() {
+  TEST_ASSERT_EQUAL(PendingAction::Random,
+                    wakeActionFromGesture(ButtonId::Random, ButtonEvent::Tap));
+  TEST_ASSERT_EQUAL(PendingAction::Next,
+                    wakeActionFromGesture(ButtonId::Next, ButtonEvent::Tap));
+  TEST_ASSERT_EQUAL(PendingAction::Prev,
+                    wakeActionFromGesture(ButtonId::Prev, ButtonEvent::Tap));
+  TEST_ASSERT_EQUAL(PendingAction::None,
+                    wakeActionFromGesture(ButtonId::Sleep, ButtonEvent::Tap));
+}
+
+static void test_gesture_not_tap() {
+  const ButtonEvent events[] = {ButtonEvent::None, ButtonEvent::HoldStart,
+                                ButtonEvent::HoldEnd};
+  for (ButtonEvent event : events) {
+    TEST_ASSERT_EQUAL(PendingAction::None,
+                      wakeActionFromGesture(ButtonId::Random, event));
+    TEST_ASSERT_EQUAL(PendingAction::None,
+                      wakeActionFromGesture(ButtonId::Next, event));
+  }
+}
+
+// ─── Wake stub decisions ────────────────────────────────────────
+
+static WakeStubState armedState(uint16_t historySize, uint16_t position) {
+  WakeStubState state = {};
+  state.randomMask = 1u << RANDOM_PIN;
+  state.nextMask = 1u << NEXT_PIN;
+  state.prevMask = 1u << PREV_PIN;
+  state.historySize = historySize;
+  state.position = position;
+  state.armed = 1;
+  return state;
+}
+
+static void test_stub_unarmed_boots() {
+  WakeStubState state = armedState(4, 1);
+  state.armed = 0;
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot,
+                    wakeStubDecide(1u << NEXT_PIN, state));
+  TEST_ASSERT_EQUAL_UINT16(1, state.position);
+}
+
+static void test_stub_non_ext1_boots() {
+  WakeStubState state = armedState(4, 1);
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot, wakeStubDecide(0, state));
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot, wakeStubDecide(1u << 0, state));
+  TEST_ASSERT_EQUAL_UINT16(1, state.position);
+  TEST_ASSERT_EQUAL_UINT16(0, state.moves);
+}
+
+static void test_stub_random_boots() {
+  WakeStubState state = armedState(4, 1);
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot,
+                    wakeStubDecide(1u << RANDOM_PIN, state));
+  // Random wins over Next, as in wakeActionFromExt1Mask().
+  TEST_ASSERT_EQUAL(
+      WakeStubDecision::Boot,
+      wakeStubDecide((1u << RANDOM_PIN) | (1u << NEXT_PIN), state));
+  TEST_ASSERT_EQUAL_UINT16(1, state.position);
+}
+
+static void test_stub_next_inside_history() {
+  WakeStubState state = armedState(4, 1);
+  TEST_ASSERT_EQUAL(WakeStubDecision::Sleep,
+                    wakeStubDecide(1u << NEXT_PIN, state));
+  TEST_ASSERT_EQUAL_UINT16(2, state.position);
+  TEST_ASSERT_EQUAL(WakeStubDecision::Sleep,
+                    wakeStubDecide(1u << NEXT_PIN, state));
+  TEST_ASSERT_EQUAL_UINT16(3, state.position);
+  TEST_ASSERT_EQUAL_UINT16(2, state.moves);
+}
+
+static void test_stub_next_at_newest_boots() {
+  WakeStubState state = armedState(4, 3);
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot,
+                    wakeStubDecide(1u << NEXT_PIN, state));
+  TEST_ASSERT_EQUAL_UINT16(3, state.position);
+  TEST_ASSERT_EQUAL_UINT16(0, state.moves);
+}
+
+static void test_stub_prev_inside_history() {
+  WakeStubState state = armedState(4, 1);
+  TEST_ASSERT_EQUAL(WakeStubDecision::Sleep,
+                    wakeStubDecide(1u << PREV_PIN, state));
+  TEST_ASSERT_EQUAL_UINT16(0, state.position);
+  TEST_ASSERT_EQUAL_UINT16(1, state.moves);
+}
+
+static void test_stub_prev_at_oldest_boots() {
+  WakeStubState state = armedState(4, 0);
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot,
+                    wakeStubDecide(1u << PREV_PIN, state));
+  TEST_ASSERT_EQUAL_UINT16(0, state.position);
+}
+
+static void test_stub_empty_and_single_history() {
+  WakeStubState empty = armedState(0, 0);
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot,
+                    wakeStubDecide(1u << NEXT_PIN, empty));
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot,
+                    wakeStubDecide(1u << PREV_PIN, empty));
+
+  WakeStubState single = armedState(1, 0);
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot,
+                    wakeStubDecide(1u << NEXT_PIN, single));
+  TEST_ASSERT_EQUAL(WakeStubDecision::Boot,
+                    wakeStubDecide(1u << PREV_PIN, single));
+}
+
+static void test_stub_next_wins_over_prev() {
+  WakeStubState state = armedState(4, 1);
+  TEST_ASSERT_EQUAL(
+      WakeStubDecision::Sleep,
+      wakeStubDecide((1u << NEXT_PIN) | (1u << PREV_PIN), state));
+  TEST_ASSERT_EQUAL_UINT16(2, state.position);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_ext1_single_pins);
+  RUN_TEST(test_ext1_no_action_pin);
+  RUN_TEST(test_ext1_priority);
+  RUN_TEST(test_ext1_high_pins);
+  RUN_TEST(test_ext1_pin_mask);
+  RUN_TEST(test_gesture_tap);
+  RUN_TEST(test_gesture_not_tap);
+  RUN_TEST(test_stub_unarmed_boots);
+  RUN_TEST(test_stub_non_ext1_boots);
+  RUN_TEST(test_stub_random_boots);
+  RUN_TEST(test_stub_next_inside_history);
+  RUN_TEST(test_stub_next_at_newest_boots);
+  RUN_TEST(test_stub_prev_inside_history);
+  RUN_TEST(test_stub_prev_at_oldest_boots);
+  RUN_TEST(test_stub_empty_and_single_history);
+  RUN_TEST(test_stub_next_wins_over_prev);
+  return UNITY_END();
+}
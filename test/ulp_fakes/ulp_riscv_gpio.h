@@ -0,0 +1,22 @@
+#ifndef ULP_RISCV_GPIO_H
+#define ULP_RISCV_GPIO_H
+
+// Host stand-in for the ESP-IDF ULP-RISC-V GPIO header, so the ULP program
+// (ulp/button_wake/main.c) builds and runs in test/test_ulp_wake. The test
+// supplies the pin levels.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int gpio_num_t;
+
+uint8_t ulp_riscv_gpio_get_level(gpio_num_t gpio_num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ULP_RISCV_GPIO_H
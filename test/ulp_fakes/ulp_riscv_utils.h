@@ -0,0 +1,17 @@
+#ifndef ULP_RISCV_UTILS_H
+#define ULP_RISCV_UTILS_H
+
+// Host stand-in for the ESP-IDF ULP-RISC-V utils header (see
+// ulp_riscv_gpio.h). The test counts the wakeups.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void ulp_riscv_wakeup_main_processor(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ULP_RISCV_UTILS_H
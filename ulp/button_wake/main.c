@@ -0,0 +1,62 @@
+// ULP-RISC-V wake program: debounce the buttons while the main cores sleep.
+//
+// The ULP timer runs this every tick_ms. Each run samples every button pin
+// and feeds the shared state machine (lib/buttoncore/button_core.c), so
+// bounces and brushes never wake the main cores; only a confirmed Tap or
+// HoldStart does. The gesture is left in RTC memory for ulpWakeTakeGesture().
+//
+// Variables below are exported to the main core with a `ulp_` prefix (see
+// the generated ulp_main.h). Statics live in RTC slow memory and keep their
+// values between runs.
+
+#include "button_core.h"
+#include "ulp_riscv_gpio.h"
+#include "ulp_riscv_utils.h"
+
+#include <stdint.h>
+
+#define BUTTON_COUNT 4 // ButtonId order: Sleep, Random, Next, Prev
+
+// Written by the main core before the ULP starts.
+volatile uint32_t button_pin[BUTTON_COUNT];
+volatile uint32_t tick_ms;
+
+// Written here right before waking the main core.
+volatile uint32_t gesture_button;
+volatile uint32_t gesture_event;
+volatile uint32_t gesture_count;
+
+static ButtonCore cores[BUTTON_COUNT];
+static uint32_t now_ms;
+static uint8_t started;
+
+static bool sample_pressed(uint32_t i) {
+  // Pulled up, wired to GND: LOW = pressed.
+  return ulp_riscv_gpio_get_level((gpio_num_t)button_pin[i]) == 0;
+}
+
+int main(void) {
+  if (!started) {
+    now_ms = 0;
+    for (uint32_t i = 0; i < BUTTON_COUNT; ++i) {
+      buttonCoreInit(&cores[i], sample_pressed(i), now_ms);
+    }
+    started = 1;
+    return 0;
+  }
+
+  now_ms += tick_ms;
+  for (uint32_t i = 0; i < BUTTON_COUNT; ++i) {
+    const ButtonCoreEvent event =
+        buttonCoreUpdate(&cores[i], sample_pressed(i), now_ms);
+    if (event == BUTTON_CORE_TAP || event == BUTTON_CORE_HOLD_START) {
+      gesture_button = i;
+      gesture_event = (uint32_t)event;
+      gesture_count++;
+      started = 0; // fresh baseline for the next sleep
+      ulp_riscv_wakeup_main_processor();
+      break;
+    }
+  }
+  return 0; // halt until the next timer tick
+}